@@ -50,6 +50,9 @@ public:
         return sim::now() > m_tLastTreatment && sim::now() <= m_tLastTreatment + healthSystemMemory;
     }
     
+    // Sub-classes add no per-human data
+    virtual size_t memoryUsage() const{ return sizeof(*this); }
+    
 protected:
     enum CaseType { FirstLine, SecondLine, NumCaseTypes };
     static mon::Measure measures[NumCaseTypes];
@@ -426,6 +426,10 @@ const CMDecisionTree& save_decision( CMDecisionTree* decision ){
     return *decision_library.back();
 }
 
+void CMDecisionTree::clearLibrary(){
+    decision_library.clear();
+}
+
 const CMDecisionTree& CMDecisionTree::create( const scnXml::DecisionTree& node, bool isUC ){
     if( node.getMultiple().present() ) return CMDTMultiple::create( node.getMultiple().get(), isUC );
     // branching nodes
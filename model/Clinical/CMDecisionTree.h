@@ -76,6 +76,10 @@ public:
      *  tree, pgState does not need to be set when executing the tree. */
     static const CMDecisionTree& create( const ::scnXml::DecisionTree& node, bool isUC );
     
+    /** Free all trees created by create() (those of a previous simulation).
+     * References to them must no longer be used. */
+    static void clearLibrary();
+    
     /** Test for equivalence in two decision trees. Nodes are equivalent if
      * they have the same type, same deployments and treatments, and their
      * sub-nodes are equivalent. */
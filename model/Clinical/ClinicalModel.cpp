@@ -49,6 +49,7 @@ util::AgeGroupInterpolator ClinicalModel::pSequelaeInpatient;
 
 void ClinicalModel::init( const Parameters& parameters, const scnXml::Scenario& scenario ) {
     const scnXml::Clinical& clinical = scenario.getModel().getClinical();
+    CMDecisionTree::clearLibrary();     // trees of any previous simulation
     try{
         indirectMortBugfix = util::ModelOptions::option (util::INDIRECT_MORTALITY_FIX);
         //NOTE: if changing XSD, this should not have a default unit:
@@ -59,8 +60,9 @@ void ClinicalModel::init( const Parameters& parameters, const scnXml::Scenario&
         throw util::xml_scenario_error( string("model/clinical/healthSystemMemory: ").append(e.message()) );
     }
     
-    if (util::ModelOptions::option (util::CLINICAL_EVENT_SCHEDULER)){
-        opt_event_scheduler = true;
+    opt_event_scheduler = util::ModelOptions::option (util::CLINICAL_EVENT_SCHEDULER);
+    opt_imm_outcomes = false;
+    if (opt_event_scheduler){
         ClinicalEventScheduler::init( parameters, clinical );
     }else{
         if( scenario.getHealthSystem().getImmediateOutcomes().present() ){
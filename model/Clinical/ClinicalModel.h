@@ -23,6 +23,7 @@
 
 #include "Host/Human.h"
 #include "Episode.h"
+#include "util/ObjectPool.h"
 #include <memory>
 
 namespace scnXml{
@@ -43,7 +44,7 @@ namespace OM { namespace Clinical {
  * 
  * Reporting includes patient outcome and potentially drug usage and use of
  * RDTs (Rapid Diagnostic Tests) for costing purposes. */\
-class ClinicalModel
+class ClinicalModel : public util::PooledObject
 {
 public:
     /// @brief Static functions
@@ -91,6 +92,9 @@ public:
      * (within health-system-memory and not new cases). */
     virtual bool isExistingCase() =0;
     
+    /// Approximate memory used by this object, in bytes
+    virtual size_t memoryUsage() const =0;
+    
     inline static SimTime hsMemory() {
         return healthSystemMemory;
     }
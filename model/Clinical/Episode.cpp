@@ -21,6 +21,9 @@
 #include "Clinical/Episode.h"
 #include "Clinical/ClinicalModel.h"
 #include "Host/Human.h"
+#include "mon/reporting.h"
+
+#include <algorithm>
 
 namespace OM {
 namespace Clinical {
@@ -51,56 +54,146 @@ void Episode::update (const Host::Human& human, Episode::State newState)
     }
 }
 
-void Episode::report () {
-    if (time < SimTime::zero())        // Nothing to report
-        return;
-    
-    // Reports malarial/non-malarial UC fever dependent on cause, not diagnosis.
+namespace {
+// Flags of Episode::State which affect reporting
+const uint32_t REPORTED_FLAGS[] = {
+    Episode::SICK, Episode::MALARIA, Episode::COMPLICATED,
+    Episode::EVENT_IN_HOSPITAL, Episode::DIRECT_DEATH, Episode::SEQUELAE,
+    Episode::RECOVERY, Episode::EVENT_FIRST_DAY
+};
+const size_t N_REPORTED_FLAGS = sizeof(REPORTED_FLAGS) / sizeof(REPORTED_FLAGS[0]);
+const size_t N_OUTCOMES = 1 << N_REPORTED_FLAGS;
+
+// Reporting flags of state packed into bits of an outcome code
+inline uint8_t outcomeCode( uint32_t state ){
+    uint8_t code = 0;
+    for( size_t i = 0; i < N_REPORTED_FLAGS; ++i ){
+        if( state & REPORTED_FLAGS[i] ) code |= 1 << i;
+    }
+    return code;
+}
+
+// Measures reported (each with value 1) for an episode with some state.
+// 
+// Reports malarial/non-malarial UC fever dependent on cause, not diagnosis.
+void outcomeMeasures( uint32_t state, vector<mon::Measure>& measures ){
     if (state & Episode::MALARIA) {
         // Malarial fevers: report bout
         if (state & Episode::COMPLICATED) {
-            mon::reportMSACI( mon::MHE_SEVERE_EPISODES, surveyPeriod, ageGroup, cohortSet, 1 );
+            measures.push_back( mon::MHE_SEVERE_EPISODES );
         } else { // UC or UC2
-            mon::reportMSACI( mon::MHE_UNCOMPLICATED_EPISODES, surveyPeriod, ageGroup, cohortSet, 1 );
+            measures.push_back( mon::MHE_UNCOMPLICATED_EPISODES );
         }
 
         // Report outcomes of malarial fevers
         if (state & Episode::EVENT_IN_HOSPITAL) {
             if (state & Episode::DIRECT_DEATH) {
-                mon::reportMSACI( mon::MHO_DIRECT_DEATHS, surveyPeriod, ageGroup, cohortSet, 1 );
-                mon::reportMSACI( mon::MHO_HOSPITAL_DEATHS, surveyPeriod, ageGroup, cohortSet, 1 );
+                measures.push_back( mon::MHO_DIRECT_DEATHS );
+                measures.push_back( mon::MHO_HOSPITAL_DEATHS );
                 if (state & Episode::EVENT_FIRST_DAY){
-                    mon::reportMSACI( mon::MHO_FIRST_DAY_DEATHS, surveyPeriod, ageGroup, cohortSet, 1 );
-                    mon::reportMSACI( mon::MHO_HOSPITAL_FIRST_DAY_DEATHS, surveyPeriod, ageGroup, cohortSet, 1 );
+                    measures.push_back( mon::MHO_FIRST_DAY_DEATHS );
+                    measures.push_back( mon::MHO_HOSPITAL_FIRST_DAY_DEATHS );
                 }
             }
             else if (state & Episode::SEQUELAE) {
-                mon::reportMSACI( mon::MHO_SEQUELAE, surveyPeriod, ageGroup, cohortSet, 1 );
-                mon::reportMSACI( mon::MHO_HOSPITAL_SEQUELAE, surveyPeriod, ageGroup, cohortSet, 1 );
+                measures.push_back( mon::MHO_SEQUELAE );
+                measures.push_back( mon::MHO_HOSPITAL_SEQUELAE );
             }
             else if (state & Episode::RECOVERY){
-                mon::reportMSACI( mon::MHO_HOSPITAL_RECOVERIES, surveyPeriod, ageGroup, cohortSet, 1 );
+                measures.push_back( mon::MHO_HOSPITAL_RECOVERIES );
             }
         } else {
             if (state & Episode::DIRECT_DEATH) {
-                mon::reportMSACI( mon::MHO_DIRECT_DEATHS, surveyPeriod, ageGroup, cohortSet, 1 );
+                measures.push_back( mon::MHO_DIRECT_DEATHS );
                 if (state & Episode::EVENT_FIRST_DAY){
-                    mon::reportMSACI( mon::MHO_FIRST_DAY_DEATHS, surveyPeriod, ageGroup, cohortSet, 1 );
+                    measures.push_back( mon::MHO_FIRST_DAY_DEATHS );
                 }
             }
             else if (state & Episode::SEQUELAE){
-                mon::reportMSACI( mon::MHO_SEQUELAE, surveyPeriod, ageGroup, cohortSet, 1 );
+                measures.push_back( mon::MHO_SEQUELAE );
             }
             // Don't care about out-of-hospital recoveries
         }
     } else if (state & Episode::SICK) {
         // Report non-malarial fever and outcomes
-        mon::reportMSACI( mon::MHE_NON_MALARIA_FEVERS, surveyPeriod, ageGroup, cohortSet, 1 );
+        measures.push_back( mon::MHE_NON_MALARIA_FEVERS );
 
         if (state & Episode::DIRECT_DEATH) {
-            mon::reportMSACI( mon::MHO_NMF_DEATHS, surveyPeriod, ageGroup, cohortSet, 1 );
+            measures.push_back( mon::MHO_NMF_DEATHS );
+        }
+    }
+}
+
+// Measures to report by outcome code
+struct OutcomeTable {
+    vector<mon::Measure> measures[N_OUTCOMES];
+    
+    OutcomeTable(){
+        for( size_t code = 0; code < N_OUTCOMES; ++code ){
+            uint32_t state = 0;
+            for( size_t i = 0; i < N_REPORTED_FLAGS; ++i ){
+                if( code & (1 << i) ) state |= REPORTED_FLAGS[i];
+            }
+            outcomeMeasures( state, measures[code] );
+        }
+    }
+};
+const OutcomeTable outcomeTable;
+
+// A reported episode, waiting to be added to monitoring stores
+struct EpisodeRecord {
+    size_t survey;
+    mon::AgeGroup ageGroup;
+    uint32_t cohortSet;
+    uint8_t outcome;    // see outcomeCode()
+    
+    inline bool operator< (const EpisodeRecord& that) const{
+        if( survey != that.survey ) return survey < that.survey;
+        if( ageGroup.i() != that.ageGroup.i() ) return ageGroup.i() < that.ageGroup.i();
+        if( cohortSet != that.cohortSet ) return cohortSet < that.cohortSet;
+        return outcome < that.outcome;
+    }
+    inline bool sameAs (const EpisodeRecord& that) const{
+        return survey == that.survey && ageGroup.i() == that.ageGroup.i() &&
+            cohortSet == that.cohortSet && outcome == that.outcome;
+    }
+};
+vector<EpisodeRecord> buffered;
+}
+
+void Episode::report () {
+    if (time < SimTime::zero())        // Nothing to report
+        return;
+    if (surveyPeriod == mon::NOT_USED)  // reports would be ignored
+        return;
+    
+    uint8_t outcome = outcomeCode( state );
+    if( outcomeTable.measures[outcome].empty() ) return;
+    if( mon::reportingToShard() ){
+        // the buffer is shared; shards already accumulate privately
+        for( mon::Measure measure : outcomeTable.measures[outcome] ){
+            mon::reportMSACI( measure, surveyPeriod, ageGroup, cohortSet, 1 );
+        }
+        return;
+    }
+    buffered.push_back( EpisodeRecord{ surveyPeriod, ageGroup, cohortSet, outcome } );
+}
+
+void Episode::flushBuffered() {
+    // Count identical records, then report each group once
+    sort( buffered.begin(), buffered.end() );
+    for( size_t i = 0; i < buffered.size(); ){
+        const EpisodeRecord& record = buffered[i];
+        size_t end = i + 1;
+        while( end < buffered.size() && buffered[end].sameAs( record ) ) ++end;
+        const int count = end - i;
+        for( mon::Measure measure : outcomeTable.measures[record.outcome] ){
+            mon::reportMSACI( measure, record.survey, record.ageGroup,
+                    record.cohortSet, count );
         }
+        i = end;
     }
+    buffered.clear();
 }
 
 void Episode::operator& (istream& stream) {
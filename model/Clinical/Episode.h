@@ -27,6 +27,8 @@
 #include "mon/info.h"
 #include <ostream>
 
+class UnittestUtil;
+
 namespace OM {
 namespace Host {
     class Human;
@@ -98,6 +100,12 @@ public:
     void operator& (istream& stream);
     void operator& (ostream& stream);	///< ditto
     
+    /** Add buffered episode reports to monitoring stores.
+     * 
+     * Reports are buffered until the monitoring system needs its data, and
+     * this must be called first (when concluding a survey, writing output
+     * or checkpointing). */
+    static void flushBuffered();
     
 private:
     /** Report a clinical episode.
@@ -105,7 +113,9 @@ private:
      * From _state, an episode is reported based on severity (SICK,
      * MALARIA or COMPLICATED), and any outcomes are reported: RECOVERY (in
      * hospital, i.e. with EVENT_IN_HOSPITAL, only), SEQUELAE and DIRECT_DEATH
-     * (both in and out of hospital). */
+     * (both in and out of hospital).
+     * 
+     * The report is buffered; see flushBuffered(). */
     void report();
     
     /// Time of event, potentially never
@@ -119,6 +129,8 @@ private:
     /// Descriptor of state, containing reporting info. Not all information will
     /// be reported (e.g. indirect deaths are reported independantly).
     Episode::State state;
+    
+    friend class ::UnittestUtil;
 };
 
 } }
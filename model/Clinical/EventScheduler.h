@@ -49,6 +49,8 @@ public:
     ClinicalEventScheduler (double tSF);
     
     virtual bool isExistingCase();
+    
+    virtual size_t memoryUsage() const{ return sizeof(*this); }
 
 protected:
     virtual void doClinicalUpdate (Human& human, double ageYears);
@@ -58,9 +58,9 @@ void Human::init( const Parameters& parameters, const scnXml::Scenario& scenario
 // -----  Non-static functions: creation/destruction, checkpointing  -----
 
 // Create new human
-Human::Human(SimTime dateOfBirth) :
+Human::Human(SimTime dateOfBirth, const util::RngSeed& seed) :
     infIncidence(InfectionIncidenceModel::createModel()),
-    m_rng(util::master_RNG),
+    m_rng(seed),
     m_DOB(dateOfBirth),
     m_remove(false),
     m_cohortSet(0),
@@ -90,7 +90,7 @@ Human::Human(SimTime dateOfBirth, int dummy) :
 
 // -----  Non-static functions: per-time-step update  -----
 
-vector<double> EIR_per_genotype;        // cache (not thread safe)
+WithinHost::GenotypeWeights EIR_per_genotype;        // cache (not thread safe)
 
 void Human::update(Transmission::TransmissionModel& transmission) {
     // For integer age checks we use age0 to e.g. get 73 steps comparing less than 1 year old
@@ -152,7 +152,9 @@ void Human::summarize() {
     }
     
     mon::reportStatMHI( mon::MHR_HOSTS, *this, 1 );
-    mon::reportStatMHF( mon::MHF_AGE, *this, age(sim::now()).inYears() );
+    if( mon::isUsedM( mon::MHF_AGE ) ){
+        mon::reportStatMHF( mon::MHF_AGE, *this, age(sim::now()).inYears() );
+    }
     bool patent = withinHostModel->summarize (*this);
     infIncidence->summarize (*this);
     
@@ -168,7 +170,7 @@ void Human::reportDeployment( ComponentId id, SimTime duration ){
     m_cohortSet = mon::updateCohortSet( m_cohortSet, id, true );
 }
 void Human::removeFirstEvent( interventions::SubPopRemove::RemoveAtCode code ){
-    const vector<ComponentId>& removeAtList = interventions::removeAtIds[code];
+    const vector<ComponentId>& removeAtList = interventions::InterventionManager::removeAtIds( code );
     for( auto it = removeAtList.begin(), end = removeAtList.end(); it != end; ++it ){
         auto expIt = m_subPopExp.find( *it );
         if( expIt != m_subPopExp.end() ){
@@ -193,4 +195,16 @@ void Human::flushReports (){
     clinicalModel->flushReports();
 }
 
+void Human::memoryUsage( util::MemoryUsage& usage ) const{
+    // map nodes: value plus (approximately) three links and a colour
+    usage.human += sizeof(*this) - sizeof(perHostTransmission) +
+        _vaccine.memoryUsage() +
+        m_subPopExp.size() * (sizeof(SubPopT::value_type) + 4 * sizeof(void*));
+    usage.transmission += sizeof(perHostTransmission) + perHostTransmission.memoryUsage();
+    withinHostModel->memoryUsage( usage );
+    usage.infIncidence += sizeof(InfectionIncidenceModel);
+    usage.clinical += clinicalModel->memoryUsage();
+    usage.nHumans += 1;
+}
+
 } }
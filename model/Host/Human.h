@@ -26,7 +26,8 @@
 #include "mon/AgeGroup.h"
 #include "interventions/HumanComponents.h"
 #include "util/checkpoint_containers.h"
-#include <map>
+#include "util/MemoryUsage.h"
+#include "util/ObjectPool.h"
 
 class UnittestUtil;
 namespace scnXml {
@@ -56,8 +57,11 @@ public:
   //@{
   /** Initialise all variables of a human datatype.
    * 
-   * @param dateOfBirth date of birth (usually start of next time step) */
-  Human(SimTime dateOfBirth);
+   * Does not use any shared RNG, so humans may be constructed concurrently.
+   * 
+   * @param dateOfBirth date of birth (usually start of next time step)
+   * @param seed Seed for the human's RNG, drawn from the master RNG */
+  Human(SimTime dateOfBirth, const util::RngSeed& seed);
   
   /// Allow move construction
   Human(Human&&) = default;
@@ -150,6 +154,9 @@ public:
   /// Flush any information pending reporting. Should only be called at destruction.
   void flushReports ();
   
+  /// Add approximate memory used by this human and its sub-models to usage.
+  void memoryUsage( util::MemoryUsage& usage ) const;
+  
   ///@brief Access to sub-models
   //@{
   /// The WithinHostModel models parasite density and immunity
@@ -220,7 +227,7 @@ private:
   
   //TODO(optimisation): it might be better to instead store for each
   // ComponentId of interest the set of humans who are members
-  typedef std::map<interventions::ComponentId,SimTime> SubPopT;
+  typedef util::PooledMap<interventions::ComponentId,SimTime> SubPopT;
   /** This lists sub-populations of which the human is a member together with
    * expiry time.
    * 
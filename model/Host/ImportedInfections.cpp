@@ -22,6 +22,7 @@
 #include "Host/Human.h"
 #include "util/random.h"
 #include "util/timeConversions.h"
+#include "util/ModelOptions.h"
 #include "Population.h"
 
 namespace OM { namespace Host {
@@ -66,7 +67,7 @@ void ImportedInfections::init( const scnXml::ImportedInfections& iiElt ){
     }
 }
 
-void ImportedInfections::import( Population& population ){
+void ImportedInfections::import( Population& population, LocalRng& rng ){
     if( rate.size() == 0 ) return;      // no imported infections
     SimTime now = sim::intervTime();
     assert( now >= SimTime::zero() );
@@ -84,7 +85,13 @@ void ImportedInfections::import( Population& population ){
     }
     
     double rateNow = rate[lastIndex].value;
-    if( rateNow > 0.0 ){
+    if( rateNow > 0.0 && util::ModelOptions::option( util::POPULATION_SKIP_SAMPLING ) ){
+        Population::HumanPop& humans = population.getHumans();
+        util::BernoulliSkip trials( rng, rateNow );
+        for( size_t i = trials.skip(); i < humans.size(); i += 1 + trials.skip() ){
+            humans[i].addInfection();
+        }
+    }else if( rateNow > 0.0 ){
         for(Human& human : population){
             if(human.rng().bernoulli( rateNow )){
                 human.addInfection();
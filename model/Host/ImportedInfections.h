@@ -24,11 +24,13 @@
 #include "Global.h"
 #include "schema/interventions.h"
 #include "util/errors.h"
+#include "util/random.h"
 
 namespace OM {
     class Population;
 
 namespace Host {
+    using util::LocalRng;
 
     class ImportedInfections {
     public:
@@ -49,8 +51,13 @@ namespace Host {
          *  population or not. A maximum of one infection can be imported per
          *  person.
          * 
-         * @param pop The Population class encapsulating all humans */
-        void import( Population& pop );
+         *  With the POPULATION_SKIP_SAMPLING option, humans are instead
+         *  selected with geometric skips (util::BernoulliSkip) using rng,
+         *  so that only humans importing an infection use a random number.
+         * 
+         * @param pop The Population class encapsulating all humans
+         * @param rng Population-level RNG; only used with POPULATION_SKIP_SAMPLING */
+        void import( Population& pop, LocalRng& rng );
         
         /// Checkpointing
         template<class S>
@@ -92,6 +92,8 @@ void InfectionIncidenceModel::init ( const Parameters& parameters ) {
     
     opt_no_pre_erythrocytic = util::ModelOptions::option (util::NO_PRE_ERYTHROCYTIC);
     opt_neg_bin_mass_action = util::ModelOptions::option (util::NEGATIVE_BINOMIAL_MASS_ACTION);
+    opt_lognormal_mass_action = false;
+    opt_any_het = false;
     if (opt_neg_bin_mass_action) {
         inf_rate_shape_param = (baseline_avail_shape_param+1.0) / (r_square_Gamma*baseline_avail_shape_param - 1.0);
         inf_rate_shape_param=std::max(inf_rate_shape_param, 0.0);
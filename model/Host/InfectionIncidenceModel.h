@@ -24,6 +24,7 @@
 #include "Global.h"
 #include "Transmission/PerHost.h"
 #include "util/random.h"
+#include "util/ObjectPool.h"
 
 namespace OM {
     class Parameters;
@@ -43,7 +44,7 @@ using util::LocalRng;
  * 
  * There are also two susceptibility models which should be compatible with all
  * of these (see susceptibility()). */
-class InfectionIncidenceModel
+class InfectionIncidenceModel : public util::PooledObject
 {
 public:
   ///@brief Static initialisation & constructors
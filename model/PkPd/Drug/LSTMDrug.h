@@ -24,6 +24,7 @@
 #include "Global.h"
 #include "util/checkpoint_containers.h"
 #include "util/random.h"
+#include "util/ObjectPool.h"
 
 namespace OM {
 namespace WithinHost {
@@ -36,7 +37,7 @@ using util::LocalRng;
 /** A class holding pkpd drug use info.
  *
  * Each human has an instance for each type of drug present in their blood. */
-class LSTMDrug {
+class LSTMDrug : public util::PooledObject {
 public:
     /// Create a new instance.
     /// Volume of distribution must be specified here (from sample or mean).
@@ -82,6 +83,15 @@ public:
      * @param body_mass Weight of patient in kg */
     virtual void updateConcentration (double body_mass) =0;
     
+    /** True when no doses are pending and all concentrations are zero (as
+     * set by updateConcentration() once below the drug type's negligible
+     * concentration). Such an instance has no further effect (drug factor 1,
+     * concentration 0) unless medicated again. */
+    virtual bool isNegligible() const =0;
+    
+    /// Approximate memory used by this object and its doses, in bytes
+    virtual size_t memoryUsage() const =0;
+    
     /// Checkpointing
     template<class S>
     void operator& (S& stream) {
@@ -21,6 +21,7 @@
 #include "PkPd/Drug/LSTMDrugConversion.h"
 #include "WithinHost/Infection/CommonInfection.h"
 #include "util/errors.h"
+#include "util/GslWorkspaces.h"
 #include "util/StreamValidator.h"
 #include "util/vectors.h"
 
@@ -129,9 +130,6 @@ double func_convFactor( double t, void* pp ){
 }
 
 const size_t GSL_INTG_CONV_MAX_ITER = 1000;     // 10 seems enough, but no harm in using a higher value
-gsl_integration_workspace *gsl_intgr_conv_wksp = gsl_integration_workspace_alloc (GSL_INTG_CONV_MAX_ITER);
-//NOTE: we "should" free, but mem-leaks at end of program aren't really important
-// gsl_integration_workspace_free (gsl_intgr_conv_wksp);
 double LSTMDrugConversion::calculateFactor(const Params_convFactor& p, double duration) const{
     gsl_function F;
     F.function = &func_convFactor;
@@ -147,7 +145,9 @@ double LSTMDrugConversion::calculateFactor(const Params_convFactor& p, double du
     
 //     intg_steps = 0;
     int r = gsl_integration_qag (&F, 0.0, duration, abs_eps, rel_eps,
-                                 GSL_INTG_CONV_MAX_ITER, qag_rule, gsl_intgr_conv_wksp, &intfC, &err_eps);
+                                 GSL_INTG_CONV_MAX_ITER, qag_rule,
+                                 util::GslWorkspaces::integration(GSL_INTG_CONV_MAX_ITER),
+                                 &intfC, &err_eps);
     if( r != 0 ){
         throw TRACED_EXCEPTION( "calculateFactor: error from gsl_integration_qag",util::Error::GSL );
     }
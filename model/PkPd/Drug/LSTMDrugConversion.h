@@ -52,6 +52,12 @@ public:
     
     virtual double calculateDrugFactor(LocalRng& rng, WithinHost::CommonInfection *inf, double body_mass) const;
     virtual void updateConcentration (double body_mass);
+    virtual bool isNegligible() const{
+        return qtyG == 0.0 && qtyP == 0.0 && qtyM == 0.0 && doses.size() == 0;
+    }
+    virtual size_t memoryUsage() const{
+        return sizeof(*this) + doses.capacity() * sizeof(DoseVec::value_type);
+    }
     double getMetaboliteConcentration() const;
     double getParentConcentration() const;
     
@@ -21,6 +21,7 @@
 #include "PkPd/Drug/LSTMDrugThreeComp.h"
 #include "WithinHost/Infection/CommonInfection.h"
 #include "util/errors.h"
+#include "util/GslWorkspaces.h"
 #include "util/StreamValidator.h"
 
 #include <gsl/gsl_integration.h>
@@ -123,9 +124,6 @@ double func_fC( double t, void* pp ){
     return fC;
 }
 const size_t GSL_INTG_MAX_ITER = 1000;     // 10 seems enough, but no harm in using a higher value
-gsl_integration_workspace *gsl_intgr_wksp = gsl_integration_workspace_alloc (GSL_INTG_MAX_ITER);
-//NOTE: we "should" free, but mem-leaks at end of program aren't really important
-// gsl_integration_workspace_free (gsl_intgr_wksp);
 double LSTMDrugThreeComp::calculateFactor(const Params_fC& p, double duration) const{
     gsl_function F;
     F.function = &func_fC;
@@ -139,7 +137,8 @@ double LSTMDrugThreeComp::calculateFactor(const Params_fC& p, double duration) c
     double intfC, err_eps;
     
     int r = gsl_integration_qag (&F, 0.0, duration, abs_eps, rel_eps,
-                                 GSL_INTG_MAX_ITER, qag_rule, gsl_intgr_wksp, &intfC, &err_eps);
+                                 GSL_INTG_MAX_ITER, qag_rule, util::GslWorkspaces::integration(GSL_INTG_MAX_ITER),
+                                 &intfC, &err_eps);
     if( r != 0 ){
         throw TRACED_EXCEPTION( "calculateFactor: error from gsl_integration_qag",util::Error::GSL );
     }
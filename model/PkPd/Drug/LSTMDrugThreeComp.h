@@ -53,6 +53,12 @@ public:
     
     virtual double calculateDrugFactor(LocalRng& rng, WithinHost::CommonInfection *inf, double body_mass) const;
     virtual void updateConcentration (double body_mass);
+    virtual bool isNegligible() const{
+        return conc() == 0.0 && doses.size() == 0;
+    }
+    virtual size_t memoryUsage() const{
+        return sizeof(*this) + doses.capacity() * sizeof(DoseVec::value_type);
+    }
     
 protected:
     virtual void checkpoint (istream& stream);
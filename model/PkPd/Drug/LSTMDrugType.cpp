@@ -97,6 +97,7 @@ void LSTMDrugType::clear()
 {
     drugTypes.clear();
     drugTypeNames.clear();
+    drugsInUse.clear();
 }
 
 size_t LSTMDrugType::numDrugTypes(){
@@ -26,16 +26,21 @@
 #include "mon/reporting.h"
 #include "util/checkpoint_containers.h"
 #include "util/errors.h"
+#include "util/ModelOptions.h"
 
 #include "schema/scenario.h"
 
 #include <cassert>
+#include <algorithm>
 
 namespace OM { namespace PkPd {
 
 // ———  static  ———
 
 void LSTMModel::init( const scnXml::Scenario& scenario ){
+    // drugs and treatments of any previous simulation:
+    LSTMDrugType::clear();
+    LSTMTreatments::clear();
     if (scenario.getPharmacology().present()) {
         LSTMDrugType::init(scenario.getPharmacology().get().getDrugs());
         LSTMTreatments::init(scenario.getPharmacology().get().getTreatments());
@@ -143,13 +148,21 @@ double LSTMModel::getDrugFactor (LocalRng& rng, WithinHost::CommonInfection *inf
 
 void LSTMModel::decayDrugs (double body_mass) {
     // Update concentrations for each drug.
-    // TODO: previously we removed drugs with negligible concentration here. What now, just set concentration to 0?
     for( auto& drug : m_drugs ){
         drug->updateConcentration(body_mass);
     }
+    if( util::ModelOptions::option( util::REMOVE_NEGLIGIBLE_DRUGS ) ){
+        // Drugs below their negligible concentration have been zeroed above;
+        // once no doses are pending they have no effect and can be removed.
+        m_drugs.erase( std::remove_if( m_drugs.begin(), m_drugs.end(),
+            []( const unique_ptr<LSTMDrug>& drug ){ return drug->isNegligible(); } ),
+            m_drugs.end() );
+    }
 }
 
 void LSTMModel::summarize(const Host::Human& human) const{
+    if( !mon::isUsedM( mon::MHR_HOSTS_POS_DRUG_CONC ) &&
+        !mon::isUsedM( mon::MHF_LOG_DRUG_CONC ) ) return;
     const vector<size_t> &drugsInUse( LSTMDrugType::getDrugsInUse() );
     for( size_t index : drugsInUse ){
         for( auto& drug : m_drugs ){
@@ -162,4 +175,14 @@ void LSTMModel::summarize(const Host::Human& human) const{
     }
 }
 
+size_t LSTMModel::memoryUsage() const{
+    size_t bytes = sizeof(*this) + m_drugs.capacity() * sizeof(unique_ptr<LSTMDrug>);
+    for( auto& drug : m_drugs ){
+        bytes += drug->memoryUsage();
+    }
+    // list nodes: data plus two pointers
+    bytes += medicateQueue.size() * (sizeof(MedicateData) + 2 * sizeof(void*));
+    return bytes;
+}
+
 } }
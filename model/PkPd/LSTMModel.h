@@ -80,7 +80,7 @@ private:
  *  * getDrugFactor() for each infection
  *  * decayDrugs()
  */
-class LSTMModel {
+class LSTMModel : public util::PooledObject {
 public:
     /// Static initialisation
     static void init ( const scnXml::Scenario& scenario );
@@ -127,12 +127,23 @@ public:
     /** After any resident infections have been reduced by getDrugFactor(),
      * this function is called to update drug levels to their effective level
      * at the end of the day, as well as clear data once drug concentrations
-     * become negligible. */
+     * become negligible (and, with the REMOVE_NEGLIGIBLE_DRUGS option, remove
+     * such drugs). */
     void decayDrugs (double body_mass);
     
     /** Make summaries of drug concentration data. */
     void summarize( const Host::Human& human ) const;
     
+    /** True when no drugs are in the body and no medications are pending;
+     * the model may then be discarded and later replaced by a new instance
+     * without changing results. */
+    inline bool empty() const{
+        return m_drugs.empty() && medicateQueue.empty();
+    }
+    
+    /// Approximate memory used by this object and its drugs, in bytes
+    size_t memoryUsage() const;
+    
 private:
     /** Medicate drugs to an individual, which act on infections the following
      * time steps, until rendered ineffective by decayDrugs().
@@ -154,10 +165,10 @@ private:
     void checkpoint (ostream& stream);
     
     /// Drugs with non-zero blood concentrations:
-    vector<unique_ptr<LSTMDrug>> m_drugs;
+    util::PooledVector<unique_ptr<LSTMDrug>> m_drugs;
     
     /// All pending medications
-    list<MedicateData> medicateQueue;
+    util::PooledList<MedicateData> medicateQueue;
     
     friend class ::UnittestUtil;
 };
@@ -33,9 +33,12 @@
 #include "util/random.h"
 #include "util/ModelOptions.h"
 #include "util/StreamValidator.h"
+#include "util/TaskPool.h"
 #include <schema/scenario.h>
 
 #include <cmath>
+#include <algorithm>
+#include <optional>
 
 namespace OM
 {
@@ -70,9 +73,11 @@ void Population::staticCheckpoint (ostream& stream)
 
 // -----  non-static methods: creation/destruction, checkpointing  -----
 
-Population::Population(size_t populationSize)
-    : populationSize (populationSize), recentBirths(0)
+Population::Population(size_t populationSize, util::MasterRng& masterRng)
+    : populationSize (populationSize), masterRng(masterRng), recentBirths(0)
 {
+    // Counts of hosts with vector interventions are static; start from zero
+    Transmission::PerHost::resetCounts();
     using mon::Continuous;
     Continuous.registerCallback( "hosts", "\thosts", MakeDelegate( this, &Population::ctsHosts ) );
     // Age groups are currently hard-coded.
@@ -111,13 +116,15 @@ Population::Population(size_t populationSize)
 
 void Population::checkpoint (istream& stream)
 {
+    // Loaded humans re-add themselves to the counts
+    Transmission::PerHost::resetCounts();
     populationSize & stream;
     recentBirths & stream;
     
     for(size_t i = 0; i < populationSize && !stream.eof(); ++i) {
         // Note: calling this constructor of Host::Human is slightly wasteful, but avoids the need for another
         // ctor and leaves less opportunity for uninitialized memory.
-        population.push_back( Host::Human (SimTime::zero()) );
+        population.push_back( Host::Human (SimTime::zero(), masterRng.gen_rng_seed()) );
         population.back() & stream;
     }
     if (population.size() != populationSize)
@@ -147,6 +154,13 @@ void Population::createInitialHumans()
     structure in any case). However, we don't update humans known not to survive
     until vector init, which saves computation and memory (no infections). */
     
+    // Dates of birth and RNG seeds are drawn serially, in creation order;
+    // humans are then constructed concurrently. The result does not depend
+    // on the number of threads.
+    vector<SimTime> dobs;
+    vector<util::RngSeed> seeds;
+    dobs.reserve( populationSize );
+    seeds.reserve( populationSize );
     int cumulativePop = 0;
     for(size_t iage_prev = AgeStructure::getMaxTStepsPerLife(), iage = iage_prev - 1;
          iage_prev > 0; iage_prev = iage, iage -= 1 )
@@ -155,11 +169,24 @@ void Population::createInitialHumans()
         while (cumulativePop < targetPop) {
             SimTime dob = SimTime::zero() - SimTime::fromTS(iage);
             util::streamValidate( dob.inDays() );
-            population.push_back( Host::Human (dob) );
+            dobs.push_back( dob );
+            seeds.push_back( masterRng.gen_rng_seed() );
             ++cumulativePop;
         }
     }
     
+    const size_t n = dobs.size(), BLOCK = 1024;
+    vector<std::optional<Host::Human>> humans( n );
+    util::TaskPool::forEach( (n + BLOCK - 1) / BLOCK, [&]( size_t b ){
+        for( size_t i = b * BLOCK, end = std::min( n, i + BLOCK ); i < end; ++i ){
+            humans[i].emplace( dobs[i], seeds[i] );
+        }
+    } );
+    population.reserve( population.size() + n );
+    for( std::optional<Host::Human>& human : humans ){
+        population.push_back( std::move( *human ) );
+    }
+    
     // Vector setup dependant on human population structure (we *want* to
     // include all humans, whether they'll survive to vector init phase or not).
     assert( sim::now() == SimTime::zero() );      // assumed below
@@ -202,6 +229,7 @@ void Population::update(Transmission::TransmissionModel& transmission, SimTime f
         bool outmigrate = cumPop >= AgeStructure::targetCumPop(iter->age(sim::ts1()).inSteps(), targetPop);
         
         if( isDead || outmigrate ){
+            iter->perHostTransmission.removeFromCounts();
             iter = population.erase (iter);
             continue;
         }
@@ -213,7 +241,7 @@ void Population::update(Transmission::TransmissionModel& transmission, SimTime f
     recentBirths += (targetPop - cumPop);
     while (cumPop < targetPop) {
         // humans born at end of this time step = beginning of next, hence ts1
-        population.push_back( Host::Human (sim::ts1()) );
+        population.push_back( Host::Human (sim::ts1(), masterRng.gen_rng_seed()) );
         ++cumPop;
     }
 }
@@ -226,14 +254,14 @@ void Population::ctsHosts (ostream& stream){
     stream << '\t' << population.size();
 }
 void Population::ctsHostDemography (ostream& stream){
+    // Humans are ordered from oldest to youngest, so in reverse order the
+    // humans under each bound form a prefix, found by binary search.
     auto iter = population.crbegin();
-    int cumCount = 0;
     for( double ubound : ctsDemogAgeGroups ){
-        while( iter != population.crend() && iter->age(sim::now()).inYears() < ubound ){
-            ++cumCount;
-            ++iter;
-        }
-        stream << '\t' << cumCount;
+        iter = std::partition_point( iter, population.crend(),
+            [ubound]( const Host::Human& human ){
+                return human.age(sim::now()).inYears() < ubound; } );
+        stream << '\t' << (iter - population.crbegin());
     }
 }
 void Population::ctsRecentBirths (ostream& stream){
@@ -266,18 +294,18 @@ void Population::ctsImmunityY (ostream& stream){
     stream << '\t' << x;
 }
 void Population::ctsMedianImmunityY (ostream& stream){
-    vector<double> list;
-    list.reserve( populationSize );
+    vector<double>& list = ctsBuffer;       // reused to avoid re-allocation
+    list.clear();
     for(Iter iter = population.begin(); iter != population.end(); ++iter) {
         list.push_back( iter->getWithinHostModel().getCumulative_Y() );
     }
-    sort( list.begin(), list.end() );
-    double x;
+    // Partial sort: only the middle element(s) need be in place
+    size_t i = populationSize / 2;
+    std::nth_element( list.begin(), list.begin() + i, list.end() );
+    double x = list[i];
     if( mod_nn(populationSize, 2) == 0 ){
-        size_t i = populationSize / 2;
-        x = (list[i-1]+list[i])/2.0;
-    }else{
-        x = list[populationSize / 2];
+        // lower middle value is the largest of those before i
+        x = (*std::max_element( list.begin(), list.begin() + i ) + x) / 2.0;
     }
     stream << '\t' << x;
 }
@@ -293,26 +321,17 @@ void Population::ctsMeanAgeAvailEffect (ostream& stream){
     stream << '\t' << avail/nHumans;
 }
 void Population::ctsITNCoverage (ostream& stream){
-    int nActive = 0;
-    for(Iter iter = population.begin(); iter != population.end(); ++iter) {
-        nActive += iter->perHostTransmission.hasActiveInterv( interventions::Component::ITN );
-    }
+    int nActive = Transmission::PerHost::numActiveHosts( interventions::Component::ITN );
     double coverage = static_cast<double>(nActive) / populationSize;
     stream << '\t' << coverage;
 }
 void Population::ctsIRSCoverage (ostream& stream){
-    int nActive = 0;
-    for(Iter iter = population.begin(); iter != population.end(); ++iter) {
-        nActive += iter->perHostTransmission.hasActiveInterv( interventions::Component::IRS );
-    }
+    int nActive = Transmission::PerHost::numActiveHosts( interventions::Component::IRS );
     double coverage = static_cast<double>(nActive) / populationSize;
     stream << '\t' << coverage;
 }
 void Population::ctsGVICoverage (ostream& stream){
-    int nActive = 0;
-    for(Iter iter = population.begin(); iter != population.end(); ++iter) {
-        nActive += iter->perHostTransmission.hasActiveInterv( interventions::Component::GVI );
-    }
+    int nActive = Transmission::PerHost::numActiveHosts( interventions::Component::GVI );
     double coverage = static_cast<double>(nActive) / populationSize;
     stream << '\t' << coverage;
 }
@@ -341,5 +360,11 @@ void Population::flushReports (){
     }
 }    
 
+void Population::memoryUsage( util::MemoryUsage& usage ) const{
+    for( const Host::Human& human : population ){
+        human.memoryUsage( usage );
+    }
+}
+
 }
 
@@ -47,7 +47,9 @@ public:
     static void staticCheckpoint (ostream& stream); ///< ditto
 
 
-    Population( size_t populationSize );
+    /** @param masterRng RNG from which humans' RNGs are seeded (owned by
+     *  the SimulationContext; must outlive the population) */
+    Population( size_t populationSize, util::MasterRng& masterRng );
     
     void checkpoint (istream& stream);
     void checkpoint (ostream& stream);
@@ -71,6 +73,9 @@ public:
     /// Flush anything pending report. Should only be called just before destruction.
     void flushReports();
     
+    /// Add approximate memory used by all humans to usage.
+    void memoryUsage( util::MemoryUsage& usage ) const;
+    
     /// Type of population list. Store pointers to humans only to avoid copy operations.
     typedef vector<Host::Human> HumanPop;
     /// Iterator type of population
@@ -136,12 +141,18 @@ private:
     //! Size of the human population
     size_t populationSize;
     
+    /// Seeds humans' RNGs
+    util::MasterRng& masterRng;
+    
     ///@brief Variables for continuous reporting
     //@{
     vector<double> ctsDemogAgeGroups;
     
     /// Births since last continuous output
     int recentBirths;
+    
+    /// Buffer reused by ctsMedianImmunityY
+    vector<double> ctsBuffer;
     //@}
     
     /** The simulated human population
@@ -0,0 +1,647 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "SimulationContext.h"
+
+#include "Transmission/transmission.h"
+#include "Parameters.h"
+#include "Clinical/ClinicalModel.h"
+#include "mon/Continuous.h"
+#include "interventions/InterventionManager.hpp"
+#include "Population.h"
+#include "WithinHost/WHInterface.h"
+#include "WithinHost/Diagnostic.h"
+#include "WithinHost/Genotypes.h"
+#include "mon/management.h"
+#include "util/timer.h"
+#include "util/CommandLine.h"
+#include "util/ModelOptions.h"
+#include "util/ObjectPool.h"
+#include "util/StepArena.h"
+#include "util/errors.h"
+#include "util/random.h"
+#include "util/StreamValidator.h"
+#include "schema/scenario.h"
+
+#include <fstream>
+#include <gzstream/gzstream.h>
+
+#include <cerrno>
+#include <map>
+#include <thread>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/wait.h>
+#define OM_FORK_REPLICATES
+#endif
+
+namespace OM {
+    using mon::Continuous;
+    using interventions::InterventionManager;
+    using Transmission::TransmissionModel;
+
+SimulationContext* SimulationContext::s_current = nullptr;
+
+SimulationContext::SimulationContext( const string& scenarioFile ) :
+    m_masterRng(0, 0),
+    startedFromCheckpoint(false),
+    timer(!util::CommandLine::getTimingsName().empty())
+{
+    timer.phase( "initialisation" );
+    // Load the scenario document:
+    documentLoader.loadDocument(scenarioFile);
+    init();
+}
+
+SimulationContext::SimulationContext( util::DocumentLoader&& document ) :
+    documentLoader(std::move(document)),
+    m_masterRng(0, 0),
+    startedFromCheckpoint(false),
+    timer(!util::CommandLine::getTimingsName().empty())
+{
+    timer.phase( "initialisation" );
+    init();
+}
+
+void SimulationContext::init()
+{
+    // Static functions use the state of this simulation from now on:
+    m_simTime.makeCurrent();
+    m_monState.makeCurrent();
+    m_interventions = unique_ptr<interventions::State>( new interventions::State() );
+    m_interventions->makeCurrent();
+    s_current = this;
+    // Drop callbacks registered by any previous simulation:
+    Continuous.clear();
+
+    const scnXml::Scenario &scenario = documentLoader.document();
+    const scnXml::Model &model = scenario.getModel();
+
+    // 1) elements with no dependencies on other elements initialised here:
+    sim::init( scenario );  // also reads survey dates
+    Parameters parameters( model.getParameters() );     // depends on nothing
+    WithinHost::Genotypes::init( scenario );
+
+    // The master RNG is cryptographic with a hard-coded IV. Use of low
+    // Hamming weight inputs (numbers close to 0) should not reduce quality.
+    m_masterRng.seed( model.getParameters().getIseed(), 0 );
+
+    util::ModelOptions::init( model.getModelOptions() );
+
+    // 2) elements depending on only elements initialised in (1):
+
+    // Depends on parameters:
+    WithinHost::diagnostics::init( parameters, scenario );
+
+    // Reporting init depends on diagnostics, monitoring:
+    mon::initReporting( scenario );
+    Population::init( parameters, scenario );
+
+    // 3) elements depending on other elements; dependencies on (1) are not mentioned:
+
+    // Transmission model initialisation depends on Transmission::PerHost and
+    // genotypes (both from Human, from Population::init()) and
+    // mon::AgeGroup (from Surveys.init()):
+    // Note: PerHost dependency can be postponed; it is only used to set adultAge
+    m_population = unique_ptr<Population>(new Population( scenario.getDemography().getPopSize(), m_masterRng ));
+    m_transmission = unique_ptr<TransmissionModel>(Transmission::createTransmissionModel(
+            scenario.getEntomology(), m_population->size(), m_masterRng));
+
+    // Depends on transmission model (for species indexes):
+    // MDA1D may depend on health system (too complex to verify)
+    InterventionManager::init( scenario.getInterventions(), *m_transmission, m_masterRng );
+
+    // Depends on interventions, PK/PD (from humanPop):
+    Clinical::ClinicalModel::setHS( scenario.getHealthSystem() );
+
+    // Depends on interventions:
+    mon::initCohorts( scenario.getMonitoring() );
+
+    // ———  End of static data initialisation  ———
+    checkpointFileName = util::CommandLine::getCheckpointName();
+
+    if(checkpointFileName == "")
+        checkpointFileName = "checkpoint";
+
+    if(util::CommandLine::option(util::CommandLine::CHECKPOINT))
+    {
+        ifstream checkpointFile(checkpointFileName,ios::in);
+        // If not open, file doesn't exist (or is inaccessible)
+        startedFromCheckpoint = checkpointFile.is_open();
+
+        // Cleanup errno in file doesn't exist
+        if(startedFromCheckpoint == false)
+            errno = 0;
+    }
+
+    m_simTime.t0 = SimTime::zero();
+    m_simTime.t1 = SimTime::zero();
+
+    // Make sure warmup period is at least as long as a human lifespan, as the
+    // length required by vector warmup, and is a whole number of years.
+    humanWarmupLength = sim::maxHumanAge();
+    if( humanWarmupLength < m_transmission->minPreinitDuration() ){
+        cerr << "Warning: human life-span (" << humanWarmupLength.inYears();
+        cerr << ") shorter than length of warm-up requested by" << endl;
+        cerr << "transmission model ("
+            << m_transmission->minPreinitDuration().inYears();
+        cerr << "). Transmission may be unstable; perhaps use forced" << endl;
+        cerr << "transmission (mode=\"forced\") or a longer life-span." << endl;
+        humanWarmupLength = m_transmission->minPreinitDuration();
+    }
+    humanWarmupLength = SimTime::fromYearsI( static_cast<int>(ceil(humanWarmupLength.inYears())) );
+
+    endTime = SimTime::zero();
+    estEndTime = humanWarmupLength  // ONE_LIFE_SPAN
+        + m_transmission->expectedInitDuration()
+        // plus MAIN_PHASE: survey period plus one TS for last survey
+        + (sim::endDate() - sim::startDate())
+        + SimTime::oneTS();
+    assert( estEndTime + SimTime::never() < SimTime::zero() );
+}
+
+SimulationContext::~SimulationContext(){
+    if( s_current == this ){
+        s_current = nullptr;
+        Continuous.clear();
+    }
+}
+
+void SimulationContext::run()
+{
+    simulate();
+    timer.phase( "output" );
+    mon::writeSurveyData();
+
+    if( util::CommandLine::option(util::CommandLine::PRINT_MEMORY_USAGE) ){
+        util::MemoryUsage usage;
+        m_population->memoryUsage( usage );
+        usage.print( cout );
+        util::ObjectPool::print( cout );
+    }
+
+# ifdef OM_STREAM_VALIDATOR
+    util::StreamValidator.saveStream();
+# endif
+    writeTimings();
+}
+
+void SimulationContext::writeTimings()
+{
+    if( timer.enabled() )
+        timer.write( util::CommandLine::getTimingsName() );
+}
+
+void SimulationContext::reseed( int seed )
+{
+    // Same order as in init()
+    m_masterRng.seed( seed, 0 );
+    m_transmission->reseed( m_masterRng );
+    InterventionManager::reseed( m_masterRng );
+}
+
+void SimulationContext::runReplicates( size_t n )
+{
+#ifdef OM_FORK_REPLICATES
+    const int firstSeed = documentLoader.document().getModel().getParameters().getIseed();
+    size_t jobs = util::CommandLine::getThreads();
+    if( jobs == 0 ) jobs = std::thread::hardware_concurrency();
+    if( jobs == 0 ) jobs = 1;
+
+    map<pid_t, int> running;    // process id to seed
+    size_t next = 0;
+    int failedSeed = 0, failedCode = util::Error::None;
+    while( running.size() > 0 || (next < n && failedCode == util::Error::None) ){
+        // start replicates until jobs are running (no more after a failure)
+        while( running.size() < jobs && next < n && failedCode == util::Error::None ){
+            int seed = firstSeed + static_cast<int>(next);
+            next += 1;
+            cout.flush();
+            cerr.flush();
+            pid_t pid = fork();
+            if( pid < 0 )
+                throw util::base_exception( "unable to create process for replicate" );
+            if( pid == 0 ){
+                int code = runReplicate( seed );
+                cout.flush();
+                cerr.flush();
+                _exit( code );
+            }
+            running[pid] = seed;
+        }
+
+        int status = 0;
+        pid_t pid = wait( &status );
+        if( pid < 0 ){
+            if( errno == EINTR ) continue;
+            throw util::base_exception( "unable to wait for replicate" );
+        }
+        auto it = running.find( pid );
+        if( it == running.end() ) continue;
+        int code = WIFEXITED(status) ? WEXITSTATUS(status) : util::Error::Default;
+        if( code != util::Error::None && failedCode == util::Error::None ){
+            failedSeed = it->second;
+            failedCode = code;
+        }
+        running.erase( it );
+    }
+    cerr << '\r' << flush;  // clean last line of progress-output
+
+    if( failedCode != util::Error::None ){
+        throw util::base_exception( "replicate with seed " + to_string(failedSeed) +
+                " failed", failedCode );
+    }
+    if( util::CommandLine::option(util::CommandLine::REPLICATE_STATS) )
+        writeReplicateStats( firstSeed, n );
+#else
+    throw util::cmd_exception( "--replicates requires fork(), which is not available on this platform" );
+#endif
+}
+
+int SimulationContext::runReplicate( int seed )
+{
+    try {
+        reseed( seed );
+        util::CommandLine::setOutputSuffix( "_seed" + to_string(seed) );
+        run();
+        return util::Error::None;
+    } catch (const util::base_exception& e) {
+        cerr << "Error (seed " << seed << "): " << e.message() << endl;
+        return e.getCode() != util::Error::None ? e.getCode() : util::Error::Default;
+    } catch (const exception& e) {
+        cerr << "Error (seed " << seed << "): " << e.what() << endl;
+        return util::Error::Default;
+    } catch (...) {
+        cerr << "Unknown error (seed " << seed << ")" << endl;
+        return util::Error::Default;
+    }
+}
+
+namespace {
+    /// Running mean and variance (Welford's method)
+    struct OnlineStats {
+        int survey, group, measure;
+        size_t count;
+        double mean, m2;
+
+        void add( double x ){
+            count += 1;
+            double delta = x - mean;
+            mean += delta / count;
+            m2 += delta * (x - mean);
+        }
+        double variance() const{
+            return count > 1 ? m2 / (count - 1) : 0.0;
+        }
+    };
+
+    /// Add outputs of one replicate; all must have the same rows
+    void addReplicate( istream& stream, const string& name,
+            vector<OnlineStats>& stats, bool first )
+    {
+        size_t row = 0;
+        int survey, group, measure;
+        double value;
+        while( stream >> survey >> group >> measure >> value ){
+            if( first ){
+                stats.push_back( OnlineStats{ survey, group, measure, 0, 0.0, 0.0 } );
+            }else if( row >= stats.size() || stats[row].survey != survey ||
+                    stats[row].group != group || stats[row].measure != measure ){
+                throw util::base_exception( "outputs of replicates differ in structure: " + name );
+            }
+            stats[row].add( value );
+            row += 1;
+        }
+        if( !stream.eof() || row != stats.size() )
+            throw util::base_exception( "unable to read replicate output " + name, util::Error::FileIO );
+    }
+}
+
+void SimulationContext::writeReplicateStats( int firstSeed, size_t n )
+{
+    // Combine in seed order so that results do not depend on scheduling
+    vector<OnlineStats> stats;
+    for( size_t i = 0; i < n; ++i ){
+        string name = util::CommandLine::withSuffix( util::CommandLine::getOutputName(),
+                "_seed" + to_string(firstSeed + static_cast<int>(i)) );
+        if( util::CommandLine::option( util::CommandLine::COMPRESS_OUTPUT ) ){
+            name.append( ".gz" );
+            igzstream stream( name.c_str() );
+            addReplicate( stream, name, stats, i == 0 );
+        }else{
+            ifstream stream( name );
+            addReplicate( stream, name, stats, i == 0 );
+        }
+    }
+
+    string name = util::CommandLine::withSuffix( util::CommandLine::getOutputName(), "_stats" );
+    ofstream stream( name );
+    stream.precision( 10 );
+    for( const OnlineStats& s : stats ){
+        stream << s.survey << '\t' << s.group << '\t' << s.measure << '\t'
+            << s.mean << '\t' << s.variance() << '\n';
+    }
+    stream.close();
+    if( !stream )
+        throw util::base_exception( "unable to write " + name, util::Error::FileIO );
+}
+
+void SimulationContext::simulate()
+{
+    if( s_current != this )
+        throw util::base_exception( "only the most recently initialised simulation may be run" );
+
+    Population& population = *m_population;
+    TransmissionModel& transmission = *m_transmission;
+    const scnXml::Monitoring &monitoring = documentLoader.document().getMonitoring();
+
+    bool skipWarmup = false;
+    if (startedFromCheckpoint)
+    {
+        Continuous.init( monitoring, true );
+        readCheckpoint();
+        skipWarmup = true;
+    }
+    else
+    {
+        Continuous.init( monitoring, false );
+        population.createInitialHumans();
+        transmission.init2(population);
+    }
+
+    int lastPercent = -1;   // last _integer_ percentage value
+
+    if(!skipWarmup)
+    {
+        /** Warm-up phase:
+         * Run the simulation using the equilibrium inoculation rates over one
+         * complete lifespan (sim::maxHumanAge()) to reach immunological
+         * equilibrium in all age classes. Don't report any events. */
+        timer.phase( "warm-up" );
+        endTime = humanWarmupLength;
+        loop(lastPercent);
+
+        // Transmission init phase
+        timer.phase( "transmission-init" );
+        SimTime iterate = transmission.initIterate();
+        while(iterate > SimTime::zero())
+        {
+            endTime += iterate;
+            // adjust estimation of final time step: end of current period + length of main phase
+            estEndTime = endTime + (sim::endDate() - sim::startDate()) + SimTime::oneTS();
+            loop(lastPercent);
+            iterate = transmission.initIterate();
+        }
+
+        // Main phase
+        //! This procedure starts with the current state of the simulation
+        /*! It continues updating assuming:
+            (i)         the default (exponential) demographic model
+            (ii)        the entomological input defined by the EIRs in intEIR()
+            (iii)       the intervention packages defined in Intervention()
+            (iv)        the survey times defined in Survey() */
+        endTime = estEndTime;
+        m_simTime.interv = SimTime::zero();
+        population.preMainSimInit();
+        transmission.summarize();    // Only to reset TransmissionModel::inoculationsPerAgeGroup
+        mon::initMainSim();
+
+        if(util::CommandLine::option (util::CommandLine::CHECKPOINT))
+        {
+            writeCheckpoint();
+            if( util::CommandLine::option (util::CommandLine::CHECKPOINT_STOP) )
+                throw util::cmd_exception ("Checkpoint test: checkpoint written", util::Error::None);
+        }
+    }
+
+    timer.phase( "main" );
+    loop(lastPercent);
+
+    cerr << '\r' << flush;  // clean last line of progress-output
+
+    population.flushReports();        // ensure all Human instances report past events
+}
+
+// Internal simulation loop
+void SimulationContext::loop( int lastPercent )
+{
+    Population& population = *m_population;
+    TransmissionModel& transmission = *m_transmission;
+
+    const size_t maxSteps = util::CommandLine::getMaxSteps();
+
+    while (sim::now() < endTime)
+    {
+        if( maxSteps > 0 && sim::now() >= SimTime::fromTS(static_cast<int>(maxSteps)) ){
+            writeTimings();
+            throw util::cmd_exception( "Stopped after " + to_string(maxSteps) + " steps", util::Error::None );
+        }
+        timer.startStep( population.size() );
+
+        // Monitoring. sim::now() gives time of end of last step,
+        // and is when reporting happens in our time-series.
+        Continuous.update( population );
+        if( sim::intervDate() == mon::nextSurveyDate() ){
+            population.newSurvey();
+            transmission.summarize();
+            mon::concludeSurvey();
+        }
+        timer.lap( util::PhaseTimer::MONITORING );
+
+        // Deploy interventions, at time sim::now().
+        InterventionManager::deploy( population, transmission );
+        timer.lap( util::PhaseTimer::INTERVENTIONS );
+
+        // Time step updates. Time steps are mid-day to mid-day.
+        // sim::ts0() gives the date at the start of the step, sim::ts1() the date at the end.
+        sim::start_update();
+        util::StepArena::nextStep();
+
+        // This should be called before humans contract new infections in the simulation step.
+        // This needs the whole population (it is an approximation before all humans are updated).
+        transmission.vectorUpdate (population);
+        timer.lap( util::PhaseTimer::VECTOR_UPDATE );
+
+        population.update(transmission, humanWarmupLength);
+        timer.lap( util::PhaseTimer::POPULATION_UPDATE );
+
+        // Doesn't matter whether non-updated humans are included (value isn't used
+        // before all humans are updated).
+        transmission.update(population);
+        timer.lap( util::PhaseTimer::TRANSMISSION_UPDATE );
+
+        sim::end_update();
+
+        int percent = (sim::now() * 100) / estEndTime;
+        if( percent != lastPercent ){   // avoid huge amounts of output for performance/log-file size reasons
+            lastPercent = percent;
+            // \r cleans line. Then we print progress as a percentage.
+            cerr << "\r" << percent << "%\t" << flush;
+        }
+    }
+}
+
+/** @brief checkpointing functions
+*
+* readCheckpoint/writeCheckpoint prepare to read/write the file,
+* and read/write read and write the actual data. */
+//@{
+static int readCheckpointNum (const string &checkpointFileName)
+{
+    ifstream checkpointFile;
+    checkpointFile.open(checkpointFileName, fstream::in);
+    int checkpointNum=0;
+    checkpointFile >> checkpointNum;
+    checkpointFile.close();
+    if (!checkpointFile)
+        throw util::checkpoint_error ("error reading from file \"checkpoint\"");
+    return checkpointNum;
+}
+
+void SimulationContext::checkpoint (istream& stream)
+{
+    try
+    {
+        util::checkpoint::header (stream);
+        util::CommandLine::staticCheckpoint (stream);
+        Population::staticCheckpoint (stream);
+        Continuous & stream;
+        mon::checkpoint( stream );
+#       ifdef OM_STREAM_VALIDATOR
+        util::StreamValidator & stream;
+#       endif
+
+        m_simTime.interv & stream;
+        endTime & stream;
+        estEndTime & stream;
+        *m_transmission & stream;
+        m_population->checkpoint(stream);
+        InterventionManager::checkpoint(stream);
+        InterventionManager::loadFromCheckpoint(*m_population, *m_transmission);
+
+        // read last, because other loads may use random numbers or expect time
+        // to be negative
+        m_simTime.t0 & stream;
+        m_simTime.t1 & stream;
+        m_masterRng.checkpoint(stream);
+    } catch (const util::checkpoint_error& e) { // append " (pos X of Y bytes)"
+        ostringstream pos;
+        pos<<" (pos "<<stream.tellg()<<" of ";
+        stream.ignore (numeric_limits<streamsize>::max()-1);    // skip to end of file
+        pos<<stream.tellg()<<" bytes)";
+        throw util::checkpoint_error( e.what() + pos.str() );
+    }
+
+
+    stream.ignore (numeric_limits<streamsize>::max()-1);        // skip to end of file
+    if (stream.gcount () != 0) {
+        ostringstream msg;
+        msg << "Checkpointing file has " << stream.gcount() << " bytes remaining." << endl;
+        throw util::checkpoint_error (msg.str());
+    } else if (stream.fail())
+        throw util::checkpoint_error ("stream read error");
+}
+
+void SimulationContext::checkpoint (ostream& stream) {
+    util::checkpoint::header (stream);
+    if (!stream.good())
+        throw util::checkpoint_error ("Unable to write to file");
+
+    util::CommandLine::staticCheckpoint (stream);
+    Population::staticCheckpoint (stream);
+    Continuous & stream;
+    mon::checkpoint( stream );
+# ifdef OM_STREAM_VALIDATOR
+    util::StreamValidator & stream;
+# endif
+
+    m_simTime.interv & stream;
+    endTime & stream;
+    estEndTime & stream;
+    *m_transmission & stream;
+    m_population->checkpoint(stream);
+    InterventionManager::checkpoint( stream );
+
+    m_simTime.t0 & stream;
+    m_simTime.t1 & stream;
+    m_masterRng.checkpoint(stream);
+
+    if (stream.fail())
+        throw util::checkpoint_error ("stream write error");
+}
+
+void SimulationContext::writeCheckpoint()
+{
+    // We alternate between two checkpoints, in case program is closed while writing.
+    const int NUM_CHECKPOINTS = 2;
+
+    int oldCheckpointNum = 0, checkpointNum = 0;
+    if (startedFromCheckpoint)
+    {
+        oldCheckpointNum = readCheckpointNum(checkpointFileName);
+        checkpointNum = mod_nn(oldCheckpointNum + 1, NUM_CHECKPOINTS); // Get next checkpoint number:
+    }
+
+    {   // Open the next checkpoint file for writing:
+        ostringstream name;
+        name << checkpointFileName << checkpointNum << ".gz";
+        ogzstream out(name.str().c_str(), ios::out | ios::binary);
+        checkpoint (out);
+        out.close();
+    }
+
+    {   // Indicate which is the latest checkpoint file.
+        ofstream checkpointFile;
+        checkpointFile.open(checkpointFileName,ios::out);
+        checkpointFile << checkpointNum;
+        checkpointFile.close();
+        if (!checkpointFile)
+            throw util::checkpoint_error ("error writing to file \"checkpoint\"");
+    }
+
+    // Truncate the old checkpoint to save disk space, when it existed
+    if( oldCheckpointNum != checkpointNum ){
+        ostringstream name;
+        name << checkpointFileName << oldCheckpointNum << ".gz";
+        ofstream out(name.str().c_str(), ios::out | ios::binary);
+        out.close();
+    }
+}
+
+void SimulationContext::readCheckpoint()
+{
+    int checkpointNum = readCheckpointNum(checkpointFileName);
+
+    // Open the latest file
+    ostringstream name;
+    name << checkpointFileName << checkpointNum << ".gz";
+    igzstream in(name.str().c_str(), ios::in | ios::binary);
+    //Note: gzstreams are considered "good" when file not open!
+    if ( !( in.good() && in.rdbuf()->is_open() ) )
+        throw util::checkpoint_error ("Unable to read file");
+    checkpoint (in);
+    in.close();
+
+    cerr << sim::now().inSteps() << "t loaded checkpoint" << endl;
+}
+//@}
+
+}
@@ -0,0 +1,149 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef Hmod_SimulationContext
+#define Hmod_SimulationContext
+
+#include "Global.h"
+#include "mon/management.h"
+#include "util/DocumentLoader.h"
+#include "util/PhaseTimer.h"
+#include "util/random.h"
+
+#include <memory>
+#include <string>
+
+namespace OM {
+    class Population;
+namespace Transmission {
+    class TransmissionModel;
+}
+namespace interventions {
+    class State;
+}
+
+/** A single simulation: the loaded scenario, the human population and
+ * transmission model, and the simulation phases (warm-up, transmission
+ * initialisation, main simulation) including checkpointing.
+ *
+ * main() creates one and calls run(); other entry points may do the same.
+ *
+ * The context owns the master RNG, which it passes to the components seeding
+ * RNGs from it, and the simulation time (sim::State), monitoring data
+ * (mon::State) and deployed interventions (interventions::State), which it
+ * makes current on initialisation.
+ *
+ * Other model parameters are still process-global (static members of model
+ * classes: genotypes, per-host anopheles parameters, drug types, treatments,
+ * decision trees, Continuous and the like). These are re-initialised by
+ * each context, so several scenarios may be run one after another in one
+ * process, but only the most recently initialised context may be run, and
+ * scenarios cannot be run concurrently. */
+class SimulationContext {
+public:
+    /** Load the scenario document and initialise all model components.
+     *
+     * @param scenarioFile Path of the scenario XML document (already
+     *  resolved with util::CommandLine::lookupResource). */
+    explicit SimulationContext( const std::string& scenarioFile );
+    /** Initialise all model components from an already loaded (and possibly
+     * modified) scenario document. */
+    explicit SimulationContext( util::DocumentLoader&& document );
+    ~SimulationContext();
+
+    /** Run the simulation to the end (or from and to checkpoints, as set by
+     * the command line), then write survey outputs. */
+    void run();
+
+    /** Run the simulation to the end without writing survey outputs; these
+     * may then be retrieved with mon::writeToStream(). */
+    void simulate();
+
+    /** Run n replicates with seeds iseed, ..., iseed+n-1, each in a child
+     * process started after initialisation, writing outputs per seed (see
+     * util::CommandLine::setOutputSuffix). Up to --threads replicates run at
+     * once. Optionally writes the mean and variance of outputs over
+     * replicates. Requires POSIX fork(). */
+    void runReplicates( size_t n );
+
+    /** Re-seed the master RNG and all RNGs seeded from it during
+     * initialisation. Results are then as if initialised with this seed.
+     * Call only before run(). */
+    void reseed( int seed );
+
+    inline const scnXml::Scenario& scenario(){ return documentLoader.document(); }
+    inline Population& population(){ return *m_population; }
+    inline Transmission::TransmissionModel& transmission(){ return *m_transmission; }
+
+private:
+    SimulationContext( const SimulationContext& ) = delete;
+    SimulationContext& operator=( const SimulationContext& ) = delete;
+
+    /// Initialise model components from documentLoader
+    void init();
+
+    /// Run the replicate with the given seed; returns an exit code
+    int runReplicate( int seed );
+
+    /// Write mean and variance over replicates of each output
+    void writeReplicateStats( int firstSeed, size_t n );
+
+    /// Run time steps until endTime
+    void loop( int lastPercent );
+
+    /// Write timings if requested (--timings)
+    void writeTimings();
+
+    ///@brief Checkpointing
+    //@{
+    void checkpoint( istream& stream );
+    void checkpoint( ostream& stream );
+    void writeCheckpoint();
+    void readCheckpoint();
+    //@}
+
+    util::DocumentLoader documentLoader;
+    // State of this simulation used by static functions of sim, mon and
+    // interventions; must outlive the population and transmission model
+    sim::State m_simTime;
+    mon::State m_monState;
+    unique_ptr<interventions::State> m_interventions;
+    // Seeds all other RNGs; must outlive the population and transmission model
+    util::MasterRng m_masterRng;
+    unique_ptr<Population> m_population;
+    unique_ptr<Transmission::TransmissionModel> m_transmission;
+
+    string checkpointFileName;
+    bool startedFromCheckpoint;
+
+    // Length of the human warm-up phase (a whole number of years)
+    SimTime humanWarmupLength;
+    // End of the current phase, and estimated end of the simulation
+    SimTime endTime, estEndTime;
+
+    // Times of phases and parts of steps (when using --timings)
+    util::PhaseTimer timer;
+
+    // The most recently initialised instance (see class documentation)
+    static SimulationContext* s_current;
+};
+
+}
+#endif
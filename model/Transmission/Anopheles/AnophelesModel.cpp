@@ -27,6 +27,7 @@
 #include "util/errors.h"
 #include "util/ModelOptions.h"
 #include "util/StreamValidator.h"
+#include "util/StepArena.h"
 
 #include <cmath>
 
@@ -74,7 +75,6 @@ string AnophelesModel::initialise (size_t species, const scnXml::AnophelesParams
     }
     ftauArray[mosqRestDuration] = 1.0;
     uninfected_v.resize(N_v_length);
-    uninfected_v[SimTime::zero()] = numeric_limits<double>::quiet_NaN();    // index not used
 
     // Uses anoph.getNonHumanHosts() and anoph.getMosq():
     initAvailability( species, anoph, /*nonHumanHostPopulations,*/ populationSize );
@@ -388,6 +388,8 @@ void AnophelesModel::init2 (int nHumans, double meanPopAvail,
             O_v.at(t,genotype) = S_v.at(t,genotype) * initOvFromSv;
         }
     }
+    calcUninfected_v();
+    nDaysP_AStable = SimTime::zero();
 
     // Crude estimate of mosqEmergeRate: (1 - P_A(t) - P_df(t)) / (T * ρ_S) * S_T(t)
     mosqEmergeRate = forcedS_v;
@@ -401,6 +403,9 @@ void AnophelesModel::init2 (int nHumans, double meanPopAvail,
     rotated = false;
 }
 
+/// Relative error in annual S_v accepted when fitting emergence
+const double FIT_LIMIT = 0.1;
+
 bool AnophelesModel::initIterate ()
 {
     vecDay<double> avgAnnualS_v( SimTime::oneYear(), 0.0 );
@@ -427,9 +432,7 @@ bool AnophelesModel::initIterate ()
         throw TRACED_EXCEPTION ("factor out of bounds",util::Error::VectorFitting);
     }
 
-    const double LIMIT = 0.1;
-
-    if(fabs(factor - 1.0) > LIMIT)
+    if(fabs(factor - 1.0) > FIT_LIMIT)
     {
         scaled = false;
         double factorDiff = (scaleFactor * factor - scaleFactor) * 1.0;
@@ -460,6 +463,62 @@ bool AnophelesModel::initIterate ()
 
     return !(scaled && rotated);
 }
+
+void AnophelesModel::initFastFit( const vecDay<double>& sum_avail, const vecDay<double>& sigma_df,
+        const vecDay2D<double>& sigma_dif, const vecDay<double>& sigma_dff )
+{
+    assert( sum_avail.size() == SimTime::oneYear() && sigma_dif.size1() == SimTime::oneYear() );
+    // As with the full simulation: one year of stabilisation then five years
+    // of data collection (filling quinquennialS_v) per iteration.
+    const SimTime duration = SimTime::oneYear() + SimTime::fromYearsI(5);
+    const SimTime start = sim::now();
+    vector<double> tsSigma_dif;
+    for( int iteration = 1; ; ++iteration ){
+        if( iteration > 30 ){
+            throw TRACED_EXCEPTION("Transmission warmup exceeded 30 iterations!",util::Error::VectorWarmup);
+        }
+        for( SimTime ts0 = start, end = start + duration; ts0 < end; ts0 += SimTime::oneTS() ){
+            const SimTime d = mod_nn(ts0, SimTime::oneYear());
+            // advancePeriod modifies its sigma_dif argument, so copy:
+            tsSigma_dif.assign( &sigma_dif.at(d, 0), &sigma_dif.at(d, 0) + sigma_dif.size2() );
+            advancePeriod( ts0, sum_avail[d], sigma_df[d], tsSigma_dif, sigma_dff[d], false );
+            // Species may be fitted concurrently (see VectorModel), so only
+            // reclaim this thread's arena; otherwise it would grow by the
+            // working copies of every step of the fit.
+            util::StepArena::nextThreadStep();
+        }
+        rewind( duration );
+        if( !initIterate() ) return;
+    }
+}
+
+bool AnophelesModel::initFastFitCheck() const
+{
+    if( vectors::sum(forcedS_v) == 0.0 ) return true;   // as in initIterate()
+    // quinquennialS_v is indexed by the time at the end of each day:
+    double sumS_v = 0.0;
+    for( SimTime d = sim::now() - SimTime::oneYear() + SimTime::oneDay(); d <= sim::now(); d += SimTime::oneDay() ){
+        sumS_v += quinquennialS_v[mod_nn(d, SimTime::fromYearsI(5))];
+    }
+    const double factor = vectors::sum(forcedS_v) / sumS_v;
+    return fabs(factor - 1.0) <= FIT_LIMIT;
+}
+
+void AnophelesModel::rewind( SimTime duration ){
+    assert( mod_nn(duration, SimTime::oneYear()) == SimTime::zero() );
+    vectors::rotate( P_A, duration );
+    vectors::rotate( P_Amu, duration );
+    vectors::rotate( P_A1, duration );
+    vectors::rotate( P_Ah, duration );
+    vectors::rotate( P_df, duration );
+    vectors::rotate( P_dff, duration );
+    vectors::rotate( P_dif, duration );
+    vectors::rotate( N_v, duration );
+    vectors::rotate( O_v, duration );
+    vectors::rotate( S_v, duration );
+    vectors::rotate( uninfected_v, duration );
+    vectors::rotate( quinquennialS_v, duration );
+}
 //@}
 
 void AnophelesModel::initVectorInterv( const scnXml::VectorSpeciesIntervention& elt, size_t instance ){
@@ -605,10 +664,15 @@ void AnophelesModel::deployAddNonHumanHosts(LocalRng& rng, size_t species, strin
 // Every SimTime::oneTS() days:
 void AnophelesModel::advancePeriod (
         double sum_avail, double sigma_df, vector<double>& sigma_dif, double sigma_dff, bool isDynamic)
+{
+    advancePeriod( sim::ts0(), sum_avail, sigma_df, sigma_dif, sigma_dff, isDynamic );
+}
+void AnophelesModel::advancePeriod (SimTime ts0,
+        double sum_avail, double sigma_df, vector<double>& sigma_dif, double sigma_dff, bool isDynamic)
 {
     interventionSurvival = 1.0;
     for( size_t i = 0; i < emergenceReduction.size(); ++i ){
-        interventionSurvival *= 1.0 - emergenceReduction[i].current_value( sim::ts0() );
+        interventionSurvival *= 1.0 - emergenceReduction[i].current_value( ts0 );
     }
     
     /* Largely equations correspond to Nakul Chitnis's model in
@@ -647,14 +711,14 @@ void AnophelesModel::advancePeriod (
     // ν_A: rate at which mosquitoes find hosts or die (i.e. leave host-seeking state
     double leaveRate = mosqSeekingDeathRate;
     for( const util::SimpleDecayingValue& increase : seekingDeathRateIntervs ){
-        leaveRate *= 1.0 + increase.current_value( sim::ts0() );
+        leaveRate *= 1.0 + increase.current_value( ts0 );
     }
     leaveRate += sum_avail;
 
     // NON-HUMAN HOSTS INTERVENTIONS
     // Check if some nhh must be removed
     for( auto it = initNhh.begin(); it != initNhh.end();){
-        if( sim::ts0() >= it->second.expiry ){
+        if( ts0 >= it->second.expiry ){
             it = initNhh.erase(it);
             continue;
         }
@@ -665,13 +729,15 @@ void AnophelesModel::advancePeriod (
     double modified_nhh_sigma_df = 0.0;
     double modified_nhh_sigma_dff = 0.0;
 
-    map<string,NHH> currentNhh = initNhh;
+    // Working copy, keyed by views of the keys of initNhh (which outlive it)
+    std::pmr::map<std::string_view,NHH> currentNhh( util::StepArena::resource() );
+    for( const auto& nhh : initNhh ) currentNhh.emplace( nhh.first, nhh.second );
 
     for( auto it = reduceNHHAvailability.begin(); it != reduceNHHAvailability.end(); ++it) {
         for( const auto &decay : it->second )
         {
             if(currentNhh.count(it->first) != 0) // Check that the non-human hosts still exist
-                currentNhh[it->first].avail_i *= 1.0 - decay.current_value( sim::ts0() );
+                currentNhh[it->first].avail_i *= 1.0 - decay.current_value( ts0 );
         }
     }
 
@@ -679,7 +745,7 @@ void AnophelesModel::advancePeriod (
         for( const auto &decay : it->second )
         {
             if(currentNhh.count(it->first) != 0) // Check that the non-human hosts still exist
-                currentNhh[it->first].P_B_I *= 1.0 - decay.current_value( sim::ts0() );
+                currentNhh[it->first].P_B_I *= 1.0 - decay.current_value( ts0 );
         }
     }
 
@@ -687,7 +753,7 @@ void AnophelesModel::advancePeriod (
         for( const auto &decay : it->second )
         {
             if(currentNhh.count(it->first) != 0) // Check that the non-human hosts still exist
-                currentNhh[it->first].P_C_I *= 1.0 - decay.current_value( sim::ts0() );
+                currentNhh[it->first].P_C_I *= 1.0 - decay.current_value( ts0 );
         }
     }
 
@@ -695,7 +761,7 @@ void AnophelesModel::advancePeriod (
         for( const auto &decay : it->second )
         {
             if(currentNhh.count(it->first) != 0) // Check that the non-human hosts still exist
-                currentNhh[it->first].P_D_I *= 1.0 - decay.current_value( sim::ts0() );
+                currentNhh[it->first].P_D_I *= 1.0 - decay.current_value( ts0 );
         }
     }
 
@@ -703,7 +769,7 @@ void AnophelesModel::advancePeriod (
         for( const auto &decay : it->second )
         {
             if(currentNhh.count(it->first) != 0) // Check that the non-human hosts still exist
-                currentNhh[it->first].rel_fecundity *= 1.0 - decay.current_value( sim::ts0() );
+                currentNhh[it->first].rel_fecundity *= 1.0 - decay.current_value( ts0 );
         }
     }
 
@@ -720,11 +786,11 @@ void AnophelesModel::advancePeriod (
     // NON-HUMAN HOSTS INTERVENTIONS
 
     for( auto it = baitedTraps.begin(); it != baitedTraps.end();){
-        if( sim::ts0() > it->expiry ){
+        if( ts0 > it->expiry ){
             it = baitedTraps.erase(it);
             continue;
         }
-        SimTime age = sim::ts0() - it->deployTime;
+        SimTime age = ts0 - it->deployTime;
         double decayCoeff = trapParams[it->instance].availDecay->eval( age, it->availHet );
         leaveRate += it->initialAvail * decayCoeff;
         // sigma_df doesn't change: mosquitoes do not survive traps
@@ -738,7 +804,7 @@ void AnophelesModel::advancePeriod (
     // alphaE (α_E) is α_d * P_E, where P_E may be adjusted by interventions
     double alphaE = availDivisor * probMosqSurvivalOvipositing;
     for( const util::SimpleDecayingValue& pDeath : probDeathOvipositingIntervs ){
-        alphaE *= 1.0 - pDeath.current_value( sim::ts0() );
+        alphaE *= 1.0 - pDeath.current_value( ts0 );
     }
     double tsP_df  = sigma_df * alphaE;
     double tsP_dff = sigma_dff * alphaE;
@@ -761,14 +827,14 @@ void AnophelesModel::advancePeriod (
 
     // The code within the for loop needs to run per-day, wheras the main
     // simulation uses one or five day time steps.
-    const SimTime nextTS = sim::ts0() + SimTime::oneTS();
-    for( SimTime d0 = sim::ts0(); d0 < nextTS; d0 += SimTime::oneDay() ){
+    const SimTime nextTS = ts0 + SimTime::oneTS();
+    for( SimTime d0 = ts0; d0 < nextTS; d0 += SimTime::oneDay() ){
         update( d0, tsP_A, tsP_Amu, tsP_A1, tsP_Ah, tsP_df, sigma_dif, tsP_dff, isDynamic, partialEIR, availDivisor);
     }
 }
 
 void AnophelesModel::update( SimTime d0, double tsP_A, double tsP_Amu, double tsP_A1, double tsP_Ah, double tsP_df,
-        const vector<double> tsP_dif, double tsP_dff,
+        const vector<double>& tsP_dif, double tsP_dff,
         bool isDynamic,
         vector<double>& partialEIR, double EIR_factor)
 {
@@ -781,6 +847,8 @@ void AnophelesModel::update( SimTime d0, double tsP_A, double tsP_Amu, double ts
     SimTime t1    = mod_nn(d1, N_v_length);
     SimTime t0   = mod_nn(d0, N_v_length);
     SimTime ttau = mod_nn(d1Mod - mosqRestDuration, N_v_length);
+    
+    const size_t nGenotypes = Genotypes::N();
 
     // These only need to be calculated once per time step, but should be
     // present in each of the previous N_v_length - 1 positions of arrays.
@@ -790,19 +858,30 @@ void AnophelesModel::update( SimTime d0, double tsP_A, double tsP_Amu, double ts
     P_Ah[t1] = tsP_Ah;
     P_df[t1] = tsP_df;
     P_dff[t1] = tsP_dff;
-    for( size_t i = 0; i < Genotypes::N(); ++i )
+    for( size_t i = 0; i < nGenotypes; ++i )
         P_dif.at(t1,i) = tsP_dif[i];
     
-    //BEGIN cache calculation: fArray, ftauArray, uninfected_v
+    //BEGIN cache calculation: fArray, ftauArray
+    // Entries with index n <= fReuse are unchanged since the last day, since
+    // P_A and P_df were the same over the n + 1 days before today.
+    const SimTime fReuse = nDaysP_AStable;
+    if( P_A[t1] == P_A[t0] && P_df[t1] == P_df[t0] ){
+        if( nDaysP_AStable < EIPDuration )
+            nDaysP_AStable += SimTime::oneDay();
+    }else{
+        nDaysP_AStable = SimTime::zero();
+    }
+    
     // Set up array with n in 1..θ_s−τ for f(d1Mod-n) (NDEMD eq. 1.6)
-    for( SimTime n = SimTime::oneDay(); n <= mosqRestDuration; n += SimTime::oneDay() ){
+    for( SimTime n = fReuse + SimTime::oneDay(); n <= mosqRestDuration; n += SimTime::oneDay() ){
         const SimTime tn = mod_nn(d1Mod-n, N_v_length);
         fArray[n] = fArray[n-SimTime::oneDay()] * P_A[tn];
     }
-    fArray[mosqRestDuration] += P_df[ttau];
+    if( fReuse < mosqRestDuration )
+        fArray[mosqRestDuration] += P_df[ttau];
     
     const SimTime fAEnd = EIPDuration-mosqRestDuration;
-    for( SimTime n = mosqRestDuration+SimTime::oneDay(); n <= fAEnd; n += SimTime::oneDay() ){
+    for( SimTime n = std::max(mosqRestDuration, fReuse) + SimTime::oneDay(); n <= fAEnd; n += SimTime::oneDay() ){
         const SimTime tn = mod_nn(d1Mod-n, N_v_length);
         fArray[n] =
             P_df[tn] * fArray[n - mosqRestDuration]
@@ -811,58 +890,76 @@ void AnophelesModel::update( SimTime d0, double tsP_A, double tsP_Amu, double ts
     
     // Set up array with n in 1..θ_s−1 for f_τ(d1Mod-n) (NDEMD eq. 1.7)
     const SimTime fProdEnd = mosqRestDuration * 2;
-    for( SimTime n = mosqRestDuration+SimTime::oneDay(); n <= fProdEnd; n += SimTime::oneDay() ){
+    for( SimTime n = std::max(mosqRestDuration, fReuse) + SimTime::oneDay(); n <= fProdEnd; n += SimTime::oneDay() ){
         SimTime tn = mod_nn(d1Mod-n, N_v_length);
         ftauArray[n] = ftauArray[n-SimTime::oneDay()] * P_A[tn];
     }
-    ftauArray[fProdEnd] += P_df[mod_nn(d1Mod-fProdEnd, N_v_length)];
+    if( fReuse < fProdEnd )
+        ftauArray[fProdEnd] += P_df[mod_nn(d1Mod-fProdEnd, N_v_length)];
 
-    for( SimTime n = fProdEnd+SimTime::oneDay(); n < EIPDuration; n += SimTime::oneDay() ){
+    for( SimTime n = std::max(fProdEnd, fReuse) + SimTime::oneDay(); n < EIPDuration; n += SimTime::oneDay() ){
         SimTime tn = mod_nn(d1Mod-n, N_v_length);
         ftauArray[n] =
             P_df[tn] * ftauArray[n - mosqRestDuration]
             + P_A[tn] * ftauArray[n-SimTime::oneDay()];
     }
+    //END cache calculation: fArray, ftauArray
     
-    for( SimTime d = SimTime::oneDay(); d < N_v_length; d += SimTime::oneDay() ){
-        SimTime t = mod_nn(d1Mod - d, N_v_length);
-        double sum = N_v[t];
-        for( size_t i = 0; i < Genotypes::N(); ++i ) sum -= O_v.at(t,i);
-        uninfected_v[d] = sum;
+    // Per-genotype values for a given day are contiguous, so below all
+    // genotype loops are innermost and work on whole rows.
+    const double P_A_t0 = P_A[t0];
+    const double P_df_ttau = P_df[ttau];
+    
+    // Num infected seeking mosquitoes is the new ones (those who were
+    // uninfected tau days ago, started a feeding cycle then, survived and
+    // got infected) + those who didn't find a host yesterday + those who
+    // found a host tau days ago and survived a feeding cycle.
+    {
+        const double uninf_ttau = uninfected_v[ttau];
+        const double *P_dif_ttau = &P_dif.at(ttau, 0);
+        const double *O_v_t0 = &O_v.at(t0, 0);
+        const double *O_v_ttau = &O_v.at(ttau, 0);
+        double *O_v_t1 = &O_v.at(t1, 0);
+        for( size_t genotype = 0; genotype < nGenotypes; ++genotype ){
+            O_v_t1[genotype] = P_dif_ttau[genotype] * uninf_ttau
+                        + P_A_t0  * O_v_t0[genotype]
+                        + P_df_ttau * O_v_ttau[genotype];
+        }
     }
-    //END cache calculation: fArray, ftauArray, uninfected_v
-
-    double total_S_v = 0.0;
-    for( size_t genotype = 0; genotype < Genotypes::N(); ++genotype ){
-        // Num infected seeking mosquitoes is the new ones (those who were
-        // uninfected tau days ago, started a feeding cycle then, survived and
-        // got infected) + those who didn't find a host yesterday + those who
-        // found a host tau days ago and survived a feeding cycle.
-        O_v.at(t1,genotype) = P_dif.at(ttau,genotype) * uninfected_v[mosqRestDuration]
-                    + P_A[t0]  * O_v.at(t0,genotype)
-                    + P_df[ttau] * O_v.at(ttau,genotype);
-        //BEGIN S_v
-        double sum = 0.0;
-        const SimTime ts = d1Mod - EIPDuration;
-        for( SimTime l = SimTime::oneDay(); l < mosqRestDuration; l += SimTime::oneDay() ){
-            const SimTime tsl = mod_nn(ts - l, N_v_length); // index d1Mod - theta_s - l
-            sum += P_dif.at(tsl,genotype) * P_df[ttau] * (uninfected_v[EIPDuration+l]) *
-                    ftauArray[EIPDuration+l-mosqRestDuration];
+    
+    //BEGIN S_v
+    const SimTime ts = d1Mod - EIPDuration;
+    S_v_sum.assign( nGenotypes, 0.0 );
+    for( SimTime l = SimTime::oneDay(); l < mosqRestDuration; l += SimTime::oneDay() ){
+        const SimTime tsl = mod_nn(ts - l, N_v_length); // index d1Mod - theta_s - l
+        const double uninf_tsl = uninfected_v[tsl];
+        const double ftau = ftauArray[EIPDuration+l-mosqRestDuration];
+        const double *P_dif_tsl = &P_dif.at(tsl, 0);
+        for( size_t genotype = 0; genotype < nGenotypes; ++genotype ){
+            S_v_sum[genotype] += P_dif_tsl[genotype] * P_df_ttau * uninf_tsl * ftau;
         }
-        
-        const SimTime tsm = mod_nn(ts, N_v_length);       // index d1Mod - theta_s
-        S_v.at(t1,genotype) = P_dif.at(tsm,genotype) *
-                fArray[EIPDuration-mosqRestDuration] * (uninfected_v[EIPDuration])
-            + sum
-            + P_A[t0]*S_v.at(t0,genotype)
-            + P_df[ttau]*S_v.at(ttau,genotype);
+    }
+    
+    const SimTime tsm = mod_nn(ts, N_v_length);       // index d1Mod - theta_s
+    const double fA_end = fArray[EIPDuration-mosqRestDuration];
+    const double uninf_tsm = uninfected_v[tsm];
+    const double *P_dif_tsm = &P_dif.at(tsm, 0);
+    const double *S_v_t0 = &S_v.at(t0, 0);
+    const double *S_v_ttau = &S_v.at(ttau, 0);
+    double *S_v_t1 = &S_v.at(t1, 0);
+    double total_S_v = 0.0;
+    for( size_t genotype = 0; genotype < nGenotypes; ++genotype ){
+        S_v_t1[genotype] = P_dif_tsm[genotype] * fA_end * uninf_tsm
+            + S_v_sum[genotype]
+            + P_A_t0*S_v_t0[genotype]
+            + P_df_ttau*S_v_ttau[genotype];
 
         if( isDynamic ){
             // We cut-off transmission when no more than X mosquitos are infected to
             // allow true elimination in simulations. Unfortunately, it may cause problems with
             // trying to simulate extremely low transmission, such as an R_0 case.
-            if ( S_v.at(t1,genotype) <= minInfectedThreshold ) { // infectious mosquito cut-off
-                S_v.at(t1,genotype) = 0.0;
+            if ( S_v_t1[genotype] <= minInfectedThreshold ) { // infectious mosquito cut-off
+                S_v_t1[genotype] = 0.0;
                 /* Note: could report; these reports often occur too frequently, however
                 if( S_v[t1] != 0.0 ){        // potentially reduce reporting
             cerr << sim::ts0() <<":\t S_v cut-off"<<endl;
@@ -870,10 +967,10 @@ void AnophelesModel::update( SimTime d0, double tsP_A, double tsP_Amu, double ts
             }
         }
         
-        partialEIR[genotype] += S_v.at(t1, genotype) * EIR_factor;
-        total_S_v += S_v.at(t1, genotype);
-        //END S_v
+        partialEIR[genotype] += S_v_t1[genotype] * EIR_factor;
+        total_S_v += S_v_t1[genotype];
     }
+    //END S_v
 
             // We use time at end of step (i.e. start + 1) in index:
     SimTime d5Year = mod_nn(d1, SimTime::fromYearsI(5));
@@ -887,6 +984,12 @@ void AnophelesModel::update( SimTime d0, double tsP_A, double tsP_Amu, double ts
     // yesterday + those who found a host tau days ago and survived cycle:
     N_v[t1] = newAdults + P_A[t0]  * N_v[t0] + nOvipositing;
     
+    // Keep uninfected_v in step with N_v and O_v:
+    double uninf_t1 = N_v[t1];
+    for( size_t genotype = 0; genotype < nGenotypes; ++genotype )
+        uninf_t1 -= O_v.at(t1, genotype);
+    uninfected_v[t1] = uninf_t1;
+    
     timeStep_N_v0 += newAdults;
     
 //     if( printDebug ){
@@ -900,6 +1003,14 @@ void AnophelesModel::update( SimTime d0, double tsP_A, double tsP_Amu, double ts
 //     }
 }
 
+void AnophelesModel::calcUninfected_v(){
+    for( SimTime t = SimTime::zero(); t < N_v_length; t += SimTime::oneDay() ){
+        double sum = N_v[t];
+        for( size_t i = 0; i < Genotypes::N(); ++i ) sum -= O_v.at(t,i);
+        uninfected_v[t] = sum;
+    }
+}
+
 
 // -----  Summary and intervention functions  -----
 
@@ -907,6 +1018,7 @@ void AnophelesModel::uninfectVectors() {
     O_v.set_all( 0.0 );
     S_v.set_all( 0.0 );
     P_dif.set_all( 0.0 );
+    calcUninfected_v();
 }
 
 double sum1( const vecDay<double>& arr, SimTime end, SimTime N_v_length ){
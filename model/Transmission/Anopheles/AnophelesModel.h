@@ -37,6 +37,8 @@
 #include <vector>
 #include <limits>
 
+class UnittestUtil;
+
 namespace OM {
 namespace Transmission {
 namespace Anopheles {
@@ -99,7 +101,8 @@ public:
             EIPDuration(SimTime::zero()),
             N_v_length(SimTime::zero()),
             minInfectedThreshold( std::numeric_limits< double >::quiet_NaN() ),     // requires config
-            timeStep_N_v0(0.0)
+            timeStep_N_v0(0.0),
+            nDaysP_AStable(SimTime::zero())
     {
         forcedS_v.resize (SimTime::oneYear());
         quinquennialS_v.assign (SimTime::fromYearsI(5), 0.0);
@@ -133,6 +136,7 @@ public:
         vectors::scale (N_v, factor);
         vectors::scale (O_v, factor);
         vectors::scale (S_v, factor);
+        calcUninfected_v();
     }
     
     /** Initialisation which must wait until a human population is available.
@@ -167,6 +171,25 @@ public:
      *
      * @returns true if another iteration is needed. */
     virtual bool initIterate();
+    
+    /** Fit emergence without simulating humans (model option
+     * VECTOR_FAST_FITTING).
+     * 
+     * Inputs are per-time-step values (as passed to advancePeriod()) recorded
+     * over the year before sim::now(), indexed by day of year. The mosquito
+     * model alone is driven by these repeatedly, adjusting emergence via
+     * initIterate() after each run, until initIterate() reports the fit is
+     * good. The resulting state is that at sim::now().
+     * 
+     * Throws if this does not converge. */
+    void initFastFit( const vecDay<double>& sum_avail, const vecDay<double>& sigma_df,
+                      const vecDay2D<double>& sigma_dif, const vecDay<double>& sigma_dff );
+    
+    /** After initFastFit() and one year of the full simulation, check whether
+     * S_v over the last year is close enough to that required.
+     * 
+     * @returns true if the fit is good enough. */
+    bool initFastFitCheck() const;
 
     ///@brief Functions called as part of usual per-time-step operations
     //@{
@@ -229,7 +252,7 @@ public:
      * @param EIR_factor see parameter partialEIR
      */
     void update( SimTime d0, double tsP_A, double tsP_Amu, double tsP_A1, double tsP_Ah, double tsP_df,
-                   const vector<double> tsP_dif, double tsP_dff,
+                   const vector<double>& tsP_dif, double tsP_dff,
                    bool isDynamic,
                    vector<double>& partialEIR, double EIR_factor);
     
@@ -267,7 +290,11 @@ public:
     void summarize( size_t species )const;
     //@}
 
-    virtual void checkpoint (istream& stream){ (*this) & stream; }
+    virtual void checkpoint (istream& stream){
+        (*this) & stream;
+        // fArray and ftauArray are recalculated in full on the next update
+        nDaysP_AStable = SimTime::zero();
+    }
     virtual void checkpoint (ostream& stream){ (*this) & stream; }
 
 protected:
@@ -309,7 +336,7 @@ protected:
         P_Amu & stream;
         P_A1 & stream;
         P_Ah & stream;
-        //TODO: do we actually need to checkpoint these next three?
+        //TODO: do we actually need to checkpoint fArray and ftauArray?
         fArray & stream;
         ftauArray & stream;
         uninfected_v & stream;
@@ -349,6 +376,20 @@ protected:
     double calcEntoAvailability(double N_i, double P_A, double P_Ai);
     //@}
     
+    /** Recalculate uninfected_v at every index from N_v and O_v. Must be
+     * called whenever N_v or O_v are changed outside of update(). */
+    void calcUninfected_v();
+    
+    /** As the public version, but for the time step starting at ts0, which
+     * need not be sim::ts0(). */
+    void advancePeriod (SimTime ts0, double sum_avail, double sigma_df, vector<double>& sigma_dif, double sigma_dff, bool isDynamic);
+    
+    /** Relabel all state indexed by day after the model has been run for
+     * duration days beyond sim::now() (see initFastFit()), such that it
+     * represents the state at sim::now(). duration must be a whole number of
+     * years, so that seasonal state remains correct. */
+    virtual void rewind( SimTime duration );
+    
     
     // -----  parameters (constant after initialisation)  -----
     
@@ -632,18 +673,25 @@ protected:
     ///@brief Working memory
     /** Used for calculations within advancePeriod. Only saved for optimisation.
      *
-     * Used to calculate recursive functions f and f_τ in NDEMD eq 1.6, 1.7.
-     * Values are recalculated each step; only fArray[0] and
-     * ftauArray[0..mosqRestDuration] are stored across steps for optimisation
-     * (reallocating each time they are needed would be slow).
+     * fArray and ftauArray are used to calculate recursive functions f and
+     * f_τ in NDEMD eq 1.6, 1.7, indexed by the number of days back from the
+     * end of the current day. fArray[n] and ftauArray[n] only depend on P_A
+     * and P_df over the last n days, so when these were unchanged over the
+     * last n+1 days the values from the previous day are still correct and
+     * are not recalculated (see nDaysP_AStable). fArray[0] and
+     * ftauArray[0..mosqRestDuration] are constant.
      * 
-     * uninfected_v[0] is not used.
+     * uninfected_v is N_v minus the sum of O_v over all genotypes, indexed
+     * like N_v (i.e. (d-1) mod N_v_length for the state on day d). It is
+     * updated in update() whenever N_v and O_v are, so that days already
+     * calculated need not be summed again (see calcUninfected_v()).
      *
      * Length (fArray): EIPDuration - mosqRestDuration + 1 (θ_s - τ + 1)
      * Length (ftauArray): EIPDuration (θ_s)
      * Length (uninfected_v): N_v_length
      *
-     * Don't need to be checkpointed, but some values need to be initialised. */
+     * fArray and ftauArray don't need to be checkpointed, but some values
+     * need to be initialised. uninfected_v is checkpointed along with N_v. */
     //@{
     vecDay<double> fArray;
     vecDay<double> ftauArray;
@@ -652,6 +700,20 @@ protected:
     
     /** Variables tracking data to be reported. */
     double timeStep_N_v0;
+    
+    /** Number of consecutive days, up to the last day calculated by update(),
+     * on which P_A and P_df took the same values as on the day before (capped
+     * at EIPDuration). Leading entries of fArray and ftauArray up to this
+     * index are reused by update().
+     * 
+     * Not checkpointed: reset on load, forcing a full recalculation. */
+    SimTime nDaysP_AStable;
+    
+    /** Per-genotype sum used when calculating S_v in update(). Working memory
+     * only; not checkpointed. */
+    vector<double> S_v_sum;
+    
+    friend class ::UnittestUtil;
 };
 
 }
@@ -35,9 +35,15 @@ using util::LocalRng;
  * Parameters are read from XML, and the availability rate is adjusted. */
 class PerHostAnophParams {
 public:
+    /// Clear parameters of any previous simulation and reserve space
     static inline void initReserve (size_t numSpecies) {
+        params.clear ();
         params.reserve (numSpecies);
     }
+    /// Clear parameters (when the vector model is destroyed)
+    static inline void clear () {
+        params.clear ();
+    }
     static inline void init (const scnXml::Mosq& mosq) {
         params.push_back(PerHostAnophParams{ mosq });
     }
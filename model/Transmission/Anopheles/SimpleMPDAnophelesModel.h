@@ -171,6 +171,14 @@ public:
     virtual void checkpoint (istream& stream){ (*this) & stream; }
     virtual void checkpoint (ostream& stream){ (*this) & stream; }
 
+protected:
+    virtual void rewind( SimTime duration )
+    {
+        AnophelesModel::rewind( duration );
+        vectors::rotate( nOvipositingDelayed, duration );
+        vectors::rotate( quinquennialOvipositing, duration );
+    }
+
 private:
     template<class S>
     void operator& (S& stream) {
@@ -202,8 +202,10 @@ public:
         if (simulationMode == forcedEIR) { initialKappa[sim::ts1().moduloSteps(initialKappa.size())] = currentKappa; }
     }
 
-    virtual void calculateEIR(Host::Human &human, double ageYears, vector<double> &EIR) const
+    virtual void calculateEIR(Host::Human &human, double ageYears, WithinHost::GenotypeWeights &weights) const
     {
+        weights.bySource.clear();
+        vector<double> &EIR = weights.byGenotype;
         EIR.resize(1); // no support for per-genotype tracking in this model (possible, but we're lazy)
         // where the full model, with estimates of human mosquito transmission is in use, use this:
         if (simulationMode == forcedEIR) { EIR[0] = initialisationEIR[sim::ts0().moduloYearSteps()]; }
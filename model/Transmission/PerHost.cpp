@@ -33,6 +33,17 @@ using Anopheles::PerHostAnophParams;
 // -----  PerHost static  -----
 
 AgeGroupInterpolator PerHost::relAvailAge;
+int PerHost::nActiveHosts[3] = { 0, 0, 0 };
+
+// Bit index used in PerHost::activeTypes, or -1 for non-vector interventions
+inline int activeTypeBit( interventions::Component::Type type ){
+    switch( type ){
+        case interventions::Component::ITN: return 0;
+        case interventions::Component::IRS: return 1;
+        case interventions::Component::GVI: return 2;
+        default: return -1;
+    }
+}
 
 void PerHost::init ( const scnXml::AgeGroupValues& availabilityToMosquitoes ) {
     relAvailAge.set( availabilityToMosquitoes, "availabilityToMosquitoes" );
@@ -42,7 +53,8 @@ void PerHost::init ( const scnXml::AgeGroupValues& availabilityToMosquitoes ) {
 
 PerHost::PerHost () :
         outsideTransmission(false),
-        _relativeAvailabilityHet(numeric_limits<double>::signaling_NaN())
+        _relativeAvailabilityHet(numeric_limits<double>::signaling_NaN()),
+        activeTypes(0)
 {
 }
 void PerHost::initialise (LocalRng& rng, double availabilityFactor) {
@@ -54,9 +66,13 @@ void PerHost::initialise (LocalRng& rng, double availabilityFactor) {
 }
 
 void PerHost::update(Host::Human& human){
+    bool changed = false;
     for( auto iter = activeComponents.begin(); iter != activeComponents.end(); ++iter ){
+        bool wasDeployed = (*iter)->isDeployed();
         (*iter)->update(human);
+        changed |= wasDeployed != (*iter)->isDeployed();
     }
+    if( changed ) updateActiveTypes();
 }
 
 void PerHost::deployComponent( LocalRng& rng, const HumanVectorInterventionComponent& params ){
@@ -66,11 +82,13 @@ void PerHost::deployComponent( LocalRng& rng, const HumanVectorInterventionCompo
         if( (*iter)->id() == params.id() ){
             // already have a deployment for that description; just update it
             (*iter)->redeploy( rng, params );
+            updateActiveTypes();
             return;
         }
     }
     // no deployment for that description: must make a new one
     activeComponents.push_back( params.makeHumanPart(rng) );
+    updateActiveTypes();
 }
 
 
@@ -110,13 +128,47 @@ double PerHost::relMosqFecundity (size_t species) const {
 }
 
 bool PerHost::hasActiveInterv(interventions::Component::Type type) const{
+    int bit = activeTypeBit( type );
+    return bit >= 0 && (activeTypes & (1u << bit));
+}
+
+int PerHost::numActiveHosts( interventions::Component::Type type ){
+    int bit = activeTypeBit( type );
+    return bit >= 0 ? nActiveHosts[bit] : 0;
+}
+
+void PerHost::resetCounts(){
+    for( int bit = 0; bit < 3; ++bit ) nActiveHosts[bit] = 0;
+}
+
+void PerHost::updateActiveTypes(){
+    uint8_t types = 0;
     for( auto iter = activeComponents.begin(); iter != activeComponents.end(); ++iter ){
         if( (*iter)->isDeployed() ){
-            if( interventions::InterventionManager::getComponent( (*iter)->id() ).componentType() == type )
-                return true;
+            int bit = activeTypeBit( interventions::InterventionManager::getComponent( (*iter)->id() ).componentType() );
+            if( bit >= 0 ) types |= 1u << bit;
         }
     }
-    return false;
+    for( int bit = 0; bit < 3; ++bit ){
+        nActiveHosts[bit] += ((types >> bit) & 1) - ((activeTypes >> bit) & 1);
+    }
+    activeTypes = types;
+}
+
+void PerHost::removeFromCounts(){
+    for( int bit = 0; bit < 3; ++bit ){
+        nActiveHosts[bit] -= (activeTypes >> bit) & 1;
+    }
+    activeTypes = 0;
+}
+
+size_t PerHost::memoryUsage() const{
+    size_t bytes = speciesData.capacity() * sizeof(PerHostAnoph) +
+        activeComponents.capacity() * sizeof(unique_ptr<PerHostInterventionData>);
+    for( auto& component : activeComponents ){
+        bytes += component->memoryUsage();
+    }
+    return bytes;
 }
 
 void PerHost::checkpointIntervs( ostream& stream ){
@@ -145,6 +197,7 @@ void PerHost::checkpointIntervs( istream& stream ){
             throw util::checkpoint_error( "bad value in checkpoint file" );
         }
     }
+    updateActiveTypes();
 }
 
 }
@@ -27,6 +27,7 @@
 #include "util/AgeGroupInterpolation.h"
 #include "util/DecayFunction.h"
 #include "util/checkpoint_containers.h"
+#include "util/ObjectPool.h"
 
 namespace OM {
 namespace Transmission {
@@ -50,7 +51,7 @@ class HumanVectorInterventionComponent;
  * necessary, PerHost::deployComponent can be updated to make it create a new
  * instance instead of calling redeploy.
  */
-class PerHostInterventionData {
+class PerHostInterventionData : public util::PooledObject {
 public:
     virtual ~PerHostInterventionData() {}
     
@@ -76,6 +77,9 @@ public:
     /// Get the mosquito fecundity multiplier (1 for no effect).
     virtual double relFecundity(size_t species) const =0;
     
+    /// Approximate memory used by this object, in bytes
+    virtual size_t memoryUsage() const =0;
+    
     /// Index of effect describing the intervention
     inline interventions::ComponentId id() const { return m_id; }
     
@@ -252,6 +256,22 @@ public:
      * false). */
     bool hasActiveInterv( interventions::Component::Type type ) const;
     
+    /** Number of humans for which hasActiveInterv(type) is true. Maintained
+     * incrementally on deployment, expiry and removal of humans. */
+    static int numActiveHosts( interventions::Component::Type type );
+    
+    /** Zero the counts used by numActiveHosts(). Call before creating or
+     * loading the humans of a population. */
+    static void resetCounts();
+    
+    /** Call when the human is removed from the population, to update counts
+     * used by numActiveHosts(). */
+    void removeFromCounts();
+    
+    /** Approximate memory allocated by this object (not including
+     * sizeof(PerHost)), in bytes. */
+    size_t memoryUsage() const;
+    
     /// Checkpointing
     template<class S>
     void operator& (S& stream) {
@@ -266,7 +286,10 @@ private:
     void checkpointIntervs( ostream& stream );
     void checkpointIntervs( istream& stream );
     
-    vector<PerHostAnoph> speciesData;
+    /// Recalculate activeTypes and update nActiveHosts accordingly
+    void updateActiveTypes();
+    
+    util::PooledVector<PerHostAnoph> speciesData;
     
     // Determines whether human is outside transmission
     bool outsideTransmission;
@@ -275,9 +298,16 @@ private:
     // entoAvailability param stored in HostMosquitoInteraction.
     double _relativeAvailabilityHet;
 
-    vector<unique_ptr<PerHostInterventionData>> activeComponents;
+    util::PooledVector<unique_ptr<PerHostInterventionData>> activeComponents;
+    
+    // One bit per vector intervention type (ITN, IRS, GVI) with an active
+    // deployment in activeComponents. Not checkpointed (recalculated).
+    uint8_t activeTypes;
     
     static AgeGroupInterpolator relAvailAge;
+    
+    // Number of hosts with each bit of activeTypes set
+    static int nActiveHosts[3];
 };
 
 }
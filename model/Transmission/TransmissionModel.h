@@ -141,6 +141,10 @@ public:
      * information from the human population structure. */
     virtual void init2(const Population &population) = 0;
 
+    /** Re-seed any RNG seeded from the master RNG on construction. Call
+     * after re-seeding the master RNG, before the simulation starts. */
+    virtual void reseed( util::MasterRng& masterRng ) {}
+
     /** Set up vector population interventions. */
     virtual void initVectorInterv(const scnXml::Description::AnophelesSequence &list, size_t instance, const string &name) = 0;
 
@@ -251,21 +255,22 @@ public:
      *    The human's "per host transmission" potentially needs updating.
      * @param age Age of the human in time units
      * @param ageYears Age of the human in years
-     * @param EIR Out-vector of EIR per parasite genotype. The length is also set
-     *    by the called function. Where genotype tracking is not supported (e.g.
-     *    the non-vector model), the length is set to one.
+     * @param EIR Out: EIR per parasite genotype (EIR.byGenotype). The length is
+     *    also set by the called function. Where genotype tracking is not
+     *    supported (e.g. the non-vector model), the length is set to one.
+     *    EIR.bySource may also be set; see WithinHost::GenotypeWeights.
      * @returns the sum of EIR across genotypes
      */
-    double getEIR(Host::Human &human, SimTime age, double ageYears, vector<double> &EIR)
+    double getEIR(Host::Human &human, SimTime age, double ageYears, WithinHost::GenotypeWeights &EIR)
     {
         /* For the NonVector model, the EIR should just be multiplied by the
          * availability. For the Vector model, the availability is also required
          * for internal calculations, but again the EIR should be multiplied by the
          * availability. */
         calculateEIR(human, ageYears, EIR);
-        util::streamValidate(EIR);
+        util::streamValidate(EIR.byGenotype);
 
-        double allEIR = util::vectors::sum(EIR);
+        double allEIR = util::vectors::sum(EIR.byGenotype);
         if (age >= adultAge)
         {
             tsAdultEntoInocs += allEIR;
@@ -302,10 +307,11 @@ protected:
      *
      * @param host Transmission data for the human to calculate EIR for.
      * @param ageGroupData Age group of this host for availablility data.
-     * @param EIR Out-vector. Set to the age- and heterogeneity-specific EIR an
-     *    individual human is exposed to, per parasite genotype, in units of
-     *    inoculations per day. Length set by callee. */
-    virtual void calculateEIR(Host::Human &human, double ageYears, vector<double> &EIR) const = 0;
+     * @param EIR Out. byGenotype is set to the age- and heterogeneity-specific
+     *    EIR an individual human is exposed to, per parasite genotype, in units
+     *    of inoculations per day. Length set by callee. bySource is set or
+     *    cleared by the callee. */
+    virtual void calculateEIR(Host::Human &human, double ageYears, WithinHost::GenotypeWeights &EIR) const = 0;
 
     /** Needs to be called each time-step after Human::update() to update summary
      * statististics related to transmission. Also returns kappa (the average
@@ -28,9 +28,11 @@
 #include "util/ModelOptions.h"
 #include "util/SpeciesIndexChecker.h"
 #include "util/StreamValidator.h"
+#include "util/TaskPool.h"
 #include "Transmission/Anopheles/SimpleMPDAnophelesModel.h"
 
 #include <fstream>
+#include <functional>
 #include <map>
 #include <cmath>
 #include <set>
@@ -177,11 +179,16 @@ bool anophelesCompare(const scnXml::AnophelesParams& a1, const scnXml::Anopheles
     return (a1.getSeasonality().getAnnualEIR().get()>a2.getSeasonality().getAnnualEIR().get()); 
 }
 
+void VectorModel::reseed (util::MasterRng& masterRng){
+    m_rng = LocalRng( masterRng );
+}
+
 VectorModel::VectorModel (
                           const scnXml::Entomology& entoData,
-                          const scnXml::Vector vectorData, int populationSize) :
+                          const scnXml::Vector vectorData, int populationSize,
+                          util::MasterRng& masterRng) :
     TransmissionModel( entoData, WithinHost::Genotypes::N() ),
-    m_rng(util::master_RNG), initIterations(0)
+    m_rng(masterRng), initIterations(0)
 {
     // Each item in the AnophelesSequence represents an anopheles species.
     // TransmissionModel::createTransmissionModel checks length of list >= 1.
@@ -199,6 +206,7 @@ VectorModel::VectorModel (
     
     sort(anophelesList.begin(), anophelesList.end(), anophelesCompare);
 
+    speciesIndex.clear();
     PerHostAnophParams::initReserve (numSpecies);
     species.resize (numSpecies);
 
@@ -331,14 +339,20 @@ VectorModel::VectorModel (
         MakeDelegate( this, &VectorModel::ctsCbResRequirements ) );
 }
 VectorModel::~VectorModel () {
+    // Species are only valid for the lifetime of this model
+    speciesIndex.clear();
+    PerHostAnophParams::clear();
 }
 
 void VectorModel::init2 (const Population& population) {
-    SimTime data_save_len = SimTime::oneDay();  // we don't need to save anything at first
+    // We don't need to save anything at first, unless fast fitting which
+    // uses the last year of warm-up.
+    SimTime data_save_len = util::ModelOptions::option( util::VECTOR_FAST_FITTING ) ?
+            SimTime::oneYear() : SimTime::oneDay();
     saved_sum_avail.assign( data_save_len, speciesIndex.size(), 0.0 );
     saved_sigma_df.assign( data_save_len, speciesIndex.size(), 0.0 );
     saved_sigma_dif.assign( data_save_len, speciesIndex.size(), WithinHost::Genotypes::N(), 0.0 );
-    saved_sigma_dff.assign( speciesIndex.size(), 0.0 );
+    saved_sigma_dff.assign( data_save_len, speciesIndex.size(), 0.0 );
     
     double sumRelativeAvailability = 0.0;
     for(const Host::Human& human : population.getHumans()) {
@@ -467,6 +481,46 @@ SimTime VectorModel::initIterate () {
     
     // This function is called repeatedly until vector initialisation is
     // complete (signalled by returning 0).
+    if( initIterations == 0 && util::ModelOptions::option( util::VECTOR_FAST_FITTING ) ){
+        // Fit emergence using the last year of data, driving the mosquito
+        // model alone, then run one year of the full simulation to check.
+        // Species are independent here, so are fitted concurrently.
+        TaskPool::forEach( speciesIndex.size(), [&]( size_t s ){
+            vecDay<double> sum_avail( SimTime::oneYear() ), sigma_df( SimTime::oneYear() ),
+                sigma_dff( SimTime::oneYear() );
+            vecDay2D<double> sigma_dif( SimTime::oneYear(), WithinHost::Genotypes::N(), 0.0 );
+            for( SimTime d = SimTime::zero(); d < SimTime::oneYear(); d += SimTime::oneDay() ){
+                sum_avail[d] = saved_sum_avail.at(d, s);
+                sigma_df[d] = saved_sigma_df.at(d, s);
+                sigma_dff[d] = saved_sigma_dff.at(d, s);
+                for( size_t g = 0; g < sigma_dif.size2(); ++g )
+                    sigma_dif.at(d, g) = saved_sigma_dif.at(d, s, g);
+            }
+            species[s]->initFastFit( sum_avail, sigma_df, sigma_dif, sigma_dff );
+        } );
+        
+        SimTime data_save_len = SimTime::oneDay();
+        saved_sum_avail.assign( data_save_len, speciesIndex.size(), 0.0 );
+        saved_sigma_df.assign( data_save_len, speciesIndex.size(), 0.0 );
+        saved_sigma_dif.assign( data_save_len, speciesIndex.size(), WithinHost::Genotypes::N(), 0.0 );
+        saved_sigma_dff.assign( data_save_len, speciesIndex.size(), 0.0 );
+        initIterations = -2;
+        return SimTime::oneYear();
+    } else if( initIterations == -2 ){
+        bool fitted = true;
+        for(size_t i = 0; i < speciesIndex.size(); ++i) {
+            fitted = fitted && species[i]->initFastFitCheck ();
+        }
+        if( fitted ){
+            initIterations = -1;        // done; fall through to clean up
+        } else {
+            // Fall back to the usual iterative method, starting with five
+            // years of data collection:
+            initIterations = 1;
+            return SimTime::fromYearsI(5);
+        }
+    }
+    
     int initState = 0;
     if( initIterations == 0 && saved_sum_avail.size1() == SimTime::oneDay() ) {
         // First time called: we need to do some data collection
@@ -486,6 +540,7 @@ SimTime VectorModel::initIterate () {
         saved_sum_avail.assign( data_save_len, speciesIndex.size(), 0.0 );
         saved_sigma_df.assign( data_save_len, speciesIndex.size(), 0.0 );
         saved_sigma_dif.assign( data_save_len, speciesIndex.size(), WithinHost::Genotypes::N(), 0.0 );
+        saved_sigma_dff.assign( data_save_len, speciesIndex.size(), 0.0 );
         
         if( initState == 3 ){
             //TODO: we should perhaps check that EIR gets reproduced correctly?
@@ -515,8 +570,9 @@ SimTime VectorModel::initIterate () {
 }
 
 void VectorModel::calculateEIR(Host::Human& human, double ageYears,
-        vector<double>& EIR) const
+        WithinHost::GenotypeWeights& weights) const
 {
+    vector<double>& EIR = weights.byGenotype;
     auto ag = human.monAgeGroup().i();
     auto cs = human.cohortSet();
     PerHost& host = human.perHostTransmission;
@@ -526,9 +582,14 @@ void VectorModel::calculateEIR(Host::Human& human, double ageYears,
                 host.relativeAvailabilityHetAge (ageYears);
         mon::reportStatMACGF( mon::MVF_INOCS, ag, cs, 0, eir );
         EIR.assign( 1, eir );
+        weights.bySource.clear();
     }else{
         assert( simulationMode == dynamicEIR );
         EIR.assign( WithinHost::Genotypes::N(), 0.0 );
+        // Per-species factors let Genotypes sample from per-species tables
+        const bool bySource = WithinHost::Genotypes::N() > 1 &&
+                util::ModelOptions::option( util::GENOTYPE_ALIAS_SAMPLING );
+        weights.bySource.resize( bySource ? speciesIndex.size() : 0 );
         const double ageFactor = host.relativeAvailabilityAge (ageYears);
         for(size_t i = 0; i < speciesIndex.size(); ++i) {
             const vector<double>& partialEIR = species[i]->getPartialEIR();
@@ -542,6 +603,7 @@ void VectorModel::calculateEIR(Host::Human& human, double ageYears,
              *
              * See comment in AnophelesModel::advancePeriod for method. */
             double entoFactor = ageFactor * host.availBite(i);
+            if( bySource ) weights.bySource[i] = entoFactor;
             for( size_t g = 0; g < EIR.size(); ++g ){
                 auto eir = partialEIR[g] * entoFactor;
                 mon::reportStatMACSGF( mon::MVF_INOCS, ag, cs, i, g, eir );
@@ -556,26 +618,21 @@ void VectorModel::calculateEIR(Host::Human& human, double ageYears,
 void VectorModel::vectorUpdate (const Population& population) {
     const size_t nGenotypes = WithinHost::Genotypes::N();
     SimTime popDataInd = mod_nn(sim::ts0(), saved_sum_avail.size1());
-    vector<double> probTransmission;
     saved_sum_avail.assign_at1(popDataInd, 0.0);
     saved_sigma_df.assign_at1(popDataInd, 0.0);
     saved_sigma_dif.assign_at1(popDataInd, 0.0);
-    saved_sigma_dff.assign( saved_sigma_dff.size(), 0.0 );
+    saved_sigma_dff.assign_at1(popDataInd, 0.0);
     
+    // Genotypes not listed in probTransmission have zero probability of transmission
     for(const Host::Human& human : population.getHumans()) {
         const OM::Transmission::PerHost& host = human.perHostTransmission;
         WithinHost::WHInterface& whm = *human.withinHostModel;
         const double tbvFac = human.getVaccine().getFactor( interventions::Vaccine::TBV );
         
-        probTransmission.assign( nGenotypes, 0.0 );
         double sumX = numeric_limits<double>::quiet_NaN();
         const double pTrans = whm.probTransmissionToMosquito( tbvFac, &sumX );
-        if( nGenotypes == 1 ) probTransmission[0] = pTrans;
-        else for( size_t g = 0; g < nGenotypes; ++g ){
-            const double k = whm.probTransGenotype( pTrans, sumX, g );
-            assert( (std::isfinite)(k) );
-            probTransmission[g] = k;
-        }
+        if( nGenotypes == 1 ) probTransmission.assign( 1, make_pair( 0u, pTrans ) );
+        else whm.probTransGenotypes( pTrans, sumX, probTransmission );
         
         for(size_t s = 0; s < speciesIndex.size(); ++s){
             //NOTE: calculate availability relative to age at end of time step;
@@ -587,24 +644,38 @@ void VectorModel::vectorUpdate (const Population& population) {
                     * host.probMosqBiting(s)
                     * host.probMosqResting(s);
             saved_sigma_df.at(popDataInd, s) += df;
-            for( size_t g = 0; g < nGenotypes; ++g ){
-                saved_sigma_dif.at(popDataInd, s, g) += df * probTransmission[g];
+            for( const auto& gp : probTransmission ){
+                assert( (std::isfinite)(gp.second) );
+                saved_sigma_dif.at(popDataInd, s, gp.first) += df * gp.second;
             }
-            saved_sigma_dff[s] += df * host.relMosqFecundity(s);
+            saved_sigma_dff.at(popDataInd, s) += df * host.relMosqFecundity(s);
         }
     }
     
-    for(size_t s = 0; s < speciesIndex.size(); ++s){
+    // Species only share read-only data from here, so may be updated
+    // concurrently. Each keeps its own partialEIR, which calculateEIR()
+    // combines in species order.
+    const bool genotypeTables = nGenotypes > 1 &&
+            util::ModelOptions::option( util::GENOTYPE_ALIAS_SAMPLING );
+    if( genotypeTables ) WithinHost::Genotypes::setNumSources( speciesIndex.size() );
+    sigma_dif_species.resize( speciesIndex.size() );
+    auto advanceSpecies = [&]( size_t s ){
         // Copy slice to new array:
         auto range = saved_sigma_dif.range_at12(popDataInd, s);
-        sigma_dif_species.assign(range.first, range.second);
+        sigma_dif_species[s].assign(range.first, range.second);
         
         species[s]->advancePeriod (saved_sum_avail.at(popDataInd, s),
                 saved_sigma_df.at(popDataInd, s),
-                sigma_dif_species,
-                saved_sigma_dff[s],
+                sigma_dif_species[s],
+                saved_sigma_dff.at(popDataInd, s),
                 simulationMode == dynamicEIR);
-    }
+        if( genotypeTables ){
+            WithinHost::Genotypes::setSourceWeights( s, species[s]->getPartialEIR() );
+        }
+    };
+    // Pass by reference: a std::function holding the closure itself would be
+    // allocated on the heap each step.
+    TaskPool::forEach( speciesIndex.size(), std::ref( advanceSpecies ) );
 }
 void VectorModel::update(const Population& population) {
     TransmissionModel::updateKappa(population);
@@ -25,6 +25,7 @@
 #include "Transmission/TransmissionModel.h"
 #include "Transmission/Anopheles/AnophelesModel.h"
 
+class UnittestUtil;
 namespace scnXml {
   class Vector;
 }
@@ -42,12 +43,14 @@ public:
   /// Get the map of species names to indicies.
   static const map<string,size_t>& getSpeciesIndexMap();
 
-  VectorModel(const scnXml::Entomology& entoData, const scnXml::Vector vectorData, int populationSize);
+  VectorModel(const scnXml::Entomology& entoData, const scnXml::Vector vectorData, int populationSize,
+          util::MasterRng& masterRng);
   virtual ~VectorModel();
   
   /** Extra initialisation when not loading from a checkpoint, requiring
    * information from the human population structure. */
   virtual void init2 (const Population& population);
+  virtual void reseed (util::MasterRng& masterRng);
   
   virtual void initVectorInterv( const scnXml::Description::AnophelesSequence& list,
         size_t instance, const string& name );
@@ -69,7 +72,7 @@ public:
   virtual void update (const Population& population);
 
   virtual void calculateEIR( Host::Human& human, double ageYears,
-        vector<double>& EIR ) const;
+        WithinHost::GenotypeWeights& EIR ) const;
   
   virtual void deployVectorPopInterv (size_t instance);
   virtual void deployVectorTrap( size_t instance, double popSize, SimTime lifespan );
@@ -109,8 +112,9 @@ private:
   
     /// Number of iterations performed during initialization.
     /// 
-    /// Special cases: 0 during initial one-human-lifespan warmup, <0 after
-    /// initialisation.
+    /// Special cases: 0 during initial one-human-lifespan warmup, -1 after
+    /// initialisation, -2 while checking the result of fast fitting
+    /// (VECTOR_FAST_FITTING).
     int initIterations;
     
   /** @brief Access to per (anopheles) species data.
@@ -124,19 +128,28 @@ private:
   vector<std::unique_ptr<Anopheles::AnophelesModel>> species;
   //@}
   
-  /// @brief Saved data for use in initialisation / fitting cycle
+  /** @brief Saved data for use in initialisation / fitting cycle
+   *
+   * Indexed by time modulo length, then species (then genotype). Usually only
+   * one day is kept; with VECTOR_FAST_FITTING the last year of warm-up is
+   * kept to drive AnophelesModel::initFastFit(). */
   //@{
     util::vecDay2D<double> saved_sum_avail;
     util::vecDay2D<double> saved_sigma_df;
     util::vecDay3D<double> saved_sigma_dif;
-    vector<double> saved_sigma_dff;
+    util::vecDay2D<double> saved_sigma_dff;
   //@}
     
-    // Cache; no need to checkpoint
-    vector<double> sigma_dif_species;
+    // Cache, per species; no need to checkpoint
+    vector<vector<double>> sigma_dif_species;
+    
+    // Sparse (genotype, probability) pairs of the current human, set in
+    // vectorUpdate(); kept so that its capacity is re-used. No need to checkpoint.
+    vector<pair<uint32_t,double>> probTransmission;
   
   friend class PerHost;
   friend class AnophelesModelSuite;
+  friend class ::UnittestUtil;
 };
 
 } }
@@ -32,7 +32,8 @@ namespace Transmission
 ///@brief Creation, destruction and checkpointing
 //@{
 /// Creates a derived class
-static TransmissionModel *createTransmissionModel(const scnXml::Entomology &entoData, int populationSize)
+static TransmissionModel *createTransmissionModel(const scnXml::Entomology &entoData, int populationSize,
+        util::MasterRng &masterRng)
 {
   // Entomology contains either a list of at least one anopheles or a list of at
   // least one EIRDaily.
@@ -40,7 +41,7 @@ static TransmissionModel *createTransmissionModel(const scnXml::Entomology &ento
 
   TransmissionModel *model;
   if (vectorData.present())
-    model = new VectorModel(entoData, vectorData.get(), populationSize);
+    model = new VectorModel(entoData, vectorData.get(), populationSize, masterRng);
   else {
       const scnXml::Entomology::NonVectorOptional& nonVectorData = entoData.getNonVector();
     if (!nonVectorData.present())       // should be a validation error, but anyway...
@@ -43,6 +43,8 @@ util::AgeGroupInterpolator massByAge;
 
 bool reportInfectedOrPatentInfected = false;
 
+bool CommonWithinHost::skipQuietDays = true;
+
 
 // -----  Initialization  -----
 
@@ -79,6 +81,8 @@ CommonWithinHost::CommonWithinHost( LocalRng& rng, double comorbidityFactor ) :
         ++counter;
 #endif
     } while( hetMassMultiplier < minHetMassMult );
+    
+    if( !leanMemory ) pkpdModel.reset( new PkPd::LSTMModel() );
 }
 
 CommonWithinHost::~CommonWithinHost() {
@@ -109,7 +113,8 @@ void CommonWithinHost::clearInfections( Treatments::Stages stage ){
 
 void CommonWithinHost::treatPkPd(size_t schedule, size_t dosage, double age, double delay_d){
     double mass = massByAge.eval( age ) * hetMassMultiplier;
-    pkpdModel.prescribe( schedule, dosage, age, mass, delay_d );
+    if( !pkpdModel ) pkpdModel.reset( new PkPd::LSTMModel() );
+    pkpdModel->prescribe( schedule, dosage, age, mass, delay_d );
 }
 void CommonWithinHost::clearImmunity() {
     for(auto inf = infections.begin(); inf != infections.end(); ++inf) {
@@ -124,7 +129,7 @@ void CommonWithinHost::importInfection(LocalRng& rng){
         numInfs += 1;
         // This is a hook, used by interventions. The newly imported infections
         // should use initial frequencies to select genotypes.
-        vector<double> weights( 0 );        // zero length: signal to use initial frequencies
+        GenotypeWeights weights;        // empty: signal to use initial frequencies
         uint32_t genotype = Genotypes::sampleGenotype(rng, weights);
         infections.push_back(createInfection(rng, genotype));
     }
@@ -135,7 +140,7 @@ void CommonWithinHost::importInfection(LocalRng& rng){
 // -----  Density calculations  -----
 
 void CommonWithinHost::update(LocalRng& rng,
-        int nNewInfs, vector<double>& genotype_weights,
+        int nNewInfs, GenotypeWeights& genotype_weights,
         double ageInYears, double bsvFactor)
 {
     // Note: adding infections at the beginning of the update instead of the end
@@ -161,9 +166,35 @@ void CommonWithinHost::update(LocalRng& rng,
     
     double body_mass = massByAge.eval( ageInYears ) * hetMassMultiplier;
     
-    for( SimTime now = sim::ts0(), end = sim::ts0() + SimTime::oneTS(); now < end; now += SimTime::oneDay() ){
+    // Hosts are only stepped daily while they need it. On days before
+    // quietEnd the host has no drugs (or pending doses), no simple treatment
+    // and only liver-stage infections, so updates would change nothing (and
+    // use no random numbers); only densities are summed on these days.
+    const SimTime end = sim::ts0() + SimTime::oneTS();
+    SimTime quietEnd = sim::ts0();
+    if( skipQuietDays && !treatmentLiver && !treatmentBlood &&
+        (!pkpdModel || pkpdModel->empty()) ){
+        quietEnd = end;
+        for( CommonInfection *inf : infections ){
+            quietEnd = min( quietEnd, inf->bloodStageStart() );
+        }
+    }
+    
+    for( SimTime now = sim::ts0(); now < end; now += SimTime::oneDay() ){
+        if( now < quietEnd ){
+            for( CommonInfection *inf : infections ){
+                double density = inf->getDensity();
+                totalDensity += density;
+                if( !inf->isHrp2Deficient() ){
+                    hrp2Density += density;
+                }
+                timeStepMaxDensity = max(timeStepMaxDensity, density);
+            }
+            continue;
+        }
+        
         // every day, medicate drugs, update each infection, then decay drugs
-        pkpdModel.medicate(rng);
+        if( pkpdModel ) pkpdModel->medicate(rng);
         
         double sumLogDens = 0.0;
         
@@ -172,7 +203,8 @@ void CommonWithinHost::update(LocalRng& rng,
             bool expires = ((*inf)->bloodStage() ? treatmentBlood : treatmentLiver);
             
             if( !expires ){     /* no expiry due to simple treatment model; do update */
-                const double drugFactor = pkpdModel.getDrugFactor(rng, *inf, body_mass);
+                const double drugFactor = pkpdModel ?
+                    pkpdModel->getDrugFactor(rng, *inf, body_mass) : 1.0;
                 const double immFactor = immunitySurvivalFactor(ageInYears, (*inf)->cumulativeExposureJ());
                 const double survivalFactor = survivalFactor_part * immFactor * drugFactor;
                 // update, may result in termination of infection:
@@ -197,8 +229,9 @@ void CommonWithinHost::update(LocalRng& rng,
                 ++inf;
             }
         }
-        pkpdModel.decayDrugs (body_mass);
+        if( pkpdModel ) pkpdModel->decayDrugs (body_mass);
     }
+    if( leanMemory && pkpdModel && pkpdModel->empty() ) pkpdModel.reset();
     
     // As in AJTMH p22, cumulative_h (X_h + 1) doesn't include infections added
     // this time-step and cumulative_Y only includes past densities, thus we
@@ -212,10 +245,11 @@ void CommonWithinHost::update(LocalRng& rng,
     
     // Cache total density for infectiousness calculations
     int y_lag_i = sim::ts1().moduloSteps(y_lag_len);
-    for( size_t g = 0; g < Genotypes::N(); ++g ) m_y_lag.at(y_lag_i, g) = 0.0;
+    if( !resetYLag( y_lag_i, !infections.empty() ) ) return;
     for( auto inf = infections.begin(); inf != infections.end(); ++inf ){
-        m_y_lag.at( y_lag_i, (*inf)->genotype() ) += (*inf)->getDensity();
+        addYLag( y_lag_i, (*inf)->genotype(), (*inf)->getDensity() );
     }
+    finishYLag( y_lag_i );
 }
 
 void CommonWithinHost::addProphylacticEffects(const vector<double>& pClearanceByTime) {
@@ -236,7 +270,7 @@ struct InfGenotypeSorter {
 
 bool CommonWithinHost::summarize( Host::Human& human )const{
     pathogenesisModel->summarize( human );
-    pkpdModel.summarize( human );
+    if( pkpdModel ) pkpdModel->summarize( human );
     
     if( infections.size() > 0 ){
         mon::reportStatMHI( mon::MHR_INFECTED_HOSTS, human, 1 );
@@ -280,17 +314,32 @@ bool CommonWithinHost::summarize( Host::Human& human )const{
     // totalDensity > 0. Here we report the last calculated density.
     if( diagnostics::monitoringDiagnostic().isPositive(human.rng(), totalDensity, std::numeric_limits<double>::quiet_NaN()) ){
         mon::reportStatMHI( mon::MHR_PATENT_HOSTS, human, 1 );
-        mon::reportStatMHF( mon::MHF_LOG_DENSITY, human, log(totalDensity) );
+        if( mon::isUsedM( mon::MHF_LOG_DENSITY ) ){
+            mon::reportStatMHF( mon::MHF_LOG_DENSITY, human, log(totalDensity) );
+        }
         return true;    // patent
     }
     return false;       // not patent
 }
 
 
+void CommonWithinHost::memoryUsage( util::MemoryUsage& usage ) const{
+    WHFalciparum::memoryUsage( usage );
+    // infections are counted at their base size; list nodes hold a pointer
+    // plus two links
+    usage.withinHost += sizeof(*this) +
+        infections.size() * (sizeof(CommonInfection) + 3 * sizeof(void*));
+    if( pkpdModel ) usage.pkpd += pkpdModel->memoryUsage();
+}
+
+
 void CommonWithinHost::checkpoint (istream& stream) {
     WHFalciparum::checkpoint (stream);
     hetMassMultiplier & stream;
-    pkpdModel & stream;
+    bool havePkPd;
+    havePkPd & stream;
+    if( havePkPd || !leanMemory ) pkpdModel.reset( new PkPd::LSTMModel() );
+    if( havePkPd ) (*pkpdModel) & stream;
     for(int i = 0; i < numInfs; ++i) {
         infections.push_back (checkpointedInfection (stream));
     }
@@ -300,7 +349,9 @@ void CommonWithinHost::checkpoint (istream& stream) {
 void CommonWithinHost::checkpoint (ostream& stream) {
     WHFalciparum::checkpoint (stream);
     hetMassMultiplier & stream;
-    pkpdModel & stream;
+    bool havePkPd = pkpdModel != nullptr;
+    havePkPd & stream;
+    if( havePkPd ) (*pkpdModel) & stream;
     for(auto inf = infections.begin(); inf != infections.end(); ++inf) {
         (**inf) & stream;
     }
@@ -28,6 +28,8 @@
 
 using namespace std;
 
+class UnittestUtil;
+
 namespace OM { namespace WithinHost {
     
 /** Common within-host model functionality.
@@ -50,7 +52,7 @@ public:
     virtual void treatPkPd(size_t schedule, size_t dosage, double age, double delay_d);
     virtual void clearImmunity();
     
-    virtual void update (LocalRng& rng, int nNewInfs, vector<double>& genotype_weights,
+    virtual void update (LocalRng& rng, int nNewInfs, GenotypeWeights& genotype_weights,
             double ageInYears, double bsvFactor);
     
     virtual void addProphylacticEffects(const vector<double>& pClearanceByTime);
@@ -68,6 +70,8 @@ public:
     
     virtual bool summarize( Host::Human& human )const;
     
+    virtual void memoryUsage( util::MemoryUsage& usage ) const;
+    
 protected:
     virtual void clearInfections( Treatments::Stages stage );
     
@@ -78,15 +82,24 @@ private:
     /// Multiplies the mean mass (for this age) as a heterogeneity factor.
     double hetMassMultiplier;
     
-    /// Encapsulates drug code for each human
-    PkPd::LSTMModel pkpdModel;
+    /** Encapsulates drug code for each human.
+     * 
+     * In lean memory mode this is null while the human has no drugs (an
+     * empty model has no effect), otherwise it is always allocated. */
+    unique_ptr<PkPd::LSTMModel> pkpdModel;
     
     /** The list of all infections this human has.
      *
      * Since infection models and within host models are very much intertwined,
      * the idea is that each WithinHostModel has its own list of infections. */
     //TODO: better to template class over infection type than use dynamic type?
-    std::list<CommonInfection*> infections;
+    util::PooledList<CommonInfection*> infections;
+    
+    /// Whether update() skips the updates of quiet days (see there). Only
+    /// unit tests turn this off, to check skipping does not change results.
+    static bool skipQuietDays;
+    
+    friend class ::UnittestUtil;
 };
 
 } }
@@ -28,6 +28,7 @@
 #include "util/StreamValidator.h"
 #include "util/errors.h"
 #include <cassert>
+#include <algorithm>
 
 using namespace std;
 
@@ -59,16 +60,13 @@ void DescriptiveWithinHostModel::loadInfection(istream& stream) {
 }
 
 void DescriptiveWithinHostModel::clearInfections( Treatments::Stages stage ){
-    for(auto inf = infections.begin(); inf != infections.end();) {
-        if( stage == Treatments::BOTH ||
-            (stage == Treatments::LIVER && !inf->bloodStage()) ||
-            (stage == Treatments::BLOOD && inf->bloodStage())
-        ){
-            inf = infections.erase( inf );
-        }else{
-            ++inf;
-        }
-    }
+    auto cleared = [stage]( const DescriptiveInfection& inf ){
+        return stage == Treatments::BOTH ||
+            (stage == Treatments::LIVER && !inf.bloodStage()) ||
+            (stage == Treatments::BLOOD && inf.bloodStage());
+    };
+    infections.erase( remove_if( infections.begin(), infections.end(), cleared ),
+            infections.end() );
     numInfs = infections.size();
 }
 
@@ -87,7 +85,7 @@ void DescriptiveWithinHostModel::importInfection(LocalRng& rng){
         numInfs += 1;
         // This is a hook, used by interventions. The newly imported infections
         // should use initial frequencies to select genotypes.
-        vector<double> weights( 0 );        // zero length: signal to use initial frequencies
+        GenotypeWeights weights;        // empty: signal to use initial frequencies
         uint32_t genotype = Genotypes::sampleGenotype(rng, weights);
         infections.push_back(DescriptiveInfection(rng, genotype));
     }
@@ -98,7 +96,7 @@ void DescriptiveWithinHostModel::importInfection(LocalRng& rng){
 // -----  Density calculations  -----
 
 void DescriptiveWithinHostModel::update(LocalRng& rng,
-        int nNewInfs, vector<double>& genotype_weights,
+        int nNewInfs, GenotypeWeights& genotype_weights,
         double ageInYears, double bsvFactor)
 {
     // Note: adding infections at the beginning of the update instead of the end
@@ -121,7 +119,10 @@ void DescriptiveWithinHostModel::update(LocalRng& rng,
     bool treatmentLiver = treatExpiryLiver > sim::ts0();
     bool treatmentBlood = treatExpiryBlood > sim::ts0();
     
-    for(auto inf = infections.begin(); inf != infections.end();) {
+    // Infections which end are removed by moving those remaining forward
+    size_t nRemaining = 0;
+    for( size_t i = 0; i < infections.size(); ++i ){
+        DescriptiveInfection *inf = &infections[i];
         //NOTE: it would be nice to combine this code with that in
         // CommonWithinHost.cpp, but a few changes would be needed:
         // INNATE_MAX_DENS and MAX_DENS_CORRECTION would need to be required
@@ -132,7 +133,6 @@ void DescriptiveWithinHostModel::update(LocalRng& rng,
         if ( inf->expired() /* infection has self-terminated */ ||
             (inf->bloodStage() ? treatmentBlood : treatmentLiver) )
         {
-            inf=infections.erase(inf);
             numInfs--;
             continue;
         }
@@ -153,8 +153,10 @@ void DescriptiveWithinHostModel::update(LocalRng& rng,
             hrp2Density += density;
         }
 
-        ++inf;
+        if( nRemaining != i ) infections[nRemaining] = std::move( *inf );
+        ++nRemaining;
     }
+    infections.erase( infections.begin() + nRemaining, infections.end() );
     
     // As in AJTMH p22, cumulative_h (X_h + 1) doesn't include infections added
     // this time-step and cumulative_Y only includes past densities.
@@ -167,10 +169,11 @@ void DescriptiveWithinHostModel::update(LocalRng& rng,
     
     // Cache total density for infectiousness calculations
     int y_lag_i = sim::ts1().moduloSteps(y_lag_len);
-    for( size_t g = 0; g < Genotypes::N(); ++g ) m_y_lag.at(y_lag_i, g) = 0.0;
+    if( !resetYLag( y_lag_i, !infections.empty() ) ) return;
     for( auto inf = infections.begin(); inf != infections.end(); ++inf ){
-        m_y_lag.at( y_lag_i, inf->genotype() ) += inf->getDensity();
+        addYLag( y_lag_i, inf->genotype(), inf->getDensity() );
     }
+    finishYLag( y_lag_i );
 }
 
 
@@ -185,9 +188,8 @@ bool DescriptiveWithinHostModel::summarize( Host::Human& human )const{
         // genotype in this model
         mon::reportStatMHGI( mon::MHR_INFECTIONS, human, 0, infections.size() );
         if( reportPatentInfected ){
-            for(std::list<DescriptiveInfection>::const_iterator inf =
-                infections.begin(); inf != infections.end(); ++inf) {
-            if( diagnostics::monitoringDiagnostic().isPositive( human.rng(), inf->getDensity(), std::numeric_limits<double>::quiet_NaN() ) ){
+            for( const DescriptiveInfection& inf : infections ){
+            if( diagnostics::monitoringDiagnostic().isPositive( human.rng(), inf.getDensity(), std::numeric_limits<double>::quiet_NaN() ) ){
                     mon::reportStatMHGI( mon::MHR_PATENT_INFECTIONS, human, 0, 1 );
                 }
             }
@@ -215,17 +217,27 @@ bool DescriptiveWithinHostModel::summarize( Host::Human& human )const{
     // totalDensity > 0. Here we report the last calculated density.
     if( diagnostics::monitoringDiagnostic().isPositive(human.rng(), totalDensity, std::numeric_limits<double>::quiet_NaN()) ){
         mon::reportStatMHI( mon::MHR_PATENT_HOSTS, human, 1 );
-        mon::reportStatMHF( mon::MHF_LOG_DENSITY, human, log(totalDensity) );
+        if( mon::isUsedM( mon::MHF_LOG_DENSITY ) ){
+            mon::reportStatMHF( mon::MHF_LOG_DENSITY, human, log(totalDensity) );
+        }
         return true;    // patent
     }
     return false;       // not patent
 }
 
 
+void DescriptiveWithinHostModel::memoryUsage( util::MemoryUsage& usage ) const{
+    WHFalciparum::memoryUsage( usage );
+    usage.withinHost += sizeof(*this) +
+        infections.capacity() * sizeof(DescriptiveInfection);
+}
+
+
 // -----  Data checkpointing  -----
 
 void DescriptiveWithinHostModel::checkpoint (istream& stream) {
     WHFalciparum::checkpoint (stream);
+    infections.reserve( numInfs );
     for(int i=0; i<numInfs; ++i) {
         loadInfection(stream);  // create infections using a virtual function call
     }
@@ -48,11 +48,13 @@ public:
     virtual void loadInfection(istream& stream);
     virtual void clearImmunity();
     
-    virtual void update(LocalRng& rng, int nNewInfs, vector<double>& genotype_weights,
+    virtual void update(LocalRng& rng, int nNewInfs, GenotypeWeights& genotype_weights,
             double ageInYears, double bsvFactor);
     
     virtual bool summarize( Host::Human& human )const;
     
+    virtual void memoryUsage( util::MemoryUsage& usage ) const;
+    
 protected:
     virtual void clearInfections( Treatments::Stages stage );
     
@@ -62,11 +64,12 @@ protected:
     // Doesn't do anything in this model:
     virtual void treatPkPd(size_t schedule, size_t dosages, double age, double delay_d);
     
-    /** The list of all infections this human has.
+    /** The list of all infections this human has (at most MAX_INFECTIONS,
+     * stored contiguously; removal preserves order).
      * 
      * Since infection models and within host models are very much intertwined,
      * the idea is that each WithinHostModel has its own list of infections. */
-     std::list<DescriptiveInfection> infections;
+     util::PooledVector<DescriptiveInfection> infections;
 };
 
 } }
@@ -23,6 +23,8 @@
 #include "util/errors.h"
 #include "util/vectors.h"
 #include "util/CommandLine.h"
+#include "util/ModelOptions.h"
+#include "util/sampler.h"
 #include "schema/scenario.h"
 
 #include <iomanip>
@@ -34,6 +36,10 @@ namespace GT /*for genotype impl details*/{
 // ———  Model constants (after init)  ———
 // keys are cumulative probabilities; last entry should equal 1; values are genotype codes
 map<double,uint32_t> cum_initial_freqs;
+// alias table over initial frequencies (GENOTYPE_ALIAS_SAMPLING)
+util::AliasSampler initial_sampler;
+// per-source alias tables, updated each step (GENOTYPE_ALIAS_SAMPLING)
+vector<util::AliasSampler> source_samplers;
 
 // we give each allele of each loci a unique code
 map<string, map<string, uint32_t> > alleleCodes;
@@ -112,6 +118,14 @@ bool contains(const vector<T>& vec, const T& x){
 }
 
 void Genotypes::init( const scnXml::Scenario& scenario ){
+    // reset state of any previous simulation in this process
+    GT::cum_initial_freqs.clear();
+    GT::alleleCodes.clear();
+    GT::nextAlleleCode = 0;
+    GT::source_samplers.clear();
+    GT::current_mode = GT::SAMPLE_FIRST;
+    GT::interv_mode = GT::SAMPLE_FIRST;
+    
     if( scenario.getParasiteGenetics().present() ){
         const scnXml::ParasiteGenetics& genetics =
             scenario.getParasiteGenetics().get();
@@ -163,6 +177,12 @@ void Genotypes::init( const scnXml::Scenario& scenario ){
         GT::cum_initial_freqs[1.0] = GT::genotypes.size() - 1;
     }
     
+    vector<double> init_freqs( GT::genotypes.size() );
+    for( size_t i = 0; i < GT::genotypes.size(); ++i ){
+        init_freqs[i] = GT::genotypes[i].init_freq;
+    }
+    GT::initial_sampler.setWeights( init_freqs );
+    
     if( util::CommandLine::option( util::CommandLine::PRINT_GENOTYPES ) ){
         // reorganise GT::alleleCodes so that we can look up codes, not names
         vector<pair<string,string> > allele_codes( GT::cum_initial_freqs.size() );
@@ -274,31 +294,64 @@ const vector< Genotypes::Genotype >& Genotypes::getGenotypes(){
     return GT::genotypes;
 }
 
-uint32_t Genotypes::sampleGenotype( LocalRng& rng, vector<double>& genotype_weights ){
+uint32_t Genotypes::sampleGenotype( LocalRng& rng, const GenotypeWeights& genotype_weights ){
+    const vector<double>& weights = genotype_weights.byGenotype;
     if( GT::current_mode == GT::SAMPLE_FIRST ){
         return 0;       // always the first genotype code
     }else if( GT::current_mode == GT::SAMPLE_INITIAL
-            || genotype_weights.size() == 0 )
+            || weights.size() == 0 )
     {
+        if( util::ModelOptions::option( util::GENOTYPE_ALIAS_SAMPLING ) ){
+            return GT::initial_sampler.sample( rng );
+        }
         double sample = rng.uniform_01();
         auto it = GT::cum_initial_freqs.upper_bound( sample );
         assert( it != GT::cum_initial_freqs.end() );
         return it->second;
+    }else if( genotype_weights.bySource.size() > 0 ){
+        // Two-stage sample: source (species), then genotype from its table
+        const vector<double>& sources = genotype_weights.bySource;
+        assert( sources.size() == GT::source_samplers.size() );
+        if( sources.size() == 1 ){
+            if( !(GT::source_samplers[0].total() > 0.0) ) return 0;
+            return GT::source_samplers[0].sample( rng );
+        }
+        double weight_sum = 0.0;
+        for( size_t s = 0; s < sources.size(); ++s ){
+            weight_sum += sources[s] * GT::source_samplers[s].total();
+        }
+        double sample = rng.uniform_01() * weight_sum;
+        for( size_t s = 0; s < sources.size(); ++s ){
+            const double w = sources[s] * GT::source_samplers[s].total();
+            if( sample < w ) return GT::source_samplers[s].sample( rng );
+            sample -= w;
+        }
+        return 0;       // as below (weight_sum == 0.0)
     }else{
         assert( GT::current_mode == GT::SAMPLE_TRACKING );
-        assert( genotype_weights.size() == N_genotypes );
-        double weight_sum = util::vectors::sum( genotype_weights );
+        assert( weights.size() == N_genotypes );
+        double weight_sum = util::vectors::sum( weights );
         assert( weight_sum >= 0.0 && weight_sum < 1e5 );        // possible loss of precision or other error
         double sample = rng.uniform_01() * weight_sum;
         double cum = 0.0;
         for( size_t g = 0; g < N_genotypes; ++g ){
-            cum += genotype_weights[g];
+            cum += weights[g];
             if( sample < cum ) return g;
         }
         return 0;       // just to be safe (could happen if weight_sum == 0.0)
     }
 }
 
+void Genotypes::setNumSources( size_t n ){
+    GT::source_samplers.resize( n );
+}
+
+void Genotypes::setSourceWeights( size_t source, const vector<double>& weights ){
+    assert( source < GT::source_samplers.size() );
+    assert( weights.size() == N_genotypes );
+    GT::source_samplers[source].setWeights( weights );
+}
+
 double Genotypes::initialFreq( size_t genotype ){
     if( GT::genotypes.size() == 0 ){
         assert( genotype == 0 );
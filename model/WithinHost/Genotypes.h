@@ -26,10 +26,27 @@
 #include <iostream>
 #include <set>
 
+class UnittestUtil;
+
 namespace OM { namespace WithinHost {
 
 using util::LocalRng;
 
+/** Weights used to sample the genotypes of a host's new infections.
+ * 
+ * byGenotype gives the weight of each genotype (total need not be one); if
+ * empty, initial frequencies are used.
+ * 
+ * bySource is optional (only used in tracking mode with the
+ * GENOTYPE_ALIAS_SAMPLING option). When set, source s (a mosquito species)
+ * has weight bySource[s] times the total weight of the table given to
+ * Genotypes::setSourceWeights(s, ...), and byGenotype must equal the sum over
+ * sources of bySource[s] times that table. */
+struct GenotypeWeights {
+    std::vector<double> byGenotype;
+    std::vector<double> bySource;
+};
+
 /** Represents infection genotypes. */
 class Genotypes {
 public:
@@ -70,11 +87,17 @@ public:
     
     /** Sample the genotype using the configured approach.
      * 
-     * @param genotype_weights When in tracking mode, this vector gives the
-     *  weights of each genotype for use in sampling. Total need not be one.
-     *  Also, passing a zero-length vector is a signal to use initial
-     *  frequencies in sampling. */
-    static uint32_t sampleGenotype( LocalRng& rng, std::vector<double>& genotype_weights );
+     * @param genotype_weights When in tracking mode, these give the weights
+     *  of each genotype for use in sampling (see GenotypeWeights). */
+    static uint32_t sampleGenotype( LocalRng& rng, const GenotypeWeights& genotype_weights );
+    
+    /** Set the number of sources (mosquito species) for which tables are
+     * given to setSourceWeights(). */
+    static void setNumSources( size_t n );
+    
+    /** Build the sampling table of a source from its weights by genotype
+     * (partial EIR). Tables of different sources may be set concurrently. */
+    static void setSourceWeights( size_t source, const std::vector<double>& weights );
     
     /** Get the number of genotypes. Functions like sampleGenotype use values
      * from 0 to one less than this. */
@@ -88,6 +111,8 @@ public:
     
 private:
     static size_t N_genotypes;
+    
+    friend class ::UnittestUtil;
 };
 
 }
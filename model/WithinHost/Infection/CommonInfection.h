@@ -66,7 +66,12 @@ public:
 	    return updateDensity( rng, survivalFactor, bsAge, body_mass );
     }
     
-    map<size_t, double> Kn; // IC50^slope per drug type, if sampled
+    /// First day of the blood stage; update() does nothing before this.
+    inline SimTime bloodStageStart() const{
+        return m_startDate + s_latentP;
+    }
+    
+    util::PooledMap<size_t, double> Kn; // IC50^slope per drug type, if sampled
     
 protected:
     /** Update: calculate new density.
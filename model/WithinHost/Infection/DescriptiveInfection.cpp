@@ -35,9 +35,11 @@ namespace WithinHost {
 using namespace util;
 
 // static class variables (see description in header file):
-double DescriptiveInfection::meanLogParasiteCount[numDurations][numDurations];
+double DescriptiveInfection::parasiteCount[numDurations][numDurations];
 double DescriptiveInfection::sigma0sq;
 double DescriptiveInfection::xNuStar;
+bool DescriptiveInfection::useQuantileTable = false;
+MaxNormalQuantileTable DescriptiveInfection::maxDensityQuantiles;
 
 bool bugfix_max_dens = true, bugfix_innate_max_dens = true;
 
@@ -49,7 +51,7 @@ void DescriptiveInfection::init (const Parameters& parameters) {
     if( SimTime::oneTS().inDays() != 5 ){
         // To support non-5-day time-step models, either different data would
         // be needed or times need to be adjusted when accessing
-        // meanLogParasiteCount. Probably the rest would be fine.
+        // parasiteCount. Probably the rest would be fine.
         throw util::xml_scenario_error ("DescriptiveInfection only supports using an interval of 5");
     }
     // Bug fixes: these are enabled by default but may be off in old parameterisations
@@ -63,6 +65,11 @@ void DescriptiveInfection::init (const Parameters& parameters) {
     sigma0sq=parameters[Parameters::SIGMA0_SQ];
     xNuStar=parameters[Parameters::X_NU_STAR];
     
+    useQuantileTable = util::ModelOptions::option (util::TABULATED_NORMAL_QUANTILES);
+    if( useQuantileTable ){
+        maxDensityQuantiles.init( SimTime::oneTS().inDays() - 1, 1e-6 );
+    }
+    
     // Read file empirical parasite densities
     string densities_filename = util::CommandLine::lookupResource ("densities.csv");
     ifstream f_MTherapyDensities( densities_filename.c_str() );
@@ -102,11 +109,11 @@ void DescriptiveInfection::init (const Parameters& parameters) {
                 .append(densities_filename), Error::InputResource );
         }
 
-        //fill initial matrix
-        meanLogParasiteCount[i-1][j-1]=meanlogdens;
+        //fill initial matrix (exponentiated here instead of on each use)
+        parasiteCount[i-1][j-1]=max(exp(meanlogdens), 1.0);
         //fill also the triangle that will not be used (to ensure everything is initialised)
         if (j!=i) {
-            meanLogParasiteCount[j-1][i-1]=0.0;
+            parasiteCount[j-1][i-1]=1.0;      // exp(0)
         }
 
     }
@@ -160,7 +167,7 @@ void DescriptiveInfection::determineDensities(
         
         int32_t infAge = min( infage.inSteps(), maxDurationTS );
         int32_t infDur = min( m_duration.inSteps(), maxDurationTS );
-        m_density=max (exp(meanLogParasiteCount[infAge][infDur]), 1.0);
+        m_density=parasiteCount[infAge][infDur];
         
         // The expected parasite density in the non naive host (AJTM p.9 eq. 9)
         // Note that in published and current implementations Dx is zero.
@@ -180,7 +187,10 @@ void DescriptiveInfection::determineDensities(
             double meanlog = log(m_density) - stdlog*stdlog / 2.0;
             m_density = rng.log_normal(meanlog, stdlog);
             // Calculate additional samples for T-1 days (T=days per step):
-            if( true /*SimTime::oneTS().inDays() > 1, always true for this model*/ ){
+            if( useQuantileTable ){
+                timeStepMaxDensity = maxDensityQuantiles.max_multi_log_normal (rng,
+                        m_density, meanlog, stdlog);
+            } else if( true /*SimTime::oneTS().inDays() > 1, always true for this model*/ ){
                 timeStepMaxDensity = rng.max_multi_log_normal (m_density,
                         SimTime::oneTS().inDays() - 1, meanlog, stdlog);
             } else {
@@ -23,6 +23,7 @@
 
 #include "WithinHost/Infection/Infection.h"
 #include "util/random.h"
+#include "util/sampler.h"
 
 namespace OM { namespace WithinHost {
 
@@ -44,7 +45,7 @@ const double maxDens = 2000000;
  * 
  * This model was designed primarily for usage with a 5-day time-step, but is
  * mostly applicable to 1-4 day time-steps too. In such cases the indexes used
- * to access meanLogParasiteCount (or the data contained) would need adjusting.
+ * to access parasiteCount (or the data contained) would need adjusting.
  * 
  * Note that this class models only a single infection; for the associated
  * handling of multiple infections see the DescriptiveWithinHostModel class.
@@ -120,15 +121,19 @@ protected:
 private:
     /// @brief Static parameters set by init()
     //@{
-    /* A triangular matrix: meanLogParasiteCount[i][j] is the
-     * Mean Log Parasite Count for age i (in time steps) of an infection which
-     * lasts j days. Indices with i>j are unused. */
-    static double meanLogParasiteCount[numDurations][numDurations];
+    /* A triangular matrix: parasiteCount[i][j] is max(exp(m), 1) where m is
+     * the Mean Log Parasite Count for age i (in time steps) of an infection
+     * which lasts j days. Indices with i>j are unused. */
+    static double parasiteCount[numDurations][numDurations];
     
     /// Sigma0^2 from AJTM p.9 eq. 13
     static double sigma0sq;
     /// XNuStar in AJTM p.9 eq. 13
     static double xNuStar;
+    /// Set when using TABULATED_NORMAL_QUANTILES
+    static bool useQuantileTable;
+    /// Quantiles of the maximum over the days of a step after the first
+    static util::MaxNormalQuantileTable maxDensityQuantiles;
     //@}
 };
 
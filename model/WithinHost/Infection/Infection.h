@@ -24,12 +24,13 @@
 #include "Global.h"
 #include "Parameters.h"
 #include "WithinHost/Genotypes.h"
+#include "util/ObjectPool.h"
 
 class UnittestUtil;
 
 namespace OM { namespace WithinHost {
     
-class Infection {
+class Infection : public util::PooledObject {
 public:
     inline static void init( SimTime latentP ){
         s_latentP = latentP;
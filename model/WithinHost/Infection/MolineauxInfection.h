@@ -92,7 +92,7 @@ private:
         float lagged_Pi[taus];   // Pi(τ) for τ ∈ {t - δ_v, ..., t - 2}
     };
     // variant-specific data; variants[i-1] corresponds to variant i in the paper
-    vector<Variant> variants;
+    util::PooledVector<Variant> variants;
     
     // allow unittest to access private vars
     friend class ::MolineauxInfectionSuite;
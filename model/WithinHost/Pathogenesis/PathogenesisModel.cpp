@@ -53,6 +53,8 @@ bool opt_predetermined_episodes = false, opt_mueller_pres_model = false;
 
 
 void PathogenesisModel::init( const Parameters& parameters, const scnXml::Clinical& clinical, bool nmfOnly ){
+    opt_predetermined_episodes = false;
+    opt_mueller_pres_model = false;
     if( util::ModelOptions::option( util::NON_MALARIA_FEVERS ) ){
         if( !clinical.getNonMalariaFevers().present() ){
             throw util::xml_scenario_error("NonMalariaFevers element of model->clinical required");
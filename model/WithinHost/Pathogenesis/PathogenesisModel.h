@@ -25,6 +25,7 @@
 #include "Parameters.h"
 #include "WithinHost/Pathogenesis/State.h"
 #include "util/random.h"
+#include "util/ObjectPool.h"
 
 namespace scnXml{
     class HSESNMF;
@@ -40,7 +41,7 @@ using util::LocalRng;
 /*! PathogenesisModel abstract base class.
  *
  * Previously named MorbidityModel and PresentationModel. */
-class PathogenesisModel {
+class PathogenesisModel : public util::PooledObject {
 public:
     /// Calls static init on correct PathogenesisModel.
     static void init( const Parameters& parameters, const scnXml::Clinical& clinical, bool nmfOnly );
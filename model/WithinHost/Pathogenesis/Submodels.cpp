@@ -92,7 +92,9 @@ double PyrogenPathogenesis::getPEpisode(double timeStepMaxDensity, double totalD
 
 void PyrogenPathogenesis::summarize (const Host::Human& human) {
     mon::reportStatMHF( mon::MHF_PYROGENIC_THRESHOLD, human, _pyrogenThres );
-    mon::reportStatMHF( mon::MHF_LOG_PYROGENIC_THRESHOLD, human, log(_pyrogenThres+1.0) );
+    if( mon::isUsedM( mon::MHF_LOG_PYROGENIC_THRESHOLD ) ){
+        mon::reportStatMHF( mon::MHF_LOG_PYROGENIC_THRESHOLD, human, log(_pyrogenThres+1.0) );
+    }
 }
 
 void PyrogenPathogenesis::updatePyrogenThres(double totalDensity){
@@ -37,6 +37,10 @@ TreatmentId Treatments::addTreatment( const scnXml::TreatmentOption& desc ){
     return id;
 }
 
+void Treatments::clear(){
+    treatments.clear();
+}
+
 
 // ———   non-static  ———
 
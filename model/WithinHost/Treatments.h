@@ -45,6 +45,9 @@ public:
      * that option later. */
     static TreatmentId addTreatment( const scnXml::TreatmentOption& desc );
     
+    /** Remove all treatment options (those of a previous simulation). */
+    static void clear();
+    
     /** Return the corresponding treatment description. */
     static inline const Treatments& select( TreatmentId treatId ){
         assert( treatId.id < treatments.size() );
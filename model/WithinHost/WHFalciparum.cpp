@@ -32,12 +32,14 @@
 #include "mon/reporting.h"
 #include "util/random.h"
 #include "util/ModelOptions.h"
+#include "util/CommandLine.h"
 #include "util/errors.h"
 #include "util/StreamValidator.h"
 #include "util/checkpoint_containers.h"
 #include "util/timeConversions.h"
 #include "schema/scenario.h"
 
+#include <algorithm>
 #include <cmath>
 #include <gsl/gsl_cdf.h>
 
@@ -78,6 +80,7 @@ static double decayM;
 
 SimTime Infection::s_latentP;
 int WHFalciparum::y_lag_len = 0;
+bool WHFalciparum::leanMemory = false;
 
 
 
@@ -96,6 +99,7 @@ void WHFalciparum::init( const OM::Parameters& parameters, const scnXml::Model&
     decayM = parameters[Parameters::DECAY_M];
     
     y_lag_len = SimTime::fromDays(20).inSteps() + 1;
+    leanMemory = util::CommandLine::option( util::CommandLine::LEAN_MEMORY );
     
     //NOTE: should also call cleanup() on the PathogenesisModel, but it only frees memory which the OS does anyway
     Pathogenesis::PathogenesisModel::init( parameters, model.getClinical(), false );
@@ -132,7 +136,8 @@ WHFalciparum::WHFalciparum( LocalRng& rng, double comorbidityFactor ):
     // Oldest code on GoogleCode: _innateImmunity=(double)(W_GAUSS((0), (sigma_i)));
     _innateImmSurvFact = exp(-rng.gauss(0.0, sigma_i));
     
-    m_y_lag.assign(y_lag_len, Genotypes::N(), 0.0);
+    // In lean mode, allocate on first infection (see resetYLag)
+    if( !leanMemory ) m_y_lag.assign(y_lag_len, 0.0);
 }
 
 WHFalciparum::~WHFalciparum()
@@ -183,12 +188,12 @@ double WHFalciparum::probTransmissionToMosquito( double tbvFactor, double *sumX
     size_t d10 = mod_nn(y_lag_len + (sim::ts1() - SimTime::fromDays(10)).inSteps(), y_lag_len);
     size_t d15 = mod_nn(y_lag_len + (sim::ts1() - SimTime::fromDays(15)).inSteps(), y_lag_len);
     size_t d20 = mod_nn(y_lag_len + (sim::ts1() - SimTime::fromDays(20)).inSteps(), y_lag_len);
-    // Sum lagged densities across genotypes:
+    // Lagged densities, summed across genotypes (empty m_y_lag means all zero):
     double y10 = 0.0, y15 = 0.0, y20 = 0.0;
-    for( size_t genotype = 0; genotype < Genotypes::N(); ++genotype ){
-        y10 += m_y_lag.at(d10, genotype);
-        y15 += m_y_lag.at(d15, genotype);
-        y20 += m_y_lag.at(d20, genotype);
+    if( !m_y_lag.empty() ){
+        y10 = m_y_lag[d10];
+        y15 = m_y_lag[d15];
+        y20 = m_y_lag[d20];
     }
     // Weighted sum:
     const double x = PTM_beta1 * y10 + PTM_beta2 * y15 + PTM_beta3 * y20;
@@ -217,17 +222,104 @@ double WHFalciparum::pTransGenotype(double pTrans, double sumX, size_t genotype)
     //NOTE: it is an approximation since it ignores the possibility of
     // simultaneously infecting a mosquito with multiple genotypes.
     
-    // Take weighted sum of total asexual blood stage density 10, 15 and 20 days
+    if( Genotypes::N() == 1 ){
+        if( m_y_lag.empty() ) return 0.0;   // all lagged densities are zero
+        return pTrans * laggedX( m_y_lag.data() ) * sumX;
+    }
+    auto it = std::lower_bound( m_y_lag_genotypes.begin(), m_y_lag_genotypes.end(), genotype );
+    if( it == m_y_lag_genotypes.end() || *it != genotype ) return 0.0;  // no lagged density
+    const size_t k = it - m_y_lag_genotypes.begin();
+    return pTrans * laggedX( &m_y_lag_byGenotype[k * y_lag_len] ) * sumX;
+}
+void WHFalciparum::pTransGenotypes( double pTrans, double sumX,
+        vector<pair<uint32_t,double>>& probs )
+{
+    assert( pTrans > 0.0 );
+    assert( (std::isfinite)(sumX) );
+    
+    if( Genotypes::N() == 1 ){
+        probs.push_back( make_pair( 0u, pTransGenotype( pTrans, sumX, 0 ) ) );
+        return;
+    }
+    for( size_t k = 0; k < m_y_lag_genotypes.size(); ++k ){
+        const double x = laggedX( &m_y_lag_byGenotype[k * y_lag_len] );
+        probs.push_back( make_pair( m_y_lag_genotypes[k], pTrans * x * sumX ) );
+    }
+}
+double WHFalciparum::laggedX( const double *y ) const{
+    // Take weighted sum of asexual blood stage density 10, 15 and 20 days
     // before. Add y_lag_len to index to ensure positive.
     const int i10 = (sim::ts0() - SimTime::fromDays(10) + SimTime::oneTS()).inSteps() + y_lag_len;
     const int i5d = SimTime::fromDays(5).inSteps();
     const int i10d = 2 * i5d;
-    const double x =
-        PTM_beta1 * m_y_lag.at(mod_nn(i10, y_lag_len), genotype) +
-        PTM_beta2 * m_y_lag.at(mod_nn(i10 - i5d, y_lag_len), genotype) +
-        PTM_beta3 * m_y_lag.at(mod_nn(i10 - i10d, y_lag_len), genotype);
+    return PTM_beta1 * y[mod_nn(i10, y_lag_len)] +
+        PTM_beta2 * y[mod_nn(i10 - i5d, y_lag_len)] +
+        PTM_beta3 * y[mod_nn(i10 - i10d, y_lag_len)];
+}
+
+bool WHFalciparum::resetYLag( int y_lag_i, bool haveInfections ){
+    if( m_y_lag.empty() ){
+        if( !haveInfections ) return false;
+        m_y_lag.assign( y_lag_len, 0.0 );
+        return true;
+    }
     
-    return pTrans * x * sumX;
+    m_y_lag[y_lag_i] = 0.0;
+    for( size_t k = 0; k < m_y_lag_genotypes.size(); ++k ){
+        m_y_lag_byGenotype[k * y_lag_len + y_lag_i] = 0.0;
+    }
+    
+    if( leanMemory && !haveInfections &&
+        std::all_of( m_y_lag.begin(), m_y_lag.end(), [](double y){ return y == 0.0; } ) )
+    {
+        // Densities are not negative, so per-genotype densities are all zero too
+        util::PooledVector<double>().swap( m_y_lag );
+        util::PooledVector<uint32_t>().swap( m_y_lag_genotypes );
+        util::PooledVector<double>().swap( m_y_lag_byGenotype );
+        return false;
+    }
+    return true;
+}
+
+void WHFalciparum::addYLag( int y_lag_i, uint32_t genotype, double density ){
+    if( Genotypes::N() == 1 ){
+        m_y_lag[y_lag_i] += density;
+        return;
+    }
+    auto it = std::lower_bound( m_y_lag_genotypes.begin(), m_y_lag_genotypes.end(), genotype );
+    const size_t k = it - m_y_lag_genotypes.begin();
+    if( it == m_y_lag_genotypes.end() || *it != genotype ){
+        m_y_lag_genotypes.insert( it, genotype );
+        m_y_lag_byGenotype.insert( m_y_lag_byGenotype.begin() + k * y_lag_len, y_lag_len, 0.0 );
+    }
+    m_y_lag_byGenotype[k * y_lag_len + y_lag_i] += density;
+}
+
+void WHFalciparum::finishYLag( int y_lag_i ){
+    if( Genotypes::N() == 1 ) return;   // addYLag summed into m_y_lag directly
+    
+    // Sum in genotype order; this matches a sum over all genotypes since
+    // absent genotypes have zero density.
+    double total = 0.0;
+    size_t k = 0;
+    while( k < m_y_lag_genotypes.size() ){
+        auto first = m_y_lag_byGenotype.begin() + k * y_lag_len;
+        auto last = first + y_lag_len;
+        total += first[y_lag_i];
+        if( std::all_of( first, last, [](double y){ return y == 0.0; } ) ){
+            m_y_lag_byGenotype.erase( first, last );
+            m_y_lag_genotypes.erase( m_y_lag_genotypes.begin() + k );
+        }else{
+            ++k;
+        }
+    }
+    m_y_lag[y_lag_i] = total;
+}
+
+void WHFalciparum::memoryUsage( util::MemoryUsage& usage ) const{
+    usage.yLag += m_y_lag.capacity() * sizeof(double) +
+        m_y_lag_genotypes.capacity() * sizeof(uint32_t) +
+        m_y_lag_byGenotype.capacity() * sizeof(double);
 }
 
 bool WHFalciparum::diagnosticResult( LocalRng& rng, const Diagnostic& diagnostic ) const{
@@ -309,6 +401,8 @@ void WHFalciparum::checkpoint (istream& stream) {
     hrp2Density & stream;
     timeStepMaxDensity & stream;
     m_y_lag & stream;
+    m_y_lag_genotypes & stream;
+    m_y_lag_byGenotype & stream;
     (*pathogenesisModel) & stream;
     treatExpiryLiver & stream;
     treatExpiryBlood & stream;
@@ -323,6 +417,8 @@ void WHFalciparum::checkpoint (ostream& stream) {
     hrp2Density & stream;
     timeStepMaxDensity & stream;
     m_y_lag & stream;
+    m_y_lag_genotypes & stream;
+    m_y_lag_byGenotype & stream;
     (*pathogenesisModel) & stream;
     treatExpiryLiver & stream;
     treatExpiryBlood & stream;
@@ -59,6 +59,8 @@ public:
     
     virtual double probTransmissionToMosquito( double tbvFactor, double *sumX )const;
     virtual double pTransGenotype( double pTrans, double sumX, size_t genotype );
+    virtual void pTransGenotypes( double pTrans, double sumX,
+            vector<pair<uint32_t,double>>& probs );
     
     // No PQ treatment for falciparum in current models:
     virtual void optionalPqTreatment( Host::Human& human ){}
@@ -78,6 +80,8 @@ public:
         return m_cumulative_Y;
     }
     
+    virtual void memoryUsage( util::MemoryUsage& usage ) const;
+    
 protected:
     /** Clear infections of the appropriate stages.
      * 
@@ -85,6 +89,31 @@ protected:
      */
     virtual void clearInfections( Treatments::Stages stage ) =0;
     
+    /** @brief Lagged densities
+     * 
+     * Each step, after updating infections, call resetYLag(), then (if it
+     * returns true) addYLag() for each infection and finally finishYLag().
+     */
+    //@{
+    /** Zero lagged densities at index y_lag_i, ready for adding the densities
+     * of current infections.
+     * 
+     * In lean memory mode m_y_lag is only allocated once the host has
+     * infections, and is released again once there are no infections and all
+     * lagged densities are zero.
+     * 
+     * @param haveInfections True if the host currently has any infections
+     * @returns True if m_y_lag is allocated (densities should be added) */
+    bool resetYLag( int y_lag_i, bool haveInfections );
+    
+    /// Add the density of one infection at index y_lag_i
+    void addYLag( int y_lag_i, uint32_t genotype, double density );
+    
+    /** Update the total at index y_lag_i and drop genotypes whose lagged
+     * densities are all zero. */
+    void finishYLag( int y_lag_i );
+    //@}
+    
     ///@brief Immunity model parameters
     //@{
     /** Updates for the immunity model − assumes m_cumulative_h and m_cumulative_Y
@@ -129,8 +158,25 @@ protected:
     * 10, 15 and 20 days ago).
     *
     * m_y_lag[sim::ts0().moduloSteps(y_lag_len)] corresponds to the density
-    * from the previous time step (once updateInfection has been called). */
-    vector2D<double> m_y_lag;
+    * from the previous time step (once updateInfection has been called).
+    * 
+    * May be empty (in lean memory mode), meaning all entries are zero. */
+    util::PooledVector<double> m_y_lag;
+    
+    /** Lagged densities by genotype, stored sparsely: only genotypes with a
+    * non-zero density in the last y_lag_len steps are listed, in increasing
+    * order. Not used when there is only one genotype (m_y_lag is then the
+    * density of that genotype).
+    * 
+    * Densities for m_y_lag_genotypes[k] are stored at indices
+    * [k*y_lag_len, (k+1)*y_lag_len) of m_y_lag_byGenotype, indexed as
+    * m_y_lag. */
+    util::PooledVector<uint32_t> m_y_lag_genotypes;
+    util::PooledVector<double> m_y_lag_byGenotype;
+    
+    /// Weighted sum of lagged densities y (length y_lag_len), as used by
+    /// pTransGenotype.
+    double laggedX( const double *y ) const;
     
     /// The PathogenesisModel introduces illness dependant on parasite density
     unique_ptr<Pathogenesis::PathogenesisModel> pathogenesisModel;
@@ -145,6 +191,10 @@ protected:
     /// set by initHumanParameters
     static int y_lag_len;
     
+    /// True when per-host state should only be allocated while in use
+    /// (command-line option --lean-memory); set by init.
+    static bool leanMemory;
+    
     static void setParams(double cumYStar, double cumHStar, double aM, double dM);   // for unit test only
     friend class ::InfectionImmunitySuite;
 };
@@ -52,9 +52,15 @@ void WHInterface::init( const OM::Parameters& parameters, const scnXml::Scenario
     reportInfectionsByGenotype = mon::isUsedM(mon::MHR_INFECTED_GENOTYPE) ||
         mon::isUsedM(mon::MHR_PATENT_GENOTYPE) ||
         mon::isUsedM(mon::MHF_LOG_DENSITY_GENOTYPE);
+    Treatments::clear();
     
-    if( util::ModelOptions::option( util::VIVAX_SIMPLE_MODEL ) ){
-        opt_vivax_simple = true;
+    opt_vivax_simple = util::ModelOptions::option( util::VIVAX_SIMPLE_MODEL );
+    opt_dummy_whm = false;
+    opt_empirical_whm = false;
+    opt_molineaux_whm = false;
+    opt_penny_whm = false;
+    opt_common_whm = false;
+    if( opt_vivax_simple ){
         WHVivax::init( parameters, scenario.getModel() );
     }else{
         WHFalciparum::init( parameters, scenario.getModel() );
@@ -26,6 +26,8 @@
 #include "WithinHost/Diagnostic.h"
 #include "WithinHost/Pathogenesis/State.h"
 #include "Parameters.h"
+#include "util/MemoryUsage.h"
+#include "util/ObjectPool.h"
 
 using namespace std;
 
@@ -43,6 +45,7 @@ namespace Host {
 namespace WithinHost {
 
 using util::LocalRng;
+struct GenotypeWeights;
 
 /**
  * Type used to select a treatment option.
@@ -70,7 +73,7 @@ private:
  * (i.e. assuming successful innoculation), including some drug action code,
  * and outputting parasite densities.
  */
-class WHInterface {
+class WHInterface : public util::PooledObject {
 public:
     /// @brief Static methods
     //@{
@@ -122,6 +125,15 @@ public:
         if( pTrans <= 0.0 ) return 0.0;
         else return pTransGenotype( pTrans, sumX, genotype );
     }
+    /** Sparse version of probTransGenotype(): set probs to a list of
+     * (genotype, probability) pairs, omitting genotypes for which
+     * probTransGenotype() would return zero. Cost depends on the number of
+     * genotypes present in this host, not on the total number of genotypes. */
+    inline void probTransGenotypes( double pTrans, double sumX,
+            vector<pair<uint32_t,double>>& probs ){
+        probs.clear();
+        if( pTrans > 0.0 ) pTransGenotypes( pTrans, sumX, probs );
+    }
     
     /// @returns true if host has patent parasites
     virtual bool summarize(Host::Human& human) const =0;
@@ -165,7 +177,7 @@ public:
      * @param ageInYears Age of human
      * @param bsvFactor Parasite survival factor for blood-stage vaccines
      */
-    virtual void update(LocalRng& rng, int nNewInfs, vector<double>& genotype_weights,
+    virtual void update(LocalRng& rng, int nNewInfs, GenotypeWeights& genotype_weights,
             double ageInYears, double bsvFactor) =0;
 
     /** TODO: this should not need to be exposed. It is currently used by a
@@ -200,6 +212,10 @@ public:
     // TODO(monitoring): these shouldn't have to be exposed (perhaps use summarize to report the data):
     virtual double getCumulative_h() const =0;
     virtual double getCumulative_Y() const =0;
+    
+    /// Add approximate memory used by this model (and its infections and
+    /// drug models) to usage.
+    virtual void memoryUsage( util::MemoryUsage& usage ) const =0;
 
     /** The maximum number of infections a human can have. The only real reason
      * for this limit is to prevent incase bad input from causing the number of
@@ -212,6 +228,9 @@ protected:
     // See probTransGenotype; this function should only be called when pTrans > 0
     virtual double pTransGenotype( double pTrans, double sumX,
                                    size_t genotype ) =0;
+    // See probTransGenotypes; only called when pTrans > 0. Appends to probs.
+    virtual void pTransGenotypes( double pTrans, double sumX,
+                                  vector<pair<uint32_t,double>>& probs ) =0;
     
     virtual void checkpoint (istream& stream);
     virtual void checkpoint (ostream& stream);
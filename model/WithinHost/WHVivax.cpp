@@ -104,6 +104,8 @@ double pReceivePQ = numeric_limits<double>::signaling_NaN();
 double effectivenessPQ = numeric_limits<double>::signaling_NaN();
 
 #ifdef WHVivaxSamples
+// NOTE: broods are stored by value in a vector, so sampleBrood is reset when
+// they are moved (e.g. the vector grows)
 WHVivax *sampleHost = 0;
 VivaxBrood *sampleBrood = 0;
 #endif
@@ -115,6 +117,7 @@ VivaxBrood *sampleBrood = 0;
 map<double,int> nHypnozoitesProbMap;
 void initNHypnozoites(){
     assert(baseNumberHypnozoites <= 1 && baseNumberHypnozoites >= 0);
+    nHypnozoitesProbMap.clear();
     double total = 0.0;
     for( int n = 0; n <= maxNumberHypnozoites; ++n )
         total += pow( baseNumberHypnozoites, n );
@@ -158,22 +161,23 @@ VivaxBrood::VivaxBrood( LocalRng& rng, WHVivax *host ) :
         hadEvent( false ),
         hadRelapse( false )
 {
-    set<SimTime> releases;     // used to initialise releaseDates; a set is better to use now but a vector later
-    
     // primary blood stage plus hypnozoites (relapses)
-    releases.insert( sim::nowOrTs0() + latentP );
+    releaseDates.push_back( sim::nowOrTs0() + latentP );
     int numberHypnozoites = sampleNHypnozoites(rng);
+    releaseDates.reserve( numberHypnozoites + 1 );
     for( int i = 0; i < numberHypnozoites; ){
         //TODO: why do we have two latent periods (latentP + latentReleaseDays added in sampleReleaseDelay())?
         SimTime randomReleaseDelay = sampleReleaseDelay(rng);
         SimTime timeToRelease = sim::nowOrTs0() + latentP + randomReleaseDelay;
-        bool inserted = releases.insert( timeToRelease ).second;
-        if( inserted ) ++i;     // successful
+        if( find( releaseDates.begin(), releaseDates.end(), timeToRelease ) == releaseDates.end() ){
+            releaseDates.push_back( timeToRelease );
+            ++i;     // successful
+        }
         // else: sample clash with an existing release date, so resample
     }
     
-    // Copy times to the vector, backwards (smallest last):
-    releaseDates.insert( releaseDates.end(), releases.rbegin(), releases.rend() );
+    // Order backwards (smallest last):
+    sort( releaseDates.begin(), releaseDates.end(), greater<SimTime>() );
     
 #ifdef WHVivaxSamples
     if( sampleHost == host && sampleBrood == 0 ){
@@ -283,6 +287,7 @@ void VivaxBrood::treatmentLS(){
 // ———  per-host code  ———
 
 WHVivax::WHVivax( LocalRng& rng, double comorbidityFactor ) :
+    nextEventTime( SimTime::future() ),
     cumPrimInf(0),
     pEvent( numeric_limits<double>::quiet_NaN() ),
     pFirstRelapseEvent( numeric_limits<double>::quiet_NaN() ),
@@ -324,6 +329,10 @@ double WHVivax::probTransmissionToMosquito( double tbvFactor, double *sumX )cons
 double WHVivax::pTransGenotype(double pTrans, double sumX, size_t genotype){
     throw util::unimplemented_exception("genotype tracking for vivax");
 }
+void WHVivax::pTransGenotypes(double pTrans, double sumX,
+        vector<pair<uint32_t,double>>& probs){
+    throw util::unimplemented_exception("genotype tracking for vivax");
+}
 
 bool WHVivax::summarize(Host::Human& human) const{
     if( infections.size() == 0 ) return false;  // no infections: not patent, nothing to report
@@ -345,10 +354,11 @@ bool WHVivax::summarize(Host::Human& human) const{
 void WHVivax::importInfection(LocalRng& rng){
     // this means one new liver stage infection, which can result in multiple blood stages
     infections.push_back( VivaxBrood( rng, this ) );
+    nextEventTime = SimTime::zero();
 }
 
 void WHVivax::update(LocalRng& rng,
-        int nNewInfs, vector<double>&,
+        int nNewInfs, GenotypeWeights&,
         double ageInYears, double)
 {
     pSevere = 0.0;
@@ -360,14 +370,30 @@ void WHVivax::update(LocalRng& rng,
     // update infections
     // NOTE: currently no BSV model
     morbidity = Pathogenesis::NONE;
-    uint32_t oldCumInf = cumPrimInf;
     bool treatmentLiver = treatExpiryLiver > sim::ts0();
     bool treatmentBlood = treatExpiryBlood > sim::ts0();
+    if( nNewInfs > 0 || treatmentLiver || treatmentBlood || nextEventTime <= sim::ts0() ){
+        updateBroods( rng, treatmentLiver, treatmentBlood );
+    }
+    
+    //TODO were pEvent and pFirstRelapseEvent meant to get updated?
+    
+    //NOTE: currently we don't model co-infection or indirect deaths
+    if( morbidity == Pathogenesis::NONE ){
+        morbidity = Pathogenesis::PathogenesisModel::sampleNMF( rng, ageInYears );
+    }
+}
+
+void WHVivax::updateBroods( LocalRng& rng, bool treatmentLiver, bool treatmentBlood ){
+    uint32_t oldCumInf = cumPrimInf;
     double oldpEvent = ( std::isnan(pEvent))? 1.0 : pEvent;
     // always use the first relapse probability for following relapses as a factor
     double oldpRelapseEvent = ( std::isnan(pFirstRelapseEvent))? 1.0 : pFirstRelapseEvent;
-    auto inf = infections.begin();
-    while( inf != infections.end() ){
+    nextEventTime = SimTime::future();
+    // Finished broods are removed by moving those remaining forward, in order
+    size_t nRemaining = 0;
+    for( size_t i = 0; i < infections.size(); ++i ){
+        VivaxBrood *inf = &infections[i];
         if( treatmentLiver ) inf->treatmentLS();
         if( treatmentBlood ) inf->treatmentBS();        // clearnace due to treatment; no protection against reemergence
         VivaxBrood::UpdResult result = inf->update(rng);
@@ -410,16 +436,13 @@ void WHVivax::update(LocalRng& rng,
             }
         }
         
-        if( result.isFinished ) inf = infections.erase( inf );
-        else ++inf;
-    }
-    
-    //TODO were pEvent and pFirstRelapseEvent meant to get updated?
-    
-    //NOTE: currently we don't model co-infection or indirect deaths
-    if( morbidity == Pathogenesis::NONE ){
-        morbidity = Pathogenesis::PathogenesisModel::sampleNMF( rng, ageInYears );
+        if( !result.isFinished ){
+            nextEventTime = min( nextEventTime, inf->nextEvent() );
+            if( nRemaining != i ) infections[nRemaining] = std::move( *inf );
+            ++nRemaining;
+        }
     }
+    infections.erase( infections.begin() + nRemaining, infections.end() );
 }
 
 bool WHVivax::diagnosticResult( LocalRng& rng, const Diagnostic& diagnostic ) const{
@@ -443,6 +466,14 @@ void WHVivax::clearImmunity(){
     throw TRACED_EXCEPTION_DEFAULT( "vivax model does not include immune suppression" );
 }
 
+void WHVivax::memoryUsage( util::MemoryUsage& usage ) const{
+    usage.withinHost += sizeof(*this)
+        + (infections.capacity() - infections.size()) * sizeof(VivaxBrood);
+    for( const VivaxBrood& brood : infections ){
+        usage.withinHost += brood.memoryUsage();
+    }
+}
+
 void WHVivax::treatment( Host::Human& human, TreatmentId treatId ){
     const Treatments& treat = Treatments::select( treatId );
     treatSimple( human, treat.liverEffect(), treat.bloodEffect() );
@@ -461,6 +492,7 @@ void WHVivax::optionalPqTreatment( Host::Human& human ){
             for( auto it = infections.begin(); it != infections.end(); ++it ){
                 it->treatmentLS();
             }
+            nextEventTime = SimTime::zero();
         }
         mon::reportEventMHI( mon::MHT_LS_TREATMENTS, human, 1 );
     }
@@ -484,6 +516,7 @@ bool WHVivax::treatSimple( Host::Human& human, SimTime timeLiver, SimTime timeBl
                 for( auto it = infections.begin(); it != infections.end(); ++it ){
                     it->treatmentLS();
                 }
+                nextEventTime = SimTime::zero();
             }
         }
         mon::reportEventMHI( mon::MHT_LS_TREATMENTS, human, 1 );
@@ -496,6 +529,7 @@ bool WHVivax::treatSimple( Host::Human& human, SimTime timeLiver, SimTime timeBl
             for( auto it = infections.begin(); it != infections.end(); ++it ){
                 it->treatmentBS();
             }
+            nextEventTime = SimTime::zero();
         }else{
             treatExpiryBlood = max( treatExpiryBlood, sim::nowOrTs1() + timeBlood );
         }
@@ -511,9 +545,12 @@ void WHVivax::checkpoint(istream& stream){
     WHInterface::checkpoint(stream);
     size_t len;
     len & stream;
+    validateListSize( len );
+    infections.reserve( len );
     for( size_t i = 0; i < len; ++i ){
         infections.push_back( VivaxBrood( stream ) );
     }
+    nextEventTime = SimTime::zero();
     noPQ & stream;
     int morbidity_i;
     morbidity_i & stream;
@@ -23,6 +23,7 @@
 
 #include "Global.h"
 #include "WithinHost/WHInterface.h"
+#include "util/SmallVector.h"
 
 #include <list>
 #include <memory>
@@ -96,12 +97,31 @@ public:
     /** Fully clear liver stage parasites. */
     void treatmentLS();
     
+    /** The time step on which update() next changes this brood (the next
+     * release, or the end of the blood stage), unless it is treated first.
+     * Call after update(). */
+    inline SimTime nextEvent() const{
+        SimTime next = releaseDates.empty() ? SimTime::future() : releaseDates.back();
+        if( isPatent() ) next = min( next, bloodStageClearDate );
+        return next;
+    }
+    
+    /// Approximate memory used by this object, in bytes
+    inline size_t memoryUsage() const{
+        return sizeof(*this) + (releaseDates.isInline() ? 0 :
+            releaseDates.capacity() * sizeof(SimTime));
+    }
+    
 private:
     VivaxBrood() {}     // not default constructible
     
+    // Release dates of a brood (the merozoite plus hypnozoites) are stored
+    // inline up to this number, which covers most broods
+    static const uint32_t INLINE_RELEASES = 8;
+    
     // list of times at which the merozoite and hypnozoites release, ordered by
     // time of release, soonest last (i.e. last element is next one to release)
-    vector<SimTime> releaseDates;
+    util::SmallVector<SimTime, INLINE_RELEASES> releaseDates;
     
     // Either SimTime::never() (no blood stage) or the start of the time step on
     // which the blood stage will clear.
@@ -148,12 +168,14 @@ public:
     
     virtual double probTransmissionToMosquito( double tbvFactor, double *sumX )const;
     virtual double pTransGenotype( double pTrans, double sumX, size_t genotype );
+    virtual void pTransGenotypes( double pTrans, double sumX,
+            vector<pair<uint32_t,double>>& probs );
     
     virtual bool summarize(Host::Human& human) const;
     
     virtual void importInfection(LocalRng& rng);
     
-    virtual void update(LocalRng& rng, int nNewInfs, vector<double>& genotype_weights,
+    virtual void update(LocalRng& rng, int nNewInfs, GenotypeWeights& genotype_weights,
             double ageInYears, double bsvFactor);
     
     virtual bool diagnosticResult( LocalRng& rng, const Diagnostic& diagnostic ) const;
@@ -162,6 +184,8 @@ public:
     
     virtual void clearImmunity();
     
+    virtual void memoryUsage( util::MemoryUsage& usage ) const;
+    
 protected:
     virtual void treatment( Host::Human& human, TreatmentId treatId );
     virtual bool treatSimple( Host::Human& human, SimTime timeLiver, SimTime timeBlood );
@@ -181,7 +205,16 @@ private:
     WHVivax( const WHVivax& ) = delete;
     WHVivax& operator= (const WHVivax& ) = delete;
     
-    list<VivaxBrood> infections;
+    /// Update broods (part of update()): treatment, releases and clinical events
+    void updateBroods( LocalRng& rng, bool treatmentLiver, bool treatmentBlood );
+    
+    util::PooledVector<VivaxBrood> infections;
+    
+    /* Time step on which update() next needs to update broods: the earliest
+     * VivaxBrood::nextEvent(), or zero when this needs re-calculating (after
+     * new infections, treatment or loading a checkpoint). Until then, broods
+     * are unchanged by update() unless it applies treatment. */
+    SimTime nextEventTime;
     
     /* Is flagged as never getting PQ: this is a heteogeneity factor. Example:
      * Set to zero if everyone can get PQ, 0.5 if females can't get PQ and
@@ -204,13 +204,21 @@ public:
     }
     
     virtual void deploy (Population& population, Transmission::TransmissionModel& transmission) {
+        if( util::ModelOptions::option( util::POPULATION_SKIP_SAMPLING ) ){
+            // Eligible humans are visited in order as trials; only those
+            // selected use a random number.
+            util::BernoulliSkip trials( InterventionManager::sweepRng(), coverage );
+            for(Human& human : population) {
+                if( isEligible( human ) && trials.next() ){
+                    deployToHuman( human, mon::Deploy::TIMED );
+                }
+            }
+            return;
+        }
         for(Human& human : population) {
-            SimTime age = human.age(sim::now());
-            if( age >= minAge && age < maxAge ){
-                if( subPop == ComponentId::wholePop() || (human.isInSubPop( subPop ) != complement) ){
-                    if( human.rng().bernoulli( coverage ) ){
-                        deployToHuman( human, mon::Deploy::TIMED );
-                    }
+            if( isEligible( human ) ){
+                if( human.rng().bernoulli( coverage ) ){
+                    deployToHuman( human, mon::Deploy::TIMED );
                 }
             }
         }
@@ -226,6 +234,13 @@ public:
     }
     
 protected:
+    /// True if the human is within the age range and (optional) sub-population
+    inline bool isEligible( const Human& human ) const{
+        SimTime age = human.age(sim::now());
+        return age >= minAge && age < maxAge &&
+            (subPop == ComponentId::wholePop() || (human.isInSubPop( subPop ) != complement));
+    }
+    
     // restrictions on deployment
     SimTime minAge, maxAge;
 };
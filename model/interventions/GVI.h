@@ -86,10 +86,6 @@ private:
     unique_ptr<DecayFunction> decay;
     vector<GVIAnopheles> species;  // vector specific params
     
-    // This is sparse vector: only indexes corresponding to a GVI component are used
-    // No memory management
-    static vector<GVIComponent*> componentsByIndex;
-    
     friend class HumanGVI;
 };
 
@@ -124,6 +120,8 @@ public:
     /// Get the mosquito fecundity multiplier (1 for no effect).
     virtual double relFecundity(size_t speciesIndex) const;
     
+    virtual size_t memoryUsage() const{ return sizeof(*this); }
+    
 protected:
     virtual void checkpoint( ostream& stream );
     
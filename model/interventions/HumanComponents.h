@@ -24,6 +24,7 @@
 #include "Global.h"
 #include "interventions/Interfaces.hpp"
 #include "util/DecayFunction.h"
+#include "util/ObjectPool.h"
 
 namespace OM {
 namespace Host {
@@ -55,10 +56,6 @@ namespace SubPopRemove{
         NUM };
 }
 
-/** For each RemoveAtCode (excluding NUM), this is a list of all sub-population
- * identifiers for which the option is enabled. */
-extern vector<ComponentId> removeAtIds[SubPopRemove::NUM];
-
 // ———  vaccines  ———
 
 namespace Vaccine{
@@ -124,6 +121,12 @@ public:
     }
 #endif
     
+    /// Approximate memory allocated by this object (not including
+    /// sizeof(PerHumanVaccine)), in bytes
+    inline size_t memoryUsage() const{
+        return effects.capacity() * sizeof(PerEffectPerHumanVaccine);
+    }
+    
     /// Checkpointing
     template<class S>
     void operator& (S& stream) {
@@ -132,7 +135,7 @@ public:
 
 private:
     /// Details for each deployed vaccine for this human
-    typedef std::vector<PerEffectPerHumanVaccine> EffectList;
+    typedef util::PooledVector<PerEffectPerHumanVaccine> EffectList;
     EffectList effects;
 };
 
@@ -20,6 +20,7 @@
 
 #include "Global.h"
 #include "interventions/IRS.h"
+#include "interventions/InterventionManager.hpp"
 #include "Host/Human.h"
 #include "util/errors.h"
 #include "util/SpeciesIndexChecker.h"
@@ -28,7 +29,6 @@
 #include <cmath>
 
 namespace OM { namespace interventions {
-vector<IRSComponent*> IRSComponent::componentsByIndex;
 
 IRSComponent::IRSComponent( ComponentId id, const scnXml::IRSDescription& elt,
         const map<string,size_t>& species_name_map ) :
@@ -60,8 +60,6 @@ IRSComponent::IRSComponent( ComponentId id, const scnXml::IRSDescription& elt,
     }
     checker.checkNoneMissed();
     
-    if( componentsByIndex.size() <= id.id ) componentsByIndex.resize( id.id+1, 0 );
-    componentsByIndex[id.id] = this;
 }
 
 void IRSComponent::deploy( Host::Human& human, mon::Deploy::Method method, VaccineLimits )const{
@@ -256,27 +254,27 @@ void HumanIRS::update(Host::Human& human){
 }
 
 double HumanIRS::relativeAttractiveness(size_t speciesIndex) const{
-    const IRSComponent& params = *IRSComponent::componentsByIndex[m_id.id];
+    const IRSComponent& params = static_cast<const IRSComponent&>( InterventionManager::getComponent( m_id ) );
     const IRSComponent::IRSAnopheles& anoph = params.species[speciesIndex];
     double effect = anoph.relativeAttractiveness( getInsecticideContent(params) );
     return anoph.byProtection( effect );
 }
 
 double HumanIRS::preprandialSurvivalFactor(size_t speciesIndex) const{
-    const IRSComponent& params = *IRSComponent::componentsByIndex[m_id.id];
+    const IRSComponent& params = static_cast<const IRSComponent&>( InterventionManager::getComponent( m_id ) );
     const IRSComponent::IRSAnopheles& anoph = params.species[speciesIndex];
     double effect = anoph.preprandialSurvivalFactor( getInsecticideContent(params) );
     return anoph.byProtection( effect );
 }
 
 double HumanIRS::postprandialSurvivalFactor(size_t speciesIndex) const{
-    const IRSComponent& params = *IRSComponent::componentsByIndex[m_id.id];
+    const IRSComponent& params = static_cast<const IRSComponent&>( InterventionManager::getComponent( m_id ) );
     const IRSComponent::IRSAnopheles& anoph = params.species[speciesIndex];
     double effect = anoph.postprandialSurvivalFactor( getInsecticideContent(params) );
     return anoph.byProtection( effect );
 }
 double HumanIRS::relFecundity(size_t speciesIndex) const{
-    const IRSComponent& params = *IRSComponent::componentsByIndex[m_id.id];
+    const IRSComponent& params = static_cast<const IRSComponent&>( InterventionManager::getComponent( m_id ) );
     const IRSComponent::IRSAnopheles& anoph = params.species[speciesIndex];
     double effect = anoph.fecundityEffect( getInsecticideContent(params) );
     return anoph.byProtection( effect );
@@ -145,10 +145,6 @@ private:
     unique_ptr<DecayFunction> insecticideDecay;
     vector<IRSAnopheles> species; // vector specific params
     
-    // This is sparse vector: only indexes corresponding to a IRS component are used
-    // No memory management
-    static vector<IRSComponent*> componentsByIndex;
-    
     friend class HumanIRS;
 };
 
@@ -185,6 +181,8 @@ public:
     /// Get the mosquito fecundity multiplier (1 for no effect).
     virtual double relFecundity(size_t speciesIndex) const;
     
+    virtual size_t memoryUsage() const{ return sizeof(*this); }
+    
 protected:
     virtual void checkpoint( ostream& stream );
     
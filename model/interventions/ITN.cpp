@@ -19,6 +19,7 @@
  */
 
 #include "interventions/ITN.h"
+#include "interventions/InterventionManager.hpp"
 #include "util/random.h"
 #include "util/errors.h"
 #include "util/SpeciesIndexChecker.h"
@@ -29,7 +30,6 @@
 
 namespace OM { namespace interventions {
 
-vector<ITNComponent*> ITNComponent::componentsByIndex;
 
 // —————  utility classes (internal use only)  —————
 
@@ -530,8 +530,6 @@ ITNComponent::ITNComponent( ComponentId id, const scnXml::ITNDescription& elt,
     }
     checker.checkNoneMissed();
     
-    if( componentsByIndex.size() <= id.id ) componentsByIndex.resize( id.id+1, 0 );
-    componentsByIndex[id.id] = this;
 }
 
 void ITNComponent::deploy( Host::Human& human, mon::Deploy::Method method, VaccineLimits )const{
@@ -665,7 +663,7 @@ void HumanITN::redeploy(LocalRng& rng, const OM::Transmission::HumanVectorInterv
 }
 
 void HumanITN::update(Host::Human& human){
-    const ITNComponent& params = *ITNComponent::componentsByIndex[m_id.id];
+    const ITNComponent& params = static_cast<const ITNComponent&>( InterventionManager::getComponent( m_id ) );
     if( deployTime != SimTime::never() ){
         // First use is at age 0 relative to ts0()
         if( sim::ts0() >= disposalTime ){
@@ -682,27 +680,27 @@ void HumanITN::update(Host::Human& human){
 
 double HumanITN::relativeAttractiveness(size_t speciesIndex) const{
     if( deployTime == SimTime::never() ) return 1.0;
-    const ITNComponent& params = *ITNComponent::componentsByIndex[m_id.id];
+    const ITNComponent& params = static_cast<const ITNComponent&>( InterventionManager::getComponent( m_id ) );
     const ITNComponent::ITNAnopheles& anoph = params.species[speciesIndex];
     return anoph.relativeAttractiveness( holeIndex, getInsecticideContent(params) );
 }
 
 double HumanITN::preprandialSurvivalFactor(size_t speciesIndex) const{
     if( deployTime == SimTime::never() ) return 1.0;
-    const ITNComponent& params = *ITNComponent::componentsByIndex[m_id.id];
+    const ITNComponent& params = static_cast<const ITNComponent&>( InterventionManager::getComponent( m_id ) );
     const ITNComponent::ITNAnopheles& anoph = params.species[speciesIndex];
     return anoph.preprandialSurvivalFactor( holeIndex, getInsecticideContent(params) );
 }
 
 double HumanITN::postprandialSurvivalFactor(size_t speciesIndex) const{
     if( deployTime == SimTime::never() ) return 1.0;
-    const ITNComponent& params = *ITNComponent::componentsByIndex[m_id.id];
+    const ITNComponent& params = static_cast<const ITNComponent&>( InterventionManager::getComponent( m_id ) );
     const ITNComponent::ITNAnopheles& anoph = params.species[speciesIndex];
     return anoph.postprandialSurvivalFactor( holeIndex, getInsecticideContent(params) );
 }
 double HumanITN::relFecundity(size_t speciesIndex) const{
     if( deployTime == SimTime::never() ) return 1.0;
-    const ITNComponent& params = *ITNComponent::componentsByIndex[m_id.id];
+    const ITNComponent& params = static_cast<const ITNComponent&>( InterventionManager::getComponent( m_id ) );
     const ITNComponent::ITNAnopheles& anoph = params.species[speciesIndex];
     return anoph.relFecundity( holeIndex, getInsecticideContent(params) );
 }
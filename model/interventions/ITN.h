@@ -215,10 +215,6 @@ private:
     unique_ptr<DecayFunction> attritionOfNets;
     vector<ITNAnopheles> species; // vector specific params
     
-    // This is sparse vector: only indexes corresponding to ITN components are
-    // used. No memory management.
-    static vector<ITNComponent*> componentsByIndex;
-    
     friend class HumanITN;
 };
 
@@ -257,6 +253,8 @@ public:
     /// Get the mosquito fecundity multiplier (1 for no effect).
     virtual double relFecundity(size_t speciesIndex) const;
     
+    virtual size_t memoryUsage() const{ return sizeof(*this); }
+    
 protected:
     virtual void checkpoint( ostream& stream );
     
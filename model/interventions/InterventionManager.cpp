@@ -33,24 +33,36 @@
 
 namespace OM { namespace interventions {
 
-// ———  InterventionManager  ———
+// ———  State  ———
 
-// static memory:
+State::State() {}
+State::~State(){
+    if( InterventionManager::s_state == this )
+        InterventionManager::s_state = &InterventionManager::s_defaultState;
+}
+void State::makeCurrent(){
+    InterventionManager::s_state = this;
+}
 
-std::map<std::string,ComponentId> InterventionManager::identifierMap;
-vector<unique_ptr<HumanInterventionComponent>> InterventionManager::humanComponents;
-vector<ContinuousHumanDeployment> InterventionManager::continuous;
-vector<unique_ptr<TimedDeployment>> InterventionManager::timed;
-uint32_t InterventionManager::nextTimed;
-OM::Host::ImportedInfections InterventionManager::importedInfections;
+State InterventionManager::s_defaultState;
+State* InterventionManager::s_state = &InterventionManager::s_defaultState;
 
-// declared in HumanComponents.h:
-vector<ComponentId> removeAtIds[SubPopRemove::NUM];
+// ———  InterventionManager  ———
 
 // static functions:
 
-void InterventionManager::init (const scnXml::Interventions& intervElt, Transmission::TransmissionModel& transmission){
-    nextTimed = 0;
+void InterventionManager::reseed (util::MasterRng& masterRng){
+    // Only draw from the master RNG when needed, so that seeds of humans are
+    // unchanged without the option.
+    if( util::ModelOptions::option( util::POPULATION_SKIP_SAMPLING ) ){
+        s_state->sweepRng = util::LocalRng( masterRng );
+    }
+}
+
+void InterventionManager::init (const scnXml::Interventions& intervElt,
+        Transmission::TransmissionModel& transmission, util::MasterRng& masterRng){
+    s_state->nextTimed = 0;
+    reseed( masterRng );
     
     if( intervElt.getChangeHS().present() ){
         const scnXml::ChangeHS& chs = intervElt.getChangeHS().get();
@@ -59,7 +71,7 @@ void InterventionManager::init (const scnXml::Interventions& intervElt, Transmis
             for( auto it = chs.getTimedDeployment().begin(); it != chs.getTimedDeployment().end(); ++it ){
                 try{
                     SimDate date = UnitParse::readDate(it->getTime(), UnitParse::STEPS /*STEPS is only for backwards compatibility*/);
-                    timed.push_back( unique_ptr<TimedDeployment>(new TimedChangeHSDeployment( date, *it )) );
+                    s_state->timed.push_back( unique_ptr<TimedDeployment>(new TimedChangeHSDeployment( date, *it )) );
                 }catch( const util::format_error& e ){
                     throw util::xml_scenario_error( string("interventions/changeHS/timedDeployment/time: ").append(e.message()) );
                 }
@@ -73,7 +85,7 @@ void InterventionManager::init (const scnXml::Interventions& intervElt, Transmis
             for( auto it = eir.getTimedDeployment().begin(); it != eir.getTimedDeployment().end(); ++it ){
                 try{
                     SimDate date = UnitParse::readDate(it->getTime(), UnitParse::STEPS /*STEPS is only for backwards compatibility*/);
-                    timed.push_back( unique_ptr<TimedDeployment>(new TimedChangeEIRDeployment( date, *it )) );
+                    s_state->timed.push_back( unique_ptr<TimedDeployment>(new TimedChangeEIRDeployment( date, *it )) );
                 }catch( const util::format_error& e ){
                     throw util::xml_scenario_error( string("interventions/changeEIR/timedDeployment/time: ").append(e.message()) );
                 }
@@ -83,32 +95,34 @@ void InterventionManager::init (const scnXml::Interventions& intervElt, Transmis
     // species_index_map is not available with the non-vector model or
     // non-dynamic mode, so setting it (lazily) also checks sim mode:
     const map<string,size_t>* species_index_map = 0;
+    // Only the first vaccine component configured is reported as MHD_VACCINATIONS:
+    size_t nVaccines = 0;
     if( intervElt.getHuman().present() ){
         const scnXml::HumanInterventions& human = intervElt.getHuman().get();
         
         // 1. Read components
         for( auto it = human.getComponent().begin(), end = human.getComponent().end(); it != end; ++it ) {
             const scnXml::HumanInterventionComponent& component = *it;
-            if( identifierMap.count( component.getId() ) > 0 ){
+            if( s_state->identifierMap.count( component.getId() ) > 0 ){
                 ostringstream msg;
                 msg << "The id attribute of interventions.human.component elements must be unique; found \""
                         << component.getId() << "\" twice.";
                 throw util::xml_scenario_error( msg.str() );
             }
-            ComponentId id( humanComponents.size() );        // i.e. index of next item
-            identifierMap.insert( make_pair(component.getId(), id) );
+            ComponentId id( s_state->humanComponents.size() );        // i.e. index of next item
+            s_state->identifierMap.insert( make_pair(component.getId(), id) );
             
             SimTime expireAfter = SimTime::future();
             if( component.getSubPopRemoval().present() ){
                 const scnXml::SubPopRemoval& removeOpts = component.getSubPopRemoval().get();
                 if( removeOpts.getOnFirstBout() ){
-                    removeAtIds[SubPopRemove::ON_FIRST_BOUT].push_back( id );
+                    s_state->removeAtIds[SubPopRemove::ON_FIRST_BOUT].push_back( id );
                 }
                 if( removeOpts.getOnFirstInfection() ){
-                    removeAtIds[SubPopRemove::ON_FIRST_INFECTION].push_back( id );
+                    s_state->removeAtIds[SubPopRemove::ON_FIRST_INFECTION].push_back( id );
                 }
                 if( removeOpts.getOnFirstTreatment() ){
-                    removeAtIds[SubPopRemove::ON_FIRST_TREATMENT].push_back( id );
+                    s_state->removeAtIds[SubPopRemove::ON_FIRST_TREATMENT].push_back( id );
                 }
                 if( removeOpts.getAfterYears().present() ){
                     expireAfter = SimTime::fromYearsN( removeOpts.getAfterYears().get() );
@@ -125,11 +139,11 @@ void InterventionManager::init (const scnXml::Interventions& intervElt, Transmis
             }else if( component.getDecisionTree().present() ){
                 hiComponent = new DecisionTreeComponent( id, component.getDecisionTree().get() );
             }else if( component.getPEV().present() ){
-                hiComponent = new VaccineComponent( id, component.getPEV().get(), Vaccine::PEV );
+                hiComponent = new VaccineComponent( id, component.getPEV().get(), Vaccine::PEV, nVaccines++ == 0 );
             }else if( component.getBSV().present() ){
-                hiComponent = new VaccineComponent( id, component.getBSV().get(), Vaccine::BSV );
+                hiComponent = new VaccineComponent( id, component.getBSV().get(), Vaccine::BSV, nVaccines++ == 0 );
             }else if( component.getTBV().present() ){
-                hiComponent = new VaccineComponent( id, component.getTBV().get(), Vaccine::TBV );
+                hiComponent = new VaccineComponent( id, component.getTBV().get(), Vaccine::TBV, nVaccines++ == 0 );
             }else if( component.getITN().present() ){
                 if( species_index_map == 0 )
                     species_index_map = &Transmission::VectorModel::getSpeciesIndexMap();
@@ -152,7 +166,7 @@ void InterventionManager::init (const scnXml::Interventions& intervElt, Transmis
                     "child, didn't find it (perhaps I need updating)" );
             }
             hiComponent->setExpireAfter( expireAfter );
-            humanComponents.push_back( unique_ptr<HumanInterventionComponent>(hiComponent) );
+            s_state->humanComponents.push_back( unique_ptr<HumanInterventionComponent>(hiComponent) );
         }
         
         // 2. Read the list of deployments
@@ -183,7 +197,7 @@ void InterventionManager::init (const scnXml::Interventions& intervElt, Transmis
                             end = UnitParse::readDate(it2->getEnd().get(),
                                                       UnitParse::STEPS /*STEPS is only for backwards compatibility*/);
                         }
-                        continuous.push_back( ContinuousHumanDeployment( begin, end, *it2, intervention, subPop, complement ) );
+                        s_state->continuous.push_back( ContinuousHumanDeployment( begin, end, *it2, intervention, subPop, complement ) );
                     }catch( const util::format_error& e ){
                         throw util::xml_scenario_error(
                             string("interventions/human/deployment/continuous/deploy: ")
@@ -242,12 +256,12 @@ void InterventionManager::init (const scnXml::Interventions& intervElt, Transmis
                         const scnXml::CumulativeCoverage& cumCov = timedIt->getCumulativeCoverage().get();
                         ComponentId cumCovComponent = getComponentId( cumCov.getComponent() );
                         for( auto deploy = deployTimes.begin(), end = deployTimes.end(); deploy != end; ++deploy ) {
-                            timed.push_back( unique_ptr<TimedDeployment>(new TimedCumulativeHumanDeployment(
+                            s_state->timed.push_back( unique_ptr<TimedDeployment>(new TimedCumulativeHumanDeployment(
                                 deploy->first, *deploy->second, intervention, subPop, complement, cumCovComponent )) );
                         }
                     }else{
                         for( auto deploy = deployTimes.begin(), end = deployTimes.end(); deploy != end; ++deploy ) {
-                            timed.push_back( unique_ptr<TimedDeployment>(new TimedHumanDeployment(
+                            s_state->timed.push_back( unique_ptr<TimedDeployment>(new TimedHumanDeployment(
                                 deploy->first, *deploy->second, intervention, subPop, complement )) );
                         }
                     }
@@ -259,7 +273,7 @@ void InterventionManager::init (const scnXml::Interventions& intervElt, Transmis
     }
     if( intervElt.getImportedInfections().present() ){
         const scnXml::ImportedInfections& ii = intervElt.getImportedInfections().get();
-        importedInfections.init( ii );
+        s_state->importedInfections.init( ii );
     }
     // Must come after vaccines are initialised:
     if( intervElt.getInsertR_0Case().present() ){
@@ -274,7 +288,7 @@ void InterventionManager::init (const scnXml::Interventions& intervElt, Transmis
             // timed deployments:
             for( auto it = elt.getTimedDeployment().begin(); it != elt.getTimedDeployment().end(); ++it ){
                 SimDate date = UnitParse::readDate(it->getTime(), UnitParse::STEPS /*STEPS is only for backwards compatibility*/);
-                timed.push_back( new TimedR_0Deployment( date ) );
+                s_state->timed.push_back( new TimedR_0Deployment( date ) );
             }
         }
 #endif
@@ -285,7 +299,7 @@ void InterventionManager::init (const scnXml::Interventions& intervElt, Transmis
             // timed deployments:
             for( auto it = elt.getTimedDeployment().begin(); it != elt.getTimedDeployment().end(); ++it ){
                 SimDate date = UnitParse::readDate(it->getTime(), UnitParse::STEPS /*STEPS is only for backwards compatibility*/);
-                timed.push_back( unique_ptr<TimedDeployment>(new TimedUninfectVectorsDeployment( date )) );
+                s_state->timed.push_back( unique_ptr<TimedDeployment>(new TimedUninfectVectorsDeployment( date )) );
             }
         }
     }
@@ -301,7 +315,7 @@ void InterventionManager::init (const scnXml::Interventions& intervElt, Transmis
                 const scnXml::TimedBaseList::DeploySequence& seq = elt.getTimed().get().getDeploy();
                 for( auto it = seq.begin(); it != seq.end(); ++it ) {
                     SimDate date = UnitParse::readDate(it->getTime(), UnitParse::STEPS /*STEPS is only for backwards compatibility*/);
-                    timed.push_back( unique_ptr<TimedDeployment>(new TimedVectorDeployment( date, instance )) );
+                    s_state->timed.push_back( unique_ptr<TimedDeployment>(new TimedVectorDeployment( date, instance )) );
                 }
                 instance++;
             }
@@ -318,7 +332,7 @@ void InterventionManager::init (const scnXml::Interventions& intervElt, Transmis
                 for( const scnXml::Deploy2 deploy : elt.getTimed().get().getDeploy() ){
                     SimDate date = UnitParse::readDate(deploy.getTime(), UnitParse::STEPS /*STEPS is only for backwards compatibility*/);
                     SimTime lifespan = UnitParse::readDuration(deploy.getLifespan(), UnitParse::NONE);
-                    timed.push_back( unique_ptr<TimedDeployment>(new TimedAddNonHumanHostsDeployment( date, elt.getName(), lifespan )) );
+                    s_state->timed.push_back( unique_ptr<TimedDeployment>(new TimedAddNonHumanHostsDeployment( date, elt.getName(), lifespan )) );
                 }
                 instance++;
             }
@@ -336,7 +350,7 @@ void InterventionManager::init (const scnXml::Interventions& intervElt, Transmis
                 const scnXml::TimedBaseList::DeploySequence& seq = elt.getTimed().get().getDeploy();
                 for( auto it = seq.begin(); it != seq.end(); ++it ) {
                     SimDate date = UnitParse::readDate(it->getTime(), UnitParse::STEPS /*STEPS is only for backwards compatibility*/);
-                    timed.push_back( unique_ptr<TimedDeployment>(new TimedNonHumanHostsDeployment( date, instance, elt.getNonHumanHostsName())) );
+                    s_state->timed.push_back( unique_ptr<TimedDeployment>(new TimedNonHumanHostsDeployment( date, instance, elt.getNonHumanHostsName())) );
                 }
                 instance++;
             }
@@ -351,7 +365,7 @@ void InterventionManager::init (const scnXml::Interventions& intervElt, Transmis
                     SimDate date = UnitParse::readDate(deploy.getTime(), UnitParse::STEPS);
                     double ratio = deploy.getRatioToHumans();
                     SimTime lifespan = UnitParse::readDuration(deploy.getLifespan(), UnitParse::NONE);
-                    timed.push_back( unique_ptr<TimedDeployment>(new TimedTrapDeployment( date, instance, ratio, lifespan )) );
+                    s_state->timed.push_back( unique_ptr<TimedDeployment>(new TimedTrapDeployment( date, instance, ratio, lifespan )) );
                 }
             }
             instance += 1;
@@ -360,28 +374,28 @@ void InterventionManager::init (const scnXml::Interventions& intervElt, Transmis
 
     // lists must be sorted, increasing
     // For reproducability, we need to use stable_sort, not sort.
-    stable_sort(continuous.begin(), continuous.end(), byDeployTime);
-    stable_sort(timed.begin(), timed.end(), byDeployTime);
+    stable_sort(s_state->continuous.begin(), s_state->continuous.end(), byDeployTime);
+    stable_sort(s_state->timed.begin(), s_state->timed.end(), byDeployTime);
     
     // make sure the list ends with something always in the future, so we don't
     // have to check nextTimed is within range:
-    timed.push_back( unique_ptr<TimedDeployment>(new DummyTimedDeployment()) );
+    s_state->timed.push_back( unique_ptr<TimedDeployment>(new DummyTimedDeployment()) );
     
     if( util::CommandLine::option( util::CommandLine::PRINT_INTERVENTIONS ) ){
         cout << "Continuous deployments:" << endl
             << "begin\tend\tage\tsub pop\tcompl\tcoverag\tcomponents" << endl;
-        for( auto it = continuous.begin(); it != continuous.end(); ++it ){
+        for( auto it = s_state->continuous.begin(); it != s_state->continuous.end(); ++it ){
             it->print_details( std::cout );
             cout << endl;
         }
         cout << "Timed deployments:" << endl
             << "time\tmin age\tmax age\tsub pop\tcompl\tcoverag\tcomponents" << endl;
-        for( auto& deploy : timed ){
+        for( auto& deploy : s_state->timed ){
             deploy->print_details( std::cout );
             cout << endl;
         }
         cout << "Human components:" << endl;
-        for( auto& component : humanComponents ){
+        for( auto& component : s_state->humanComponents ){
             component->print_details( cout );
             cout << endl;
         }
@@ -390,8 +404,8 @@ void InterventionManager::init (const scnXml::Interventions& intervElt, Transmis
 
 ComponentId InterventionManager::getComponentId( const string textId )
 {
-    auto it = identifierMap.find( textId );
-    if( it == identifierMap.end() ){
+    auto it = s_state->identifierMap.find( textId );
+    if( it == s_state->identifierMap.end() ){
         ostringstream msg;
         msg << "unable to find an intervention component with id \""
             << textId << "\" (wrong name, no definition or used before definition?)";
@@ -408,9 +422,9 @@ void InterventionManager::loadFromCheckpoint(
     // We need to re-deploy changeHS and changeEIR interventions, but nothing
     // else. nextTimed should be zero so we can go through all past interventions.
     // Only redeploy those which happened before this time step.
-    assert( nextTimed == 0 );
-    while( timed[nextTimed]->date < date ){
-        TimedDeployment *deployment = &*timed[nextTimed];
+    assert( s_state->nextTimed == 0 );
+    while( s_state->timed[s_state->nextTimed]->date < date ){
+        TimedDeployment *deployment = &*s_state->timed[s_state->nextTimed];
         if( dynamic_cast<TimedChangeHSDeployment*>(deployment)!=0 ||
             dynamic_cast<TimedChangeEIRDeployment*>(deployment)!=0 ){
             //Note: neither changeHS nor changeEIR interventions care what the
@@ -418,7 +432,7 @@ void InterventionManager::loadFromCheckpoint(
             //tell them the deployment date.
             deployment->deploy( population, transmission );
         }
-        nextTimed += 1;
+        s_state->nextTimed += 1;
     }
 }
 
@@ -428,22 +442,22 @@ void InterventionManager::deploy(Population& population, Transmission::Transmiss
         return;
     
     // deploy imported infections (not strictly speaking an intervention)
-    importedInfections.import( population );
+    s_state->importedInfections.import( population, s_state->sweepRng );
     
     // deploy timed interventions
     SimDate now = sim::intervDate();
-    while( timed[nextTimed]->date <= now ){
-        timed[nextTimed]->deploy( population, transmission );
-        nextTimed += 1;
+    while( s_state->timed[s_state->nextTimed]->date <= now ){
+        s_state->timed[s_state->nextTimed]->deploy( population, transmission );
+        s_state->nextTimed += 1;
     }
     
     // deploy continuous interventions
     for( Population::Iter it = population.begin(); it != population.end(); ++it ){
         uint32_t nextCtsDist = it->getNextCtsDist();
         // deploy continuous interventions
-        while( nextCtsDist < continuous.size() )
+        while( nextCtsDist < s_state->continuous.size() )
         {
-            if( !continuous[nextCtsDist].filterAndDeploy( *it, population ) )
+            if( !s_state->continuous[nextCtsDist].filterAndDeploy( *it, population ) )
                 break;  // deployment (and all remaining) happens in the future
             nextCtsDist = it->incrNextCtsDist();
         }
@@ -22,10 +22,15 @@
 
 #include "Global.h"
 #include "interventions/Interfaces.hpp"
+#include "interventions/HumanComponents.h"
 #include "Host/ImportedInfections.h"
 #include "Transmission/TransmissionModel.h"
+#include "util/ModelOptions.h"
+#include "util/random.h"
 #include "schema/interventions.h"
 
+class UnittestUtil;
+
 namespace OM {
     class Population;
     namespace Host {
@@ -37,11 +42,58 @@ namespace interventions {
 class ContinuousHumanDeployment;
 class TimedDeployment;
 
+/** Intervention descriptions and deployment progress of one simulation.
+ *
+ * InterventionManager uses the current state. SimulationContext owns one and
+ * makes it current; otherwise (e.g. in unit tests) a default state is used. */
+class State {
+public:
+    State();
+    /// Makes the default state current if this one is
+    ~State();
+    
+    /// Use this state from now on
+    void makeCurrent();
+    
+private:
+    State( const State& ) = delete;
+    State& operator=( const State& ) = delete;
+    
+    // Map of textual identifiers to numeric identifiers for components
+    std::map<std::string,ComponentId> identifierMap;
+    // All human intervention components, indexed by a number. This list is used
+    // during initialisation and thereafter only for memory management.
+    vector<unique_ptr<HumanInterventionComponent>> humanComponents;
+    // Continuous interventions, sorted by deployment age (weakly increasing)
+    vector<ContinuousHumanDeployment> continuous;
+    // List of all timed interventions. Should be sorted (time weakly increasing).
+    vector<unique_ptr<TimedDeployment>> timed;
+    uint32_t nextTimed = 0;  // not chcekpointed (see loadFromCheckpoint)
+    
+    /* For each RemoveAtCode (excluding NUM), this is a list of all
+     * sub-population identifiers for which the option is enabled. */
+    vector<ComponentId> removeAtIds[SubPopRemove::NUM];
+    
+    // imported infections are not really interventions, and handled by a separate class
+    // (but are grouped here for convenience and due toassociation in schema)
+    OM::Host::ImportedInfections importedInfections;
+    
+    util::LocalRng sweepRng{ 0, 0 };
+    
+    friend class InterventionManager;
+    friend class ::UnittestUtil;
+};
+
 /** Management of interventions deployed on a per-time-step basis. */
 class InterventionManager {
 public:
     /** Read XML descriptions. */
-    static void init (const scnXml::Interventions& intervElt, Transmission::TransmissionModel& transmission);
+    static void init (const scnXml::Interventions& intervElt,
+            Transmission::TransmissionModel& transmission, util::MasterRng& masterRng);
+    
+    /** Re-seed RNGs seeded from the master RNG by init(). Call after
+     * re-seeding the master RNG, before the simulation starts. */
+    static void reseed (util::MasterRng& masterRng);
     
     /// Checkpointing
     template<class S>
@@ -49,8 +101,16 @@ public:
         using namespace OM::util::checkpoint;
         // most members are only set from XML,
         // nextTimed varies but is re-set by loadFromCheckpoint
-        importedInfections & stream;
+        s_state->importedInfections & stream;
+        if( util::ModelOptions::option( util::POPULATION_SKIP_SAMPLING ) ){
+            s_state->sweepRng.checkpoint( stream );
+        }
     }
+    
+    /** RNG used to select humans in population-wide sweeps (imported
+     * infections, timed deployment) with the POPULATION_SKIP_SAMPLING option.
+     * Only seeded when that option is used. */
+    static inline util::LocalRng& sweepRng(){ return s_state->sweepRng; }
 
     /** Call after loading a checkpoint, passing the intervention-period time.
      * 
@@ -72,9 +132,15 @@ public:
      * 
      * @throws util::base_exception if the index is out-of-range */
     inline static const HumanInterventionComponent& getComponent( ComponentId id ){
-        if( id.id >= humanComponents.size() )
+        if( id.id >= s_state->humanComponents.size() )
             throw util::base_exception( "invalid component id" );
-        return *humanComponents[id.id];
+        return *s_state->humanComponents[id.id];
+    }
+    
+    /** Get the sub-populations for which a sub-population removal option is
+     * enabled. */
+    inline static const vector<ComponentId>& removeAtIds( SubPopRemove::RemoveAtCode code ){
+        return s_state->removeAtIds[code];
     }
     
     /** Get a numeric ComponentId from the textual identifier used in the XML.
@@ -83,20 +149,13 @@ public:
     static ComponentId getComponentId( const std::string textId );
     
 private:
-    // Map of textual identifiers to numeric identifiers for components
-    static std::map<std::string,ComponentId> identifierMap;
-    // All human intervention components, indexed by a number. This list is used
-    // during initialisation and thereafter only for memory management.
-    static vector<unique_ptr<HumanInterventionComponent>> humanComponents;
-    // Continuous interventions, sorted by deployment age (weakly increasing)
-    static vector<ContinuousHumanDeployment> continuous;
-    // List of all timed interventions. Should be sorted (time weakly increasing).
-    static vector<unique_ptr<TimedDeployment>> timed;
-    static uint32_t nextTimed;  // not chcekpointed (see loadFromCheckpoint)
+    // The current state, and that used when no SimulationContext has made its
+    // own current
+    static State* s_state;
+    static State s_defaultState;
     
-    // imported infections are not really interventions, and handled by a separate class
-    // (but are grouped here for convenience and due toassociation in schema)
-    static OM::Host::ImportedInfections importedInfections;
+    friend class State;
+    friend class ::UnittestUtil;
 };
 
 } }
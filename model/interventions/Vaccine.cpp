@@ -20,6 +20,7 @@
 
 #include "interventions/Vaccine.h"
 #include "interventions/HumanComponents.h"
+#include "interventions/InterventionManager.hpp"
 #include "Host/Human.h"
 #include "util/random.h"
 #include "util/errors.h"
@@ -34,37 +35,34 @@ namespace OM {
 namespace interventions {
 using namespace OM::util;
 
-vector<VaccineComponent*> VaccineComponent::params;
-ComponentId VaccineComponent::reportComponent = ComponentId::wholePop();
-
-VaccineComponent::VaccineComponent( ComponentId component, const scnXml::VaccineDescription& vd, Vaccine::Types type ) :
+VaccineComponent::VaccineComponent( ComponentId component, const scnXml::VaccineDescription& vd,
+        Vaccine::Types type, bool reportDeployments ) :
         HumanInterventionComponent(component),
         type(type),
         decayFunc(DecayFunction::makeObject( vd.getDecay(), "decay" )),
-        efficacyB(vd.getEfficacyB().getValue())
+        efficacyB(vd.getEfficacyB().getValue()),
+        reportDeployments(reportDeployments)
 {
     if( type == Vaccine::BSV && ModelOptions::option( util::VIVAX_SIMPLE_MODEL ) )
         throw util::unimplemented_exception( "blood stage vaccines (BSV) cannot be used with vivax model" );
     
-    if( reportComponent == ComponentId::wholePop() /* the initial value */ ){
-        // set to the first type described
-        reportComponent = component;
-    }
-
     const scnXml::VaccineDescription::InitialEfficacySequence ies = vd.getInitialEfficacy();
     initialMeanEfficacy.resize (ies.size());
     for(size_t i = 0; i < initialMeanEfficacy.size(); ++i)
         initialMeanEfficacy[i] = ies[i].getValue();
-    
-    if( params.size() <= component.id ) params.resize( component.id + 1 );
-    assert( params[component.id] == 0 );
-    params[component.id] = this;
+}
+
+const VaccineComponent& VaccineComponent::getParams( ComponentId component ){
+    const HumanInterventionComponent& hic = InterventionManager::getComponent( component );
+    assert( hic.componentType() == Component::PEV || hic.componentType() == Component::BSV ||
+            hic.componentType() == Component::TBV );
+    return static_cast<const VaccineComponent&>( hic );
 }
 
 void VaccineComponent::deploy(Host::Human& human, mon::Deploy::Method method, VaccineLimits vaccLimits) const
 {
     bool administered = human.getVaccine().possiblyVaccinate( human, id(), vaccLimits );
-    if( administered && VaccineComponent::reportComponent == id() ){
+    if( administered && reportDeployments ){
         mon::reportEventMHD( mon::MHD_VACCINATIONS, human, method );
     }
     if( type == Vaccine::PEV ) mon::reportEventMHD( mon::MHD_PEV, human, method );
@@ -41,7 +41,8 @@ using util::LocalRng;
  * All parameters (inc. non-static) are only set by initParameters(). */
 class VaccineComponent : public HumanInterventionComponent {
 public:
-    VaccineComponent( ComponentId id, const scnXml::VaccineDescription& seq, Vaccine::Types type );
+    VaccineComponent( ComponentId id, const scnXml::VaccineDescription& seq, Vaccine::Types type,
+            bool reportDeployments );
     
     void deploy( Host::Human& human, mon::Deploy::Method method, VaccineLimits vaccLimits )const;
     
@@ -55,10 +56,8 @@ private:
      * @param numPrevDoses The number of prior vaccinations of the individual. */
     double getInitialEfficacy (LocalRng& rng, size_t numPrevDoses) const;
 
-    inline static const VaccineComponent& getParams( ComponentId component ){
-        assert( component.id < params.size() && params[component.id] != 0 );
-        return *params[component.id];
-    }
+    /// Get the vaccine component with the given id (owned by InterventionManager).
+    static const VaccineComponent& getParams( ComponentId component );
     
     /// Vaccine component type
     Vaccine::Types type;
@@ -72,18 +71,10 @@ private:
     // Distribution of efficacies among individuals, parameter to sample from beta dist.
     double efficacyB;
 
-    /** @brief Vaccine static parameters
-     * 
-     * Each instance is either null or points to data for the vaccine component
-     * with the given component ID.
-     *
-     * No memory management (only leak is at exit which OS deals with). */
-    static vector<VaccineComponent*> params;
-    
     //TODO(monitoring):
     /** Until the monitoring system is updated, only one type of vaccination
      * delivery can be reported. This is whichever is first configured. */
-    static ComponentId reportComponent;
+    bool reportDeployments;
 
     friend class PerHumanVaccine;
     friend class PerEffectPerHumanVaccine;
@@ -0,0 +1,198 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "libopenmalaria.h"
+
+#include "SimulationContext.h"
+#include "Global.h"
+#include "mon/management.h"
+#include "util/CommandLine.h"
+#include "util/DocumentLoader.h"
+#include "util/errors.h"
+#include "util/TaskPool.h"
+#include "schema/scenario.h"
+
+#include <map>
+#include <mutex>
+#include <sstream>
+
+using namespace OM;
+
+struct om_scenario {
+    util::DocumentLoader document;
+
+    // Overrides applied to the document for each run
+    map<int, double> parameters;
+    bool overrideSeed = false;
+    int seed = 0;
+    size_t threads = 1;
+
+    // Results of the last run
+    vector<int> survey, group, measure;
+    vector<double> value;
+};
+
+namespace {
+
+thread_local string lastError;
+
+/** Call from a catch block: describe the current exception in lastError and
+ * return the corresponding exit code (as main() would). */
+int handleException(){
+    try {
+        throw;
+    } catch (const ::xsd::cxx::tree::exception<char>& e) {
+        ostringstream msg;
+        msg << "XSD error: " << e.what() << '\n' << e;
+        lastError = msg.str();
+        return util::Error::XSD;
+    } catch (const util::base_exception& e) {
+        lastError = e.message();
+        return e.getCode() != util::Error::None ? e.getCode() : util::Error::Default;
+    } catch (const exception& e) {
+        lastError = e.what();
+        return util::Error::Default;
+    } catch (...) {
+        lastError = "unknown error";
+        return util::Error::Default;
+    }
+}
+
+int nullScenario(){
+    lastError = "scenario is null";
+    return util::Error::Default;
+}
+
+/// One-off set-up, as done by main() before loading a scenario
+void initLibrary(){
+    static std::once_flag done;
+    std::call_once( done, [](){
+        util::set_gsl_handler();
+        // Sets default option values and file names
+        char name[] = "openmalaria";
+        char* argv[] = { name, nullptr };
+        util::CommandLine::parse( 1, argv );
+    } );
+}
+
+/** Model state which is not part of SimulationContext is process-global,
+ * hence only one simulation may run at a time (see SimulationContext). */
+std::mutex simulationMutex;
+
+/// Apply overrides, run the simulation and read survey results
+void simulate( om_scenario& scn ){
+    for( auto it = scn.parameters.begin(); it != scn.parameters.end(); ++it )
+        scn.document.setParameter( it->first, it->second );
+    if( scn.overrideSeed )
+        scn.document.setSeed( scn.seed );
+
+    std::lock_guard<std::mutex> lock( simulationMutex );
+    util::TaskPool::init( scn.threads );
+    // The simulation takes its own copy, so that scn may be run again
+    util::DocumentLoader document;
+    document.copyDocument( scn.document );
+    SimulationContext simulation( std::move(document) );
+    simulation.simulate();
+    mon::getResults( scn.survey, scn.group, scn.measure, scn.value );
+}
+
+}
+
+extern "C" {
+
+int om_set_grammar_cache(const char* file){
+    lastError.clear();
+    try {
+        initLibrary();
+        util::CommandLine::setGrammarCacheName( file == nullptr ? "" : file );
+        return util::Error::None;
+    } catch (...) {
+        return handleException();
+    }
+}
+
+om_scenario* om_scenario_load(const char* xml, size_t length){
+    lastError.clear();
+    try {
+        initLibrary();
+        unique_ptr<om_scenario> scn( new om_scenario );
+        scn->document.loadDocument( xml, length );
+        return scn.release();
+    } catch (...) {
+        handleException();
+        return nullptr;
+    }
+}
+
+void om_scenario_free(om_scenario* scenario){
+    delete scenario;
+}
+
+int om_scenario_set_parameter(om_scenario* scenario, int number, double value){
+    if( scenario == nullptr ) return nullScenario();
+    scenario->parameters[number] = value;
+    return util::Error::None;
+}
+
+int om_scenario_set_seed(om_scenario* scenario, int seed){
+    if( scenario == nullptr ) return nullScenario();
+    scenario->overrideSeed = true;
+    scenario->seed = seed;
+    return util::Error::None;
+}
+
+int om_scenario_set_threads(om_scenario* scenario, size_t threads){
+    if( scenario == nullptr ) return nullScenario();
+    scenario->threads = threads;
+    return util::Error::None;
+}
+
+int om_scenario_run(om_scenario* scenario){
+    if( scenario == nullptr ) return nullScenario();
+    lastError.clear();
+    try {
+        simulate( *scenario );
+        return util::Error::None;
+    } catch (...) {
+        return handleException();
+    }
+}
+
+size_t om_results_size(const om_scenario* scenario){
+    return scenario == nullptr ? 0 : scenario->value.size();
+}
+const int* om_results_survey(const om_scenario* scenario){
+    return scenario == nullptr ? nullptr : scenario->survey.data();
+}
+const int* om_results_group(const om_scenario* scenario){
+    return scenario == nullptr ? nullptr : scenario->group.data();
+}
+const int* om_results_measure(const om_scenario* scenario){
+    return scenario == nullptr ? nullptr : scenario->measure.data();
+}
+const double* om_results_value(const om_scenario* scenario){
+    return scenario == nullptr ? nullptr : scenario->value.data();
+}
+
+const char* om_last_error(void){
+    return lastError.c_str();
+}
+
+}
@@ -0,0 +1,110 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef Hmod_libopenmalaria
+#define Hmod_libopenmalaria
+
+/* C interface to the OpenMalaria library (built with -DOM_BUILD_LIBRARY=ON).
+ *
+ * Intended for fitting loops: load (and validate) a scenario once from a
+ * memory buffer, then repeatedly override parameters, run and read survey
+ * results from memory, without writing scenario or output files.
+ *
+ * Example:
+ *      om_scenario *scn = om_scenario_load(xml, xmlLength);
+ *      if (!scn) fprintf(stderr, "%s\n", om_last_error());
+ *      om_scenario_set_parameter(scn, 1, 0.05);
+ *      if (om_scenario_run(scn) == 0)
+ *          for (size_t i = 0; i < om_results_size(scn); ++i)
+ *              use(om_results_survey(scn)[i], om_results_group(scn)[i],
+ *                  om_results_measure(scn)[i], om_results_value(scn)[i]);
+ *      om_scenario_free(scn);
+ *
+ * Runs are done in the calling process, each on its own copy of the parsed
+ * scenario; any number may be done one after another. Since some model
+ * state is process-global, runs started from several threads are
+ * serialised (the threads wait for each other). A single om_scenario must
+ * not be used from several threads at once.
+ *
+ * The scenario's schema file (scenario_NN.xsd) is looked up in the working
+ * directory. Continuous output, if configured, is written to ctsout.txt.
+ *
+ * Functions returning int return 0 on success, otherwise an OpenMalaria
+ * error code (see util/errors.h); om_last_error() then describes the error.
+ */
+
+#include <stddef.h>
+
+#if defined _WIN32
+#  define OM_API __declspec(dllexport)
+#else
+#  define OM_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct om_scenario om_scenario;
+
+/* Validate scenarios against a pre-parsed schema grammar stored in file (as
+ * with the --grammar-cache option), which is written if missing or out of
+ * date. Must be called before the first om_scenario_load(); all scenarios
+ * loaded afterwards share the grammar. */
+OM_API int om_set_grammar_cache(const char* file);
+
+/* Parse and validate a scenario document from a buffer of length bytes.
+ * Returns NULL on failure. */
+OM_API om_scenario* om_scenario_load(const char* xml, size_t length);
+
+/* Free a scenario and its results. */
+OM_API void om_scenario_free(om_scenario* scenario);
+
+/* Override the value of model parameter number (see Parameters.h) for
+ * subsequent runs. */
+OM_API int om_scenario_set_parameter(om_scenario* scenario, int number, double value);
+
+/* Override the random seed (model/parameters/iseed) for subsequent runs. */
+OM_API int om_scenario_set_seed(om_scenario* scenario, int seed);
+
+/* Set the number of threads used by subsequent runs (0: one per hardware
+ * thread; default 1). */
+OM_API int om_scenario_set_threads(om_scenario* scenario, size_t threads);
+
+/* Run the simulation, replacing any previous results. */
+OM_API int om_scenario_run(om_scenario* scenario);
+
+/* Survey results of the last successful run, one entry per line of the
+ * equivalent output.txt: survey number, age group (or other category),
+ * measure number and value. Arrays are valid until the next run or free. */
+OM_API size_t om_results_size(const om_scenario* scenario);
+OM_API const int* om_results_survey(const om_scenario* scenario);
+OM_API const int* om_results_group(const om_scenario* scenario);
+OM_API const int* om_results_measure(const om_scenario* scenario);
+OM_API const double* om_results_value(const om_scenario* scenario);
+
+/* Message describing the last error on this thread (empty if none). */
+OM_API const char* om_last_error(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -85,11 +85,21 @@ namespace OM { namespace mon {
     ContinuousType Continuous;
     
     ContinuousType::~ContinuousType (){
+        clear();
+    }
+    
+    void ContinuousType::clear (){
         // free memory
         toReport.clear();
         for( auto it = registered.begin(); it != registered.end(); ++it )
             delete it->second;
-   }
+        registered.clear();
+        if( ctsOStream.is_open() )
+            ctsOStream.close();
+        ctsOStream.clear();
+        ctsPeriod = SimTime::zero();
+        duringInit = false;
+    }
    
     /* Initialise: enable outputs registered and requested in XML.
      * Search for Continuous::registerCallback to see outputs available. */
@@ -43,6 +43,10 @@ namespace mon {
         // frees memory
         ~ContinuousType();        
         
+        /** Unregister all callbacks, close the output file and disable
+         * output, so that another simulation may register its callbacks. */
+        void clear ();
+        
 	/** Load XML description of options. If resuming from a checkpoint,
 	 * append to output; if not, make sure it's not there (on boinc we
 	 * assume we shouldn't overwrite existing files for security reasons).
@@ -0,0 +1,139 @@
+/* This file is part of OpenMalaria.
+ * 
+ * Copyright (C) 2005-2015 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * 
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef H_OM_mon_MonIndex
+#define H_OM_mon_MonIndex
+
+/** Indexing of report stores. For use within the mon package (and unit
+ * tests) only. */
+
+#include "Global.h"
+#include "mon/reporting.h"      // for Measure enum
+
+#include <iostream>
+#include <vector>
+
+namespace OM {
+namespace mon {
+
+struct OutMeasure;
+
+/// One of these is used for every output index, and is specific to a measure
+/// and repeated for every survey.
+struct MonIndex {
+    // Measure which this accepts.
+    Measure measure;
+    // Measure number used in output file
+    int outMeasure;
+    // Index of first item in result array
+    size_t offset;
+    // Number of categories. Must be > 0. If 1, index is set to zero, otherwise
+    // indices *should* be less than this.
+    // 
+    // nAges may include a final, unreported category.
+    size_t nAges, nCohorts, nSpecies, nGenotypes, nDrugs;
+    // Either Deploy::NA (not tracking deployments) or a binary 'or' of at
+    // least one of Deploy::TIMED, Deploy::CTS, Deploy::TREAT.
+    uint8_t deployMask;
+    
+    // Used to calculate next offset. This is max output of `index(...)` + 1.
+    inline size_t size() const{
+        return nAges * nCohorts * nSpecies * nGenotypes * nDrugs;
+    }
+    // Get the index in the result array to store this data at
+    // (age group, cohort, species, genotype, drug).
+    // 
+    // First index is `self.offset`, last is `self.offset + self.size() - 1`.
+    size_t index( size_t a, size_t c, size_t sp, size_t g, size_t d ) const{
+#ifndef NDEBUG
+        if( (nAges > 1 && a >= nAges) ||
+            (nCohorts > 1 && c >= nCohorts) ||
+            (nSpecies > 1 && sp >= nSpecies) ||
+            (nGenotypes > 1 && g >= nGenotypes) ||
+            (nDrugs > 1 && d >= nDrugs)
+        ){
+            cout << "Index out of bounds for age group\t" << a << " of " << nAges
+                << "\ncohort set\t" << c << " of " << nCohorts
+                << "\nspecies\t" << sp << " of " << nSpecies
+                << "\ngenotype\t" << g << " of " << nGenotypes
+                << "\ndrug\t" << d << " of " << nDrugs
+                << endl;
+        }
+#endif
+        // We use `a % nAges` etc. to enforce `a < nAges` and handle
+        // the case `nAges == 1` (i.e. classification is turned off).
+        return offset +
+            (d % nDrugs) + nDrugs *
+            ((g % nGenotypes) + nGenotypes *
+            ((sp % nSpecies) + nSpecies *
+            ((c % nCohorts) + nCohorts *
+            (a % nAges))));
+    }
+    
+    // Pass each output line of some data from results to a function.
+    // 
+    // @param surveyNum Number to output (should start from 1 unlike in code)
+    // @param results Vector of results
+    // @param surveyStart Index in results where data for the current survey starts
+    // @param f Called as f(surveyNum, group, outId, value) for each line of
+    //  output, in the order of output.txt
+    template<typename T, typename F>
+    void forEach( int surveyNum, const OutMeasure& om,
+            const vector<T>& results, size_t surveyStart, F f ) const;
+};
+
+/// A precompiled form of `MonIndex::index`, relative to the start of a
+/// survey's reports: `offset + Σ stride[k] * category[k]`, where `stride` is
+/// zero for dimensions which are not categorised.
+struct IndexPlan {
+    enum { AGE, COHORT, SPECIES, GENOTYPE, DRUG, N_DIMS };
+    uint32_t offset;
+    uint32_t stride[N_DIMS];
+    uint32_t n[N_DIMS];
+    uint8_t deployMask;
+    
+    IndexPlan( const MonIndex& ind ) : offset(ind.offset), deployMask(ind.deployMask) {
+        const size_t dims[N_DIMS] = { ind.nAges, ind.nCohorts, ind.nSpecies,
+            ind.nGenotypes, ind.nDrugs };
+        size_t s = 1;
+        for( int k = N_DIMS - 1; k >= 0; --k ){
+            n[k] = dims[k];
+            stride[k] = dims[k] > 1 ? s : 0;
+            s *= dims[k];
+        }
+    }
+    
+    // Offset of category x in dimension k. Dimensions which are not
+    // categorised contribute nothing. As in MonIndex::index, values out of
+    // range wrap around; this is not expected, so we avoid the division in
+    // the usual case.
+    inline size_t term( int k, size_t x ) const{
+        if( stride[k] == 0 ) return 0;
+        return stride[k] * (x < n[k] ? x : x % n[k]);
+    }
+    inline size_t index( size_t a, size_t c, size_t sp, size_t g, size_t d ) const{
+        return offset + term(AGE, a) + term(COHORT, c) + term(SPECIES, sp) +
+            term(GENOTYPE, g) + term(DRUG, d);
+    }
+};
+
+}
+}
+#endif
@@ -29,37 +29,44 @@
 /** This header provides information from the reporting system. */
 namespace OM {
 namespace mon {
+
+/// For surveys and measures to say something shouldn't be reported
+const size_t NOT_USED = std::numeric_limits<size_t>::max();
+
 // Not 'private' but still not for use externally:
 namespace impl {
     // Consts (set during program start-up):
     extern size_t nSurveys;     // number of reported surveys
     extern size_t nCohorts;
-    // Variables (checkpointed):
-    extern bool isInit; // set true after "initialisation" survey at intervention time 0
-    extern size_t survNumEvent, survNumStat;
-    extern SimDate nextSurveyDate;
+    
+    // Survey variables (checkpointed), part of a mon::State
+    struct SurveyState {
+        bool isInit = false;    // set true after "initialisation" survey at intervention time 0
+        size_t surveyIndex = 0; // index in surveyDates of next survey
+        size_t survNumEvent = NOT_USED, survNumStat = NOT_USED;
+        SimDate nextSurveyDate = SimDate::future();
+    };
+    // Those of the current mon::State
+    extern SurveyState* surveyState;
 }
 
-/// For surveys and measures to say something shouldn't be reported
-const size_t NOT_USED = std::numeric_limits<size_t>::max();
-
 /** Line end character. Use Unix line endings to save a little size. */
 const char lineEnd = '\n';
 
 /// The current survey number (can be passed back to 'event' report functions taking
 /// survey times). May have the special value NOT_USED.
-inline size_t eventSurveyNumber(){ return impl::survNumEvent; }
+inline size_t eventSurveyNumber(){ return impl::surveyState->survNumEvent; }
 
 /// Whether the current survey is reported.
 /// 
 /// Exception: there is a dummy survey at intervention time 0 which is not
 /// reported but acts like it is to set survey variables.
-inline bool isReported(){ return !impl::isInit || impl::survNumStat != NOT_USED; }
+inline bool isReported(){ return !impl::surveyState->isInit || impl::surveyState->survNumStat != NOT_USED; }
 
 /** Date the current (next) survey ends at, or SimTime::never() if no more
  * surveys take place. */
 inline SimDate nextSurveyDate() {
-    return impl::nextSurveyDate;
+    return impl::surveyState->nextSurveyDate;
 }
 
 /// The number of cohort sets
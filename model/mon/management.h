@@ -22,6 +22,8 @@
 #define H_OM_mon_management
 
 #include <fstream>
+#include <memory>
+#include <vector>
 
 namespace scnXml{
     class Scenario;
@@ -34,6 +36,32 @@ namespace scnXml{
 namespace OM {
     class Parameters;
 namespace mon {
+namespace impl {
+    struct StateData;
+}
+
+/** Monitoring data of one simulation: survey progress, deployment
+ * conditions and the stores of reports. (Survey dates and enabled measures
+ * are configuration, which the initialisation functions below re-read.)
+ *
+ * Functions of the mon package use the current state. SimulationContext
+ * owns one and makes it current; otherwise (e.g. in unit tests) a default
+ * state is used. */
+class State {
+public:
+    State();
+    /// Makes the default state current if this one is
+    ~State();
+    
+    /// Use this state from now on
+    void makeCurrent();
+    
+private:
+    State( const State& ) = delete;
+    State& operator=( const State& ) = delete;
+    
+    std::unique_ptr<impl::StateData> data;
+};
 
 /// Read survey times from XML. Return the date of the final survey.
 SimDate readSurveyDates( const scnXml::Monitoring& monitoring );
@@ -53,6 +81,16 @@ void concludeSurvey();
 /// Write survey data to output.txt (or configured file)
 void writeSurveyData();
 
+/// Write survey data to a stream, in the same format as writeSurveyData()
+void writeToStream(std::ostream& stream);
+
+/** Get survey data without formatting: for each line of writeSurveyData()
+ * output, in the same order, append the survey number, group (age group or
+ * other category), output measure number and value to the respective
+ * vectors, whose previous content is discarded. */
+void getResults(std::vector<int>& survey, std::vector<int>& group,
+        std::vector<int>& measure, std::vector<double>& value);
+
 // Checkpointing
 void checkpoint( std::ostream& stream );
 void checkpoint( std::istream& stream );
@@ -62,6 +100,10 @@ namespace internal{
     // Write results to stream
     void write( std::ostream& stream );
     
+    /** Sum reports held in shards (see ShardScope) into the stores. Must not
+     * be called while any ShardScope exists. */
+    void mergeShards();
+    
     /** Get the output cohort set numeric identifier given the internal one
      * (as returned by Survey::updateCohortSet()). */
     uint32_t cohortSetOutputId( uint32_t cohortSet );
@@ -22,6 +22,7 @@
 #include "mon/management.h"
 #include "mon/AgeGroup.h"
 #include "mon/reporting.h"
+#include "Clinical/Episode.h"
 #include "interventions/InterventionManager.hpp"
 #include "util/CommandLine.h"
 #include "util/errors.h"
@@ -52,7 +53,6 @@ namespace impl{
     // Constants or defined during init:
     size_t nSurveys = 0;        // number of reported surveys
     size_t nCohorts = 1;     // default: just the whole population
-    extern size_t surveyIndex;     // index in surveyDates of next survey
     vector<SurveyDate> surveyDates;     // dates of surveys
 }
 
@@ -153,6 +153,7 @@ SimDate readSurveyDates( const scnXml::Monitoring& monitoring ){
         }
     }
     
+    impl::nCohorts = 1;
     if( monitoring.getCohorts().present() ){
         // this needs to be set early, but we can't set cohortSubPopIds until after InterventionManager is initialised
         impl::nCohorts = static_cast<uint32_t>(1) << monitoring.getCohorts().get().getSubPop().size();
@@ -165,28 +166,30 @@ SimDate readSurveyDates( const scnXml::Monitoring& monitoring ){
 }
 
 void updateSurveyNumbers() {
-    if( impl::surveyIndex >= impl::surveyDates.size() ){
-        impl::survNumEvent = NOT_USED;
-        impl::survNumStat = NOT_USED;
-        impl::nextSurveyDate = SimDate::future();
+    impl::SurveyState& survey = *impl::surveyState;
+    if( survey.surveyIndex >= impl::surveyDates.size() ){
+        survey.survNumEvent = NOT_USED;
+        survey.survNumStat = NOT_USED;
+        survey.nextSurveyDate = SimDate::future();
     }else{
-        for( size_t i = impl::surveyIndex; i < impl::surveyDates.size(); ++i ){
-            impl::survNumEvent = impl::surveyDates[i].num;  // set to survey number or NOT_USED; this happens at least once!
-            if( impl::survNumEvent != NOT_USED ) break;        // stop at first reported survey
+        for( size_t i = survey.surveyIndex; i < impl::surveyDates.size(); ++i ){
+            survey.survNumEvent = impl::surveyDates[i].num;  // set to survey number or NOT_USED; this happens at least once!
+            if( survey.survNumEvent != NOT_USED ) break;        // stop at first reported survey
         }
-        const SurveyDate& nextSurvey = impl::surveyDates[impl::surveyIndex];
-        impl::survNumStat = nextSurvey.num;     // may be NOT_USED; this is intended
-        impl::nextSurveyDate = nextSurvey.date;
+        const SurveyDate& nextSurvey = impl::surveyDates[survey.surveyIndex];
+        survey.survNumStat = nextSurvey.num;     // may be NOT_USED; this is intended
+        survey.nextSurveyDate = nextSurvey.date;
     }
 }
 void initMainSim(){
-    impl::surveyIndex = 0;
-    impl::isInit = true;
+    impl::surveyState->surveyIndex = 0;
+    impl::surveyState->isInit = true;
     updateSurveyNumbers();
 }
 void concludeSurvey(){
+    Clinical::Episode::flushBuffered();
     updateConditions();
-    impl::surveyIndex += 1;
+    impl::surveyState->surveyIndex += 1;
     updateSurveyNumbers();
 }
 
@@ -266,6 +269,8 @@ bool notPowerOfTwo( uint32_t num ){
 // Init cohort sets. Depends on interventions (initialise those first).
 void initCohorts( const scnXml::Monitoring& monitoring )
 {
+    cohortSubPopNumbers.clear();
+    cohortSubPopIds.clear();
     if( monitoring.getCohorts().present() ){
         const scnXml::Cohorts monCohorts = monitoring.getCohorts().get();
         uint32_t nextId = 0;
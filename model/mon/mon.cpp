@@ -23,15 +23,19 @@
 #include "mon/management.h"
 #define H_OM_mon_cpp
 #include "mon/OutputMeasures.h"
+#include "mon/MonIndex.h"
 #include "WithinHost/Diagnostic.h"
 #include "WithinHost/Genotypes.h"
 #include "Clinical/ClinicalModel.h"
+#include "Clinical/Episode.h"
 #include "Host/Human.h"
 #include "util/errors.h"
 #include "schema/scenario.h"
 
 #include <typeinfo>
 #include <iostream>
+#include <memory>
+#include <mutex>
 
 namespace OM {
 namespace mon {
@@ -48,123 +52,56 @@ struct Condition {
 };
 
 namespace impl {
-    // Accumulators, variables:
-    bool isInit = false;
-    size_t surveyIndex = 0;     // index in surveyTimes of next survey
-    size_t survNumEvent = NOT_USED, survNumStat = NOT_USED;
-    SimDate nextSurveyDate = SimDate::future();
-    
-    vector<Condition> conditions;
+    // Whether each measure is used (set during initialisation)
+    bool usedMeasures[M_NUM] = {};
 }
 
-/// One of these is used for every output index, and is specific to a measure
-/// and repeated for every survey.
-struct MonIndex {
-    // Measure which this accepts.
-    Measure measure;
-    // Measure number used in output file
-    int outMeasure;
-    // Index of first item in result array
-    size_t offset;
-    // Number of categories. Must be > 0. If 1, index is set to zero, otherwise
-    // indices *should* be less than this.
-    // 
-    // nAges may include a final, unreported category.
-    size_t nAges, nCohorts, nSpecies, nGenotypes, nDrugs;
-    // Either Deploy::NA (not tracking deployments) or a binary 'or' of at
-    // least one of Deploy::TIMED, Deploy::CTS, Deploy::TREAT.
-    uint8_t deployMask;
-    
-    // Used to calculate next offset. This is max output of `index(...)` + 1.
-    inline size_t size() const{
-        return nAges * nCohorts * nSpecies * nGenotypes * nDrugs;
-    }
-    // Get the index in the result array to store this data at
-    // (age group, cohort, species, genotype, drug).
-    // 
-    // First index is `self.offset`, last is `self.offset + self.size() - 1`.
-    size_t index( size_t a, size_t c, size_t sp, size_t g, size_t d ) const{
-#ifndef NDEBUG
-        if( (nAges > 1 && a >= nAges) ||
-            (nCohorts > 1 && c >= nCohorts) ||
-            (nSpecies > 1 && sp >= nSpecies) ||
-            (nGenotypes > 1 && g >= nGenotypes) ||
-            (nDrugs > 1 && d >= nDrugs)
-        ){
-            cout << "Index out of bounds for age group\t" << a << " of " << nAges
-                << "\ncohort set\t" << c << " of " << nCohorts
-                << "\nspecies\t" << sp << " of " << nSpecies
-                << "\ngenotype\t" << g << " of " << nGenotypes
-                << "\ndrug\t" << d << " of " << nDrugs
-                << endl;
-        }
-#endif
-        // We use `a % nAges` etc. to enforce `a < nAges` and handle
-        // the case `nAges == 1` (i.e. classification is turned off).
-        return offset +
-            (d % nDrugs) + nDrugs *
-            ((g % nGenotypes) + nGenotypes *
-            ((sp % nSpecies) + nSpecies *
-            ((c % nCohorts) + nCohorts *
-            (a % nAges))));
-    }
-    
-    // Write out some data from results.
-    // 
-    // @param stream Data sink
-    // @param surveyNum Number to write in output (should start from 1 unlike in code)
-    // @param results Vector of results
-    // @param surveyStart Index in results where data for the current survey starts
-    template<typename T>
-    void write( ostream& stream, int surveyNum, const OutMeasure& om,
-            const vector<T>& results, size_t surveyStart ) const
-    {
-        assert(results.size() >= surveyStart + size());
-        // First age group starts at 1, unless there isn't an age group:
-        const int ageGroupAdd = om.byAge ? 1 : 0;
-        // Number of *reported* age categories: either no categorisation (1) or there is an extra unreported category
-        size_t nAgeCats = nAges == 1 ? 1 : nAges - 1;
-        if( om.bySpecies ){
-            assert( nAges == 1 && nCohorts == 1 && nDrugs == 1 );
-            for( size_t species = 0; species < nSpecies; ++species ){
-            for( size_t genotype = 0; genotype < nGenotypes; ++genotype ){
-                const int col2 = species + 1 +
-                    1000000 * genotype;
-                T value = results[surveyStart + index(0, 0, species, genotype, 0)];
-                stream << surveyNum << '\t' << col2 << '\t' << om.outId
-                    << '\t' << value << lineEnd;
-            } }
-        }else if( om.byDrug ){
-            assert( nSpecies == 1 && nGenotypes == 1 );
-            for( size_t cohortSet = 0; cohortSet < nCohorts; ++cohortSet ){
-            // Last age category is not reported
-            for( size_t ageGroup = 0; ageGroup < nAgeCats; ++ageGroup ){
-            for( size_t drug = 0; drug < nDrugs; ++drug ){
-                // Yeah, >999 age groups clashes with cohort sets, but unlikely a real issue
-                const int col2 = ageGroup + ageGroupAdd +
-                    1000 * internal::cohortSetOutputId( cohortSet ) +
-                    1000000 * (drug + 1);
-                T value = results[surveyStart + index(ageGroup, cohortSet, 0, 0, drug)];
-                stream << surveyNum << '\t' << col2 << '\t' << om.outId
-                    << '\t' << value << lineEnd;
-            } } }
-        }else{
-            assert( nSpecies == 1 && nDrugs == 1 );
-            for( size_t cohortSet = 0; cohortSet < nCohorts; ++cohortSet ){
-            // Last age category is not reported
-            for( size_t ageGroup = 0; ageGroup < nAgeCats; ++ageGroup ){
-            for( size_t genotype = 0; genotype < nGenotypes; ++genotype ){
-                // Yeah, >999 age groups clashes with cohort sets, but unlikely a real issue
-                const int col2 = ageGroup + ageGroupAdd +
-                    1000 * internal::cohortSetOutputId( cohortSet ) +
-                    1000000 * genotype;
-                T value = results[surveyStart + index(ageGroup, cohortSet, 0, genotype, 0)];
-                stream << surveyNum << '\t' << col2 << '\t' << om.outId
-                    << '\t' << value << lineEnd;
-            } } }
-        }
+template<typename T, typename F>
+void MonIndex::forEach( int surveyNum, const OutMeasure& om,
+        const vector<T>& results, size_t surveyStart, F f ) const
+{
+    assert(results.size() >= surveyStart + size());
+    // First age group starts at 1, unless there isn't an age group:
+    const int ageGroupAdd = om.byAge ? 1 : 0;
+    // Number of *reported* age categories: either no categorisation (1) or there is an extra unreported category
+    size_t nAgeCats = nAges == 1 ? 1 : nAges - 1;
+    if( om.bySpecies ){
+        assert( nAges == 1 && nCohorts == 1 && nDrugs == 1 );
+        for( size_t species = 0; species < nSpecies; ++species ){
+        for( size_t genotype = 0; genotype < nGenotypes; ++genotype ){
+            const int col2 = species + 1 +
+                1000000 * genotype;
+            T value = results[surveyStart + index(0, 0, species, genotype, 0)];
+            f( surveyNum, col2, om.outId, value );
+        } }
+    }else if( om.byDrug ){
+        assert( nSpecies == 1 && nGenotypes == 1 );
+        for( size_t cohortSet = 0; cohortSet < nCohorts; ++cohortSet ){
+        // Last age category is not reported
+        for( size_t ageGroup = 0; ageGroup < nAgeCats; ++ageGroup ){
+        for( size_t drug = 0; drug < nDrugs; ++drug ){
+            // Yeah, >999 age groups clashes with cohort sets, but unlikely a real issue
+            const int col2 = ageGroup + ageGroupAdd +
+                1000 * internal::cohortSetOutputId( cohortSet ) +
+                1000000 * (drug + 1);
+            T value = results[surveyStart + index(ageGroup, cohortSet, 0, 0, drug)];
+            f( surveyNum, col2, om.outId, value );
+        } } }
+    }else{
+        assert( nSpecies == 1 && nDrugs == 1 );
+        for( size_t cohortSet = 0; cohortSet < nCohorts; ++cohortSet ){
+        // Last age category is not reported
+        for( size_t ageGroup = 0; ageGroup < nAgeCats; ++ageGroup ){
+        for( size_t genotype = 0; genotype < nGenotypes; ++genotype ){
+            // Yeah, >999 age groups clashes with cohort sets, but unlikely a real issue
+            const int col2 = ageGroup + ageGroupAdd +
+                1000 * internal::cohortSetOutputId( cohortSet ) +
+                1000000 * genotype;
+            T value = results[surveyStart + index(ageGroup, cohortSet, 0, genotype, 0)];
+            f( surveyNum, col2, om.outId, value );
+        } } }
     }
-};
+}
 
 struct MonIndByMeasure{
     bool operator() (const MonIndex& i,const MonIndex& j) {
@@ -173,11 +110,39 @@ struct MonIndByMeasure{
     }
 } monIndByMeasure;
 
+/// Reports of one type accumulated in a shard (see ShardScope): for each
+/// survey reported to, a copy of that survey's slice of Store::reports.
+template<typename T>
+struct ShardSlices {
+    vector<pair<size_t, vector<T>>> slices;
+    
+    T* slice( size_t survey, size_t surveySize ){
+        // usually there are only one or two surveys (event and stat)
+        for( auto& s : slices ){
+            if( s.first == survey ) return s.second.data();
+        }
+        slices.emplace_back( survey, vector<T>( surveySize, 0 ) );
+        return slices.back().second.data();
+    }
+};
+struct Shard {
+    ShardSlices<int> ints;
+    ShardSlices<double> doubles;
+};
+
+namespace impl {
+    // Protects the list of shards (StateData::shards), not the shards
+    std::mutex shardsMutex;
+    // Shard of the current thread's ShardScope, if any
+    thread_local Shard* currentShard = nullptr;
+}
+
 // Store data of type T which is to be reported
 template<typename T>
 class Store{
 public:
-    Store() : surveySize(0) {}
+    explicit Store( ShardSlices<T> Shard::*shardSlices ) :
+        surveySize(0), shardSlices(shardSlices) {}
     
 private:
     // This lists all enabled outputs, sorted by `measure` (first field, of
@@ -190,15 +155,31 @@ private:
     typedef pair<uint16_t, uint16_t> MeasureRange;
     vector<MeasureRange> measure_map;
     
+    // Precompiled plans of measures accepting reports (deployMask is NA) and
+    // of measures accepting deployments, each grouped by measure. The maps
+    // give the range of plans for each measure (empty if none).
+    vector<IndexPlan> reportPlans, deployPlans;
+    vector<MeasureRange> reportMap, deployMap;
+    
     // Number of indices in `reports` used by a single survey
     size_t surveySize;
     // These are the stored reports (multidimensional; size is `size()` and
     // indices are `survey * surveySize + measures[m].index(...)` for some `m`).
     vector<T> reports;
     
+    // The slices in a Shard used by this store
+    ShardSlices<T> Shard::*shardSlices;
+    
     // get size of reports
     inline size_t size(){ return surveySize * impl::nSurveys; }
     
+    // Where reports for some survey go: the slice of `reports` or, within a
+    // ShardScope, the slice of the current shard
+    inline T* surveyReports( size_t survey ){
+        if( impl::currentShard == nullptr ) return &reports[survey * surveySize];
+        return (impl::currentShard->*shardSlices).slice( survey, surveySize );
+    }
+    
 public:
     // Set up ready to accept reports. The passed list includes all measures
     // used; we ignore those of the wrong type.
@@ -281,6 +262,19 @@ public:
                 measure_map[m].first = i;
             measure_map[m].second = i + 1;
         }
+        
+        reportPlans.clear();
+        deployPlans.clear();
+        reportMap.assign(M_NUM, make_pair(0, 0));
+        deployMap.assign(M_NUM, make_pair(0, 0));
+        for( const MonIndex& ind : measures ){
+            bool deploys = ind.deployMask != Deploy::NA;
+            vector<IndexPlan>& plans = deploys ? deployPlans : reportPlans;
+            MeasureRange& range = (deploys ? deployMap : reportMap)[ind.measure];
+            if( range.first == range.second ) range.first = plans.size();
+            plans.push_back( IndexPlan(ind) );
+            range.second = plans.size();
+        }
     }
     
     // Take a reported value and either store it or forget it.
@@ -289,19 +283,15 @@ public:
                  uint32_t cohortSet, size_t species, size_t genotype, size_t drug )
     {
         if( survey == NOT_USED ) return; // pre-main-sim & unit tests we ignore all reports
-        assert(measure < measure_map.size());
-        for( size_t i = measure_map[measure].first, end = measure_map[measure].second;
-            i < end; ++i )
-        {
-            assert(i < measures.size());
-            const MonIndex& ind = measures[i];
-            assert(ind.measure == measure);
-            if( ind.deployMask != Deploy::NA ) continue;        // skip measures tracking deployments
-            
-            size_t index = survey * surveySize +
-                    ind.index(ageIndex, cohortSet, species, genotype, drug);
-            assert( index < reports.size() );
-            reports[index] += val;
+        assert(measure < reportMap.size());
+        const MeasureRange range = reportMap[measure];
+        if( range.first == range.second ) return;       // not used
+        assert( survey < impl::nSurveys );
+        T* slice = surveyReports( survey );
+        for( size_t i = range.first; i < range.second; ++i ){
+            size_t index = reportPlans[i].index(ageIndex, cohortSet, species, genotype, drug);
+            assert( index < surveySize );
+            slice[index] += val;
         }
     }
     
@@ -313,22 +303,34 @@ public:
         if( survey == NOT_USED ) return; // pre-main-sim & unit tests we ignore all reports
         assert( method == Deploy::TIMED ||
             method == Deploy::CTS || method == Deploy::TREAT );
-        assert(measure < measure_map.size());
-        for( size_t i = measure_map[measure].first, end = measure_map[measure].second;
-            i < end; ++i )
-        {
-            assert(i < measures.size());
-            const MonIndex& ind = measures[i];
-            assert(ind.measure == measure);
-            // skip measures not tracking deployments or not tracking this type of deployment
-            if( (ind.deployMask & method) == Deploy::NA ) continue;
-            assert( ind.nSpecies == 1 && ind.nGenotypes == 1 );     // never used for deployments
+        assert(measure < deployMap.size());
+        const MeasureRange range = deployMap[measure];
+        if( range.first == range.second ) return;       // not used
+        assert( survey < impl::nSurveys );
+        T* slice = surveyReports( survey );
+        for( size_t i = range.first; i < range.second; ++i ){
+            const IndexPlan& plan = deployPlans[i];
+            // skip measures not tracking this type of deployment
+            if( (plan.deployMask & method) == Deploy::NA ) continue;
+            assert( plan.n[IndexPlan::SPECIES] == 1 && plan.n[IndexPlan::GENOTYPE] == 1 );     // never used for deployments
             
-            size_t index = survey * surveySize +
-                    ind.index(ageIndex, cohortSet, 0, 0, 0);
-            assert( index < reports.size() );
-            reports[index] += val;
+            size_t index = plan.index(ageIndex, cohortSet, 0, 0, 0);
+            assert( index < surveySize );
+            slice[index] += val;
+        }
+    }
+    
+    // Add the reports of a shard (and clear them). Must not be called
+    // while the shard may be in use.
+    void merge( Shard& shard ){
+        for( auto& s : (shard.*shardSlices).slices ){
+            assert( s.first < impl::nSurveys && s.second.size() == surveySize );
+            T* slice = &reports[s.first * surveySize];
+            for( size_t i = 0; i < surveySize; ++i ){
+                slice[i] += s.second[i];
+            }
         }
+        (shard.*shardSlices).slices.clear();
     }
     
     /// Get the sum of all reported values for some measure, method and survey.
@@ -366,15 +368,17 @@ public:
         return measure_map[measure].second > measure_map[measure].first;
     }
     
-    // Write stored values to stream for some output measure, om
-    void write( ostream& stream, size_t survey, const OutMeasure& om ){
+    // Pass stored values for some output measure, om, to f (see
+    // MonIndex::forEach)
+    template<typename F>
+    void forEach( size_t survey, const OutMeasure& om, F f ){
         assert(om.m < measure_map.size());
         for( size_t i = measure_map[om.m].first, end = measure_map[om.m].second;
             i < end; ++i )
         {
             assert(i < measures.size());
             if( measures[i].outMeasure == om.outId ){
-                measures[i].write( stream, survey + 1, om, reports, survey * surveySize );
+                measures[i].forEach( survey + 1, om, reports, survey * surveySize, f );
                 return;
             }
         }
@@ -403,12 +407,42 @@ public:
     }
 };
 
-// Enabled measures:
-vector<OutMeasure> reportedMeasures;
-// Stores of reported data by two different types:
-Store<int> storeI;
-Store<double> storeF;
-int reportIMR = -1; // special output for fitting
+namespace impl {
+    // Data of a mon::State
+    struct StateData {
+        SurveyState survey;
+        vector<Condition> conditions;
+        // Shards by index
+        vector<unique_ptr<Shard>> shards;
+        
+        // Enabled measures:
+        vector<OutMeasure> reportedMeasures;
+        // Stores of reported data by two different types:
+        Store<int> storeI{ &Shard::ints };
+        Store<double> storeF{ &Shard::doubles };
+        int reportIMR = -1; // special output for fitting
+    };
+    
+    StateData defaultState;
+    // The current state and its survey variables
+    StateData* state = &defaultState;
+    SurveyState* surveyState = &defaultState.survey;
+}
+
+State::State() : data( new impl::StateData() ) {}
+State::~State(){
+    if( impl::state == data.get() ){
+        impl::state = &impl::defaultState;
+        impl::surveyState = &impl::defaultState.survey;
+    }
+}
+void State::makeCurrent(){
+    impl::state = data.get();
+    impl::surveyState = &data->survey;
+}
+
+inline Store<int>& storeI(){ return impl::state->storeI; }
+inline Store<double>& storeF(){ return impl::state->storeF; }
 
 struct MeasureByOutId{
     bool operator() (const OutMeasure& i,const OutMeasure& j) {
@@ -416,14 +450,22 @@ struct MeasureByOutId{
     }
 } measureByOutId;
 
+// Update impl::usedMeasures after enabling measures in the stores
+void updateUsedMeasures(){
+    for( size_t m = 0; m < M_NUM; ++m ){
+        Measure measure = static_cast<Measure>(m);
+        impl::usedMeasures[m] = storeI().isUsed(measure) || storeF().isUsed(measure);
+    }
+}
+
 void initReporting( const scnXml::Scenario& scenario ){
     defineOutMeasures();        // set up namedOutMeasures
-    assert(reportedMeasures.empty());
+    assert(impl::state->reportedMeasures.empty());
     
     // First we put used measures in this list:
     const scnXml::MonitoringOptions& optsElt = scenario.getMonitoring().getSurveyOptions();
     // This should be an upper bound on the number of options we need:
-    reportedMeasures.reserve(optsElt.getOption().size() + namedOutMeasures.size());
+    impl::state->reportedMeasures.reserve(optsElt.getOption().size() + namedOutMeasures.size());
     
     set<int> outIds;    // all measure numbers used in output
     for( const scnXml::MonitoringOption& optElt : optsElt.getOption() ){
@@ -438,7 +480,7 @@ void initReporting( const scnXml::Scenario& scenario ){
         if( om.m >= M_NUM ){
             if( om.m == M_ALL_CAUSE_IMR ){
                 if( om.isDouble && !om.byAge && !om.byCohort && !om.bySpecies ){
-                    reportIMR = om.outId;
+                    impl::state->reportIMR = om.outId;
                 }else{
                     throw util::xml_scenario_error( "measure allCauseIMR does not support any categorisation" );
                 }
@@ -497,18 +539,19 @@ void initReporting( const scnXml::Scenario& scenario ){
         }
         outIds.insert( om.outId );
         
-        reportedMeasures.push_back( om );
+        impl::state->reportedMeasures.push_back( om );
     }
     
-    std::sort( reportedMeasures.begin(), reportedMeasures.end(), measureByOutId );
+    std::sort( impl::state->reportedMeasures.begin(), impl::state->reportedMeasures.end(), measureByOutId );
     
     size_t nSpecies = scenario.getEntomology().getVector().present() ?
         scenario.getEntomology().getVector().get().getAnopheles().size() : 1;
     size_t nDrugs = scenario.getPharmacology().present() ?
         scenario.getPharmacology().get().getDrugs().getDrug().size() : 1;
     
-    storeI.init( reportedMeasures, nSpecies, nDrugs );
-    storeF.init( reportedMeasures, nSpecies, nDrugs );
+    storeI().init( impl::state->reportedMeasures, nSpecies, nDrugs );
+    storeF().init( impl::state->reportedMeasures, nSpecies, nDrugs );
+    updateUsedMeasures();
 }
 
 size_t setupCondition( const string& measureName, double minValue,
@@ -524,8 +567,9 @@ size_t setupCondition( const string& measureName, double minValue,
     if( validCondMeasures.count(om.m) == 0 ){
         throw util::xml_scenario_error("cannot use measure " + string(measureName) + " as condition of deployment");
     }
-    if( om.isDouble ) storeF.enableCondition(om);
-    else storeI.enableCondition(om);
+    if( om.isDouble ) storeF().enableCondition(om);
+    else storeI().enableCondition(om);
+    updateUsedMeasures();
     
     Condition condition;
     condition.value = initialState;
@@ -534,79 +578,129 @@ size_t setupCondition( const string& measureName, double minValue,
     condition.method = om.method;
     condition.min = minValue;
     condition.max = maxValue;
-    impl::conditions.push_back(condition);
-    return impl::conditions.size() - 1;
+    impl::state->conditions.push_back(condition);
+    return impl::state->conditions.size() - 1;
+}
+
+ShardScope::ShardScope( size_t index ){
+    assert( impl::currentShard == nullptr );    // scopes may not be nested
+    std::lock_guard<std::mutex> lock( impl::shardsMutex );
+    if( impl::state->shards.size() <= index ) impl::state->shards.resize( index + 1 );
+    if( impl::state->shards[index] == nullptr ) impl::state->shards[index].reset( new Shard() );
+    impl::currentShard = impl::state->shards[index].get();
+}
+ShardScope::~ShardScope(){
+    impl::currentShard = nullptr;
+}
+bool reportingToShard(){
+    return impl::currentShard != nullptr;
+}
+
+void internal::mergeShards(){
+    assert( impl::currentShard == nullptr );
+    // Sum in index order so that results do not depend on thread scheduling
+    for( unique_ptr<Shard>& shard : impl::state->shards ){
+        if( shard == nullptr ) continue;
+        storeI().merge( *shard );
+        storeF().merge( *shard );
+    }
 }
 
 void updateConditions() {
-    for( Condition& cond : impl::conditions ){
+    internal::mergeShards();
+    for( Condition& cond : impl::state->conditions ){
         double val = cond.isDouble ?
-            storeF.get_sum( cond.measure, cond.method, impl::survNumStat ) :
-            storeI.get_sum( cond.measure, cond.method, impl::survNumStat );
+            storeF().get_sum( cond.measure, cond.method, impl::surveyState->survNumStat ) :
+            storeI().get_sum( cond.measure, cond.method, impl::surveyState->survNumStat );
         cond.value = (val >= cond.min && val <= cond.max);
     }
 }
 bool checkCondition( size_t conditionKey ){
-    assert( conditionKey < impl::conditions.size() );
-    return impl::conditions[conditionKey].value;
+    assert( conditionKey < impl::state->conditions.size() );
+    return impl::state->conditions[conditionKey].value;
 }
 
-void internal::write( ostream& stream ){
+// Pass each line of output to f(survey, group, measure, value), in order
+template<typename F>
+void forEachResult( F f ){
+    Clinical::Episode::flushBuffered();
+    internal::mergeShards();
     for( size_t survey = 0; survey < impl::nSurveys; ++survey ){
-        for( const OutMeasure& om : reportedMeasures ){
+        for( const OutMeasure& om : impl::state->reportedMeasures ){
             if( om.m >= M_NUM ){
                 // "Special" measures are not reported this way. The only such measure is IMR.
-                assert( om.m == M_ALL_CAUSE_IMR && reportIMR >= 0 );
+                assert( om.m == M_ALL_CAUSE_IMR && impl::state->reportIMR >= 0 );
                 continue;
             } else if( om.isDouble ) {
-                storeF.write( stream, survey, om );
+                storeF().forEach( survey, om, f );
             } else {
-                storeI.write( stream, survey, om );
+                storeI().forEach( survey, om, f );
             }
         }
     }
-    if( reportIMR >= 0 ){
+    if( impl::state->reportIMR >= 0 ){
         // Infant mortality rate is a single number, therefore treated specially.
         // It is calculated across the entire intervention period and used in
         // model fitting.
-        stream << 1 << "\t" << 1 << "\t" << reportIMR
-            << "\t" << Clinical::InfantMortality::allCause() << lineEnd;
+        f( 1, 1, impl::state->reportIMR, Clinical::InfantMortality::allCause() );
     }
 }
 
+void internal::write( ostream& stream ){
+    forEachResult( [&stream]( int survey, int group, int measure, auto value ){
+        stream << survey << '\t' << group << '\t' << measure
+            << '\t' << value << lineEnd;
+    } );
+}
+
+void getResults( vector<int>& survey, vector<int>& group,
+        vector<int>& measure, vector<double>& value )
+{
+    survey.clear();
+    group.clear();
+    measure.clear();
+    value.clear();
+    forEachResult( [&]( int s, int g, int m, double v ){
+        survey.push_back( s );
+        group.push_back( g );
+        measure.push_back( m );
+        value.push_back( v );
+    } );
+}
+
 // Report functions: each reports to all usable stores (i.e. correct data type
 // and where parameters don't have to be fabricated).
 // void reportMI( Measure measure, int val ){
-//     storeI.report( val, measure, impl::currentSurvey, 0, 0, 0, 0, 0 );
+//     storeI().report( val, measure, impl::currentSurvey, 0, 0, 0, 0, 0 );
 // }
 void reportEventMHI( Measure measure, const Host::Human& human, int val ){
-    const size_t survey = impl::survNumEvent;
+    const size_t survey = impl::surveyState->survNumEvent;
     const size_t ageIndex = human.monAgeGroup().i();
-    storeI.report( val, measure, survey, ageIndex, human.cohortSet(), 0, 0, 0 );
+    storeI().report( val, measure, survey, ageIndex, human.cohortSet(), 0, 0, 0 );
 }
 void reportStatMHI( Measure measure, const Host::Human& human, int val ){
-    const size_t survey = impl::survNumStat;
+    const size_t survey = impl::surveyState->survNumStat;
     const size_t ageIndex = human.monAgeGroup().i();
-    storeI.report( val, measure, survey, ageIndex, human.cohortSet(), 0, 0, 0 );
+    storeI().report( val, measure, survey, ageIndex, human.cohortSet(), 0, 0, 0 );
 }
 void reportMSACI( Measure measure, size_t survey,
                   AgeGroup ageGroup, uint32_t cohortSet, int val )
 {
-    storeI.report( val, measure, survey, ageGroup.i(), cohortSet, 0, 0, 0 );
+    storeI().report( val, measure, survey, ageGroup.i(), cohortSet, 0, 0, 0 );
 }
 void reportStatMHGI( Measure measure, const Host::Human& human, size_t genotype,
                  int val )
 {
-    const size_t survey = impl::survNumStat;
+    const size_t survey = impl::surveyState->survNumStat;
     const size_t ageIndex = human.monAgeGroup().i();
-    storeI.report( val, measure, survey, ageIndex, human.cohortSet(), 0, genotype, 0 );
+    storeI().report( val, measure, survey, ageIndex, human.cohortSet(), 0, genotype, 0 );
 }
 void reportStatMHPI( Measure measure, const Host::Human& human, size_t drugIndex,
                 int val )
 {
-    const size_t survey = impl::survNumStat;
+    const size_t survey = impl::surveyState->survNumStat;
     const size_t ageIndex = human.monAgeGroup().i();
-    storeI.report( val, measure, survey, ageIndex, human.cohortSet(), 0, 0, drugIndex );
+    storeI().report( val, measure, survey, ageIndex, human.cohortSet(), 0, 0, drugIndex );
 }
 // Deployment reporting uses a different function to handle the method
 // (mostly to make other types of report faster).
@@ -614,38 +708,38 @@ void reportEventMHD( Measure measure, const Host::Human& human,
                 Deploy::Method method )
 {
     const int val = 1;  // always report 1 deployment
-    const size_t survey = impl::survNumEvent;
+    const size_t survey = impl::surveyState->survNumEvent;
     size_t ageIndex = human.monAgeGroup().i();
-    storeI.deploy( val, measure, survey, ageIndex, human.cohortSet(), method );
+    storeI().deploy( val, measure, survey, ageIndex, human.cohortSet(), method );
     // This is for nTreatDeployments:
     measure = MHD_ALL_DEPLOYS;
-    storeI.deploy( val, measure, survey, ageIndex, human.cohortSet(), method );
+    storeI().deploy( val, measure, survey, ageIndex, human.cohortSet(), method );
 }
 
 void reportStatMF( Measure measure, double val ){
-    storeF.report( val, measure, impl::survNumStat, 0, 0, 0, 0, 0 );
+    storeF().report( val, measure, impl::surveyState->survNumStat, 0, 0, 0, 0, 0 );
 }
 void reportStatMHF( Measure measure, const Host::Human& human, double val ){
-    const size_t survey = impl::survNumStat;
+    const size_t survey = impl::surveyState->survNumStat;
     const size_t ageIndex = human.monAgeGroup().i();
-    storeF.report( val, measure, survey, ageIndex, human.cohortSet(), 0, 0, 0 );
+    storeF().report( val, measure, survey, ageIndex, human.cohortSet(), 0, 0, 0 );
 }
 void reportStatMACGF( Measure measure, size_t ageIndex, uint32_t cohortSet,
                   size_t genotype, double val )
 {
-    const size_t survey = impl::survNumStat;
-    storeF.report( val, measure, survey, ageIndex, cohortSet, 0, genotype, 0 );
+    const size_t survey = impl::surveyState->survNumStat;
+    storeF().report( val, measure, survey, ageIndex, cohortSet, 0, genotype, 0 );
 }
 void reportStatMACSGF( Measure measure, size_t ageIndex, uint32_t cohortSet,
                   size_t species, size_t genotype, double val )
 {
-    const size_t survey = impl::survNumStat;
-    storeF.report( val, measure, survey, ageIndex, cohortSet, species, genotype, 0 );
+    const size_t survey = impl::surveyState->survNumStat;
+    storeF().report( val, measure, survey, ageIndex, cohortSet, species, genotype, 0 );
 }
 void reportStatMHPF( Measure measure, const Host::Human& human, size_t drug, double val ){
-    const size_t survey = impl::survNumStat;
+    const size_t survey = impl::surveyState->survNumStat;
     const size_t ageIndex = human.monAgeGroup().i();
-    storeF.report( val, measure, survey, ageIndex, human.cohortSet(), 0, 0, drug );
+    storeF().report( val, measure, survey, ageIndex, human.cohortSet(), 0, 0, drug );
 }
 void reportStatMHGF( Measure measure, const Host::Human& human, size_t genotype,
                  double val )
@@ -654,37 +748,39 @@ void reportStatMHGF( Measure measure, const Host::Human& human, size_t genotype,
                  genotype, val );
 }
 void reportStatMSF( Measure measure, size_t species, double val ){
-    const size_t survey = impl::survNumStat;
-    storeF.report( val, measure, survey, 0, 0, species, 0, 0 );
+    const size_t survey = impl::surveyState->survNumStat;
+    storeF().report( val, measure, survey, 0, 0, species, 0, 0 );
 }
 void reportStatMSGF( Measure measure, size_t species, size_t genotype, double val ){
-    const size_t survey = impl::survNumStat;
-    storeF.report( val, measure, survey, 0, 0, species, genotype, 0 );
-}
-
-bool isUsedM( Measure measure ){
-    return storeI.isUsed(measure) || storeF.isUsed(measure);
+    const size_t survey = impl::surveyState->survNumStat;
+    storeF().report( val, measure, survey, 0, 0, species, genotype, 0 );
 }
 
 void checkpoint( ostream& stream ){
-    impl::isInit & stream;
-    impl::surveyIndex & stream;
-    impl::survNumEvent & stream;
-    impl::survNumStat & stream;
-    impl::nextSurveyDate & stream;
+    // buffered and sharded reports are not checkpointed
+    Clinical::Episode::flushBuffered();
+    internal::mergeShards();
+    
+    impl::SurveyState& survey = *impl::surveyState;
+    survey.isInit & stream;
+    survey.surveyIndex & stream;
+    survey.survNumEvent & stream;
+    survey.survNumStat & stream;
+    survey.nextSurveyDate & stream;
     
-    storeI.checkpoint(stream);
-    storeF.checkpoint(stream);
+    storeI().checkpoint(stream);
+    storeF().checkpoint(stream);
 }
 void checkpoint( istream& stream ){
-    impl::isInit & stream;
-    impl::surveyIndex & stream;
-    impl::survNumEvent & stream;
-    impl::survNumStat & stream;
-    impl::nextSurveyDate & stream;
+    impl::SurveyState& survey = *impl::surveyState;
+    survey.isInit & stream;
+    survey.surveyIndex & stream;
+    survey.survNumEvent & stream;
+    survey.survNumStat & stream;
+    survey.nextSurveyDate & stream;
     
-    storeI.checkpoint(stream);
-    storeF.checkpoint(stream);
+    storeI().checkpoint(stream);
+    storeF().checkpoint(stream);
 }
 
 }
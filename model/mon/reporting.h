@@ -242,9 +242,40 @@ void reportStatMSGF( Measure measure, size_t species, size_t genotype, double va
 void reportStatMACSGF( Measure measure, size_t ageIndex, uint32_t cohortSet,
                   size_t species, size_t genotype, double val );
 
-/// Query whether an output measure is used.
-/// This function is not fast, so it is recommended to cache the result.
-bool isUsedM( Measure measure );
+// Not 'private' but still not for use externally:
+namespace impl {
+    // Whether each measure is used (set during initialisation)
+    extern bool usedMeasures[M_NUM];
+}
+
+/// Query whether an output measure is used, i.e. whether reports of it are
+/// recorded. This is fast; call sites may use it to skip computing values
+/// which would be discarded (but not to skip random number draws).
+inline bool isUsedM( Measure measure ){
+    assert( measure < M_NUM );
+    return impl::usedMeasures[measure];
+}
+
+/** Directs reports made by the current thread to a private shard while in
+ * scope, so that humans may be updated concurrently without locking.
+ * 
+ * Shards are allocated on first use and summed into the stored reports in
+ * index order when a survey is concluded, a deployment condition is
+ * evaluated, or results are written or checkpointed; no scope may exist at
+ * these times. To keep results independent of thread scheduling, the index
+ * should identify a unit of work (e.g. the task index passed by
+ * util::TaskPool::forEach), not a thread. Scopes may not be nested. */
+class ShardScope {
+public:
+    explicit ShardScope( size_t index );
+    ~ShardScope();
+    
+    ShardScope( const ShardScope& ) = delete;
+    ShardScope& operator=( const ShardScope& ) = delete;
+};
+
+/// True while the current thread has a ShardScope
+bool reportingToShard();
 
 }
 }
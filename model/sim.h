@@ -318,6 +318,30 @@ inline SimTime mod_nn( const SimTime lhs, const SimTime rhs ){
 /** Encapsulates static variables: sim time. */
 class sim {
 public:
+    /** Time variables of one simulation. SimulationContext owns one and
+     * makes it current; other code (e.g. unit tests) uses a default
+     * instance. All time accessors below use the current state. */
+    struct State {
+        SimTime t0, t1;         // see ts0(), ts1()
+        SimTime interv;         // see intervTime()
+#ifndef NDEBUG
+        bool in_update = false; // only true during human/population/transmission update
+#endif
+        
+        State() = default;
+        /// Makes the default state current if this one is
+        ~State(){
+            if( s_state == this ) s_state = &s_defaultState;
+        }
+        
+        /// Use this state from now on
+        inline void makeCurrent(){ s_state = this; }
+        
+    private:
+        State( const State& ) = delete;
+        State& operator=( const State& ) = delete;
+    };
+    
     ///@brief Simulation constants
     //@{
     /// Number of days in a year; defined as 365 (leap years are not simulated).
@@ -346,16 +370,16 @@ public:
      * This is what is mostly used during an update. It is never negative and
      * increases throughout the simulation. */
     static inline SimTime ts0(){
-        assert(in_update);      // should only be used during updates
-        return s_t0;
+        assert(s_state->in_update);     // should only be used during updates
+        return s_state->t0;
     }
     /** Time at the end of a time step update.
      * 
      * During an update, ts0() + oneTS() = ts1(). Neither this nor ts0 should
      * be used outside of updates. */
     static inline SimTime ts1(){
-        assert(in_update);      // should only be used during updates
-        return s_t1;
+        assert(s_state->in_update);     // should only be used during updates
+        return s_state->t1;
     }
     /**
      * Time steps are mid-day to mid-day, and this is the time at mid-day (i.e.
@@ -365,15 +389,15 @@ public:
      * updates. Cannot be used during human or vector update.
      */
     static inline SimTime now(){
-        assert(!in_update);     // only for use outside of step updates
-        return s_t0;   // which is equal to s_t1 outside of updates, but that's a detail
+        assert(!s_state->in_update);    // only for use outside of step updates
+        return s_state->t0;    // which is equal to s_t1 outside of updates, but that's a detail
     }
     /** During updates, this is ts0; between, this is now. */
-    static inline SimTime nowOrTs0(){ return s_t0; }
+    static inline SimTime nowOrTs0(){ return s_state->t0; }
     /** During updates, this is ts1; between, this is now. */
-    static inline SimTime nowOrTs1(){ return s_t1; }
+    static inline SimTime nowOrTs1(){ return s_state->t1; }
     /** During updates, this is ts0; between, it is now - 1. */
-    static inline SimTime latestTs0(){ return s_t1 - SimTime::oneTS(); }
+    static inline SimTime latestTs0(){ return s_state->t1 - SimTime::oneTS(); }
     //@}
     
     ///@brief Access intervention-time variables
@@ -383,7 +407,7 @@ public:
     /// This equals (intervDate() - startDate()), but happens to be the most
     /// common way that intervention-period dates are used.
     static inline SimTime intervTime() {
-        return s_interv;
+        return s_state->interv;
     }
     
     /// The current date.
@@ -393,7 +417,7 @@ public:
     /// returns a large negative value.)
     /// 
     /// Intervention deployment times are relative to this date.
-    static inline SimDate intervDate(){ return s_start + s_interv; }
+    static inline SimDate intervDate(){ return s_start + s_state->interv; }
     //@}
     
 // private:
@@ -402,18 +426,18 @@ public:
     
     // Start of update: called by Simulator
     static inline void start_update(){
-        s_t1 += SimTime::oneTS();
+        s_state->t1 += SimTime::oneTS();
 #ifndef NDEBUG
-        in_update = true;
+        s_state->in_update = true;
 #endif
     }
     // End of update: called by Simulator
     static inline void end_update(){
 #ifndef NDEBUG
-        in_update = false;
+        s_state->in_update = false;
 #endif
-        s_t0 = s_t1;
-        s_interv += SimTime::oneTS();
+        s_state->t0 = s_state->t1;
+        s_state->interv += SimTime::oneTS();
     }
     
     // Scenario constants
@@ -422,14 +446,10 @@ public:
     
     static SimTime s_max_human_age;
     
-    // Global variables
-#ifndef NDEBUG
-    static bool in_update;       // only true during human/population/transmission update
-#endif
-    static SimTime s_t0;
-    static SimTime s_t1;
-    
-    static SimTime s_interv;
+    // Time variables: the current state, and that used when no
+    // SimulationContext has made its own current
+    static State* s_state;
+    static State s_defaultState;
     
     friend class Simulator;
     friend class ::UnittestUtil;
@@ -26,6 +26,7 @@
 #include "schema/healthSystem.h"
 
 /* Required by AgeGroupSplineInterpolation
+#include "util/GslWorkspaces.h"
 #include <gsl_interp.h>
 #include <gsl_spline.h>
 */
@@ -249,7 +250,7 @@ namespace OM { namespace util {
                 y.push_back( it->second );
             }
             
-            acc = gsl_interp_accel_alloc ();
+            accId = GslWorkspaces::newInterpAccelId();
             spline = gsl_spline_alloc (gsl_interp_cspline, 10);
             gsl_spline_init (spline, x.data(), y.data(), 10);
             
@@ -257,15 +258,15 @@ namespace OM { namespace util {
         }
         virtual ~AgeGroupSplineInterpolation() {
             gsl_spline_free (spline);
-            gsl_interp_accel_free (acc);
         }
         
         virtual double eval( double ageYears ) const{
-            return gsl_spline_eval( spline, ageYears, acc );
+            // the accelerator is mutable, so each thread uses its own
+            return gsl_spline_eval( spline, ageYears, GslWorkspaces::interpAccel( accId ) );
         }
         
     protected:
-        gsl_interp_accel *acc;
+        size_t accId;
         gsl_spline *spline;
     };
     */
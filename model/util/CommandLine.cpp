@@ -36,6 +36,12 @@ namespace OM { namespace util {
     string CommandLine::outputName;
     string CommandLine::ctsoutName;
     string CommandLine::checkpointFileName;
+    string CommandLine::validationCacheName;
+    string CommandLine::grammarCacheName;
+    size_t CommandLine::threads = 1;
+    size_t CommandLine::replicates = 0;
+    string CommandLine::timingsName;
+    size_t CommandLine::maxSteps = 0;
     
     string parseNextArg (int argc, char* argv[], int& i) {
 	++i;
@@ -49,6 +55,10 @@ namespace OM { namespace util {
 	string scenarioFile = "";
         outputName = "";
         ctsoutName = "";
+        validationCacheName = "";
+        grammarCacheName = "";
+        timingsName = "";
+        maxSteps = 0;
 #	ifdef OM_STREAM_VALIDATOR
 	string sVFile;
 #	endif
@@ -124,6 +134,51 @@ namespace OM { namespace util {
                 } else if (clo == "checkpoint-stop") {
 		    		options.set (CHECKPOINT);
                     options.set (CHECKPOINT_STOP);
+                } else if (clo == "threads") {
+                    string arg = parseNextArg (argc, argv, i);
+                    istringstream ss( arg );
+                    int n = -1;
+                    ss >> n;
+                    if( !ss || !ss.eof() || n < 0 )
+                        throw cmd_exception ("--threads: expected a non-negative integer");
+                    threads = n;
+                } else if (clo == "replicates") {
+                    string arg = parseNextArg (argc, argv, i);
+                    istringstream ss( arg );
+                    int n = -1;
+                    ss >> n;
+                    if( !ss || !ss.eof() || n < 1 )
+                        throw cmd_exception ("--replicates: expected a positive integer");
+                    replicates = n;
+                } else if (clo == "replicate-stats") {
+                    options.set (REPLICATE_STATS);
+                } else if (clo == "validation-cache") {
+                    if (validationCacheName != ""){
+                        throw cmd_exception ("--validation-cache argument may only be given once");
+                    }
+                    validationCacheName = parseNextArg (argc, argv, i);
+                } else if (clo == "grammar-cache") {
+                    if (grammarCacheName != ""){
+                        throw cmd_exception ("--grammar-cache argument may only be given once");
+                    }
+                    grammarCacheName = parseNextArg (argc, argv, i);
+                } else if (clo == "timings") {
+                    if (timingsName != ""){
+                        throw cmd_exception ("--timings argument may only be given once");
+                    }
+                    timingsName = parseNextArg (argc, argv, i);
+                } else if (clo == "max-steps") {
+                    string arg = parseNextArg (argc, argv, i);
+                    istringstream ss( arg );
+                    int n = -1;
+                    ss >> n;
+                    if( !ss || !ss.eof() || n < 1 )
+                        throw cmd_exception ("--max-steps: expected a positive integer");
+                    maxSteps = n;
+                } else if (clo == "lean-memory") {
+                    options.set (LEAN_MEMORY);
+                } else if (clo == "print-memory-usage") {
+                    options.set (PRINT_MEMORY_USAGE);
                 } else if (clo == "debug-vector-fitting") {
                     options.set (DEBUG_VECTOR_FITTING);
 #	ifdef OM_STREAM_VALIDATOR
@@ -216,6 +271,27 @@ namespace OM { namespace util {
 	    << "    --deprecation-warnings" << endl
 	    << "			Warn about the use of features deemed error-prone and where" << endl
 	    << "			more flexible alternatives are available." << endl
+	    << "    --threads N	Use up to N threads for independent parts of each time step" << endl
+	    << "			(0: one per hardware thread; default: 1). Results do not" << endl
+	    << "			depend on N." << endl
+	    << "    --replicates N	Run the scenario with N seeds, iseed to iseed+N-1, after" << endl
+	    << "			initialising once. Outputs are written per seed, e.g. to" << endl
+	    << "			output_seed1.txt. --threads gives the number of replicates" << endl
+	    << "			run at once (each replicate uses one thread)." << endl
+	    << "    --replicate-stats	With --replicates, also write the mean and variance over" << endl
+	    << "			replicates of each output to output_stats.txt." << endl
+	    << "    --validation-cache file" << endl
+	    << "			Record the content hash of each scenario which passes schema" << endl
+	    << "			validation in file, and skip validation of scenarios listed" << endl
+	    << "			there." << endl
+	    << "    --grammar-cache file" << endl
+	    << "			Validate against a pre-parsed scenario schema stored in file" << endl
+	    << "			(created from the current schema in the working directory" << endl
+	    << "			if missing or written by another version). Only the current" << endl
+	    << "			schema version is supported." << endl
+	    << "    --lean-memory	Allocate per-human drug and infectiousness state only while" << endl
+	    << "			it is in use. Results do not change; useful for large" << endl
+	    << "			populations." << endl
 	    << endl
 	    << "Debugging options:"<<endl
 	    << " -m --print-model	Print all model options with a non-default value and exit." << endl
@@ -238,6 +314,14 @@ namespace OM { namespace util {
 	    << "			Show details of vector-parameter fitting. The fitting methods used" <<endl
 	    << "			aren't guaranteed to work. If they don't, this output should help"<<endl
 	    << "			work out why."<<endl
+	    << "    --print-memory-usage"<<endl
+	    << "			Print approximate memory use per human, by sub-model, at the"<<endl
+	    << "			end of the simulation."<<endl
+	    << "    --timings file	Write the wall-clock time spent in each simulation phase and"<<endl
+	    << "			in each part of the time step to file (JSON)."<<endl
+	    << "    --max-steps N	Stop after N time steps (counted from the start of the"<<endl
+	    << "			warm-up) without writing outputs other than --timings; for"<<endl
+	    << "			benchmarking."<<endl
 #	ifdef OM_STREAM_VALIDATOR
 	    << "    --stream-validator PATH" <<endl
 	    << "			Use StreamValidator to validate against reference file PATH." <<endl
@@ -267,6 +351,10 @@ namespace OM { namespace util {
 	if (ctsoutName == ""){
             ctsoutName = "ctsout.txt";
         }
+	if (options[REPLICATE_STATS] && replicates == 0)
+	    throw cmd_exception ("--replicate-stats requires --replicates");
+	if (options[CHECKPOINT] && replicates > 0)
+	    throw cmd_exception ("--replicates may not be used with checkpointing");
 
 	return scenarioFile;
     }
@@ -285,6 +373,21 @@ namespace OM { namespace util {
 	return ret;
     }
     
+    string CommandLine::withSuffix (const string& fileName, const string& suffix) {
+	size_t dot = fileName.rfind ('.');
+	size_t sep = fileName.find_last_of ("/\\");
+	if (dot == string::npos || (sep != string::npos && dot < sep))
+	    return fileName + suffix;
+	return string (fileName, 0, dot) + suffix + string (fileName, dot);
+    }
+    
+    void CommandLine::setOutputSuffix (const string& suffix) {
+	outputName = withSuffix (outputName, suffix);
+	ctsoutName = withSuffix (ctsoutName, suffix);
+	if (timingsName != "")
+	    timingsName = withSuffix (timingsName, suffix);
+    }
+    
     /* These check parameters are as expected. They only really serve to make
      * sure important command-line parameters didn't change (and only in DEBUG mode)! */
     void CommandLine::staticCheckpoint (istream& stream) {
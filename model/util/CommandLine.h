@@ -61,6 +61,15 @@ namespace OM { namespace util {
             /** Print times of all surveys. */
             PRINT_SURVEY_TIMES,
             PRINT_GENOTYPES,
+            /** Reduce per-human memory use by allocating within-host state
+             * (drug models, lagged densities) only while in use. */
+            LEAN_MEMORY,
+            /** Print approximate memory use per human at the end of the
+             * simulation. */
+            PRINT_MEMORY_USAGE,
+            /** With --replicates, write the mean and variance over
+             * replicates of each output. */
+            REPLICATE_STATS,
 	    NUM_OPTIONS
 	};
 	
@@ -86,6 +95,55 @@ namespace OM { namespace util {
     static inline string getCheckpointName (){
         return checkpointFileName;
     }
+    
+    /** Get the name of the file listing scenarios already validated (empty
+     * if not used). */
+    static inline const string& getValidationCacheName (){
+        return validationCacheName;
+    }
+    
+    /** Get the name of the pre-parsed schema grammar file (empty if not
+     * used). */
+    static inline const string& getGrammarCacheName (){
+        return grammarCacheName;
+    }
+    
+    /** Set the name of the pre-parsed schema grammar file, as the
+     * --grammar-cache option does (used by the library). */
+    static inline void setGrammarCacheName (const string& name){
+        grammarCacheName = name;
+    }
+    
+    /** Get the number of threads to use (0 means one per hardware thread). */
+    static inline size_t getThreads (){
+        return threads;
+    }
+    
+    /** Get the number of replicates (seeds) to run, or 0 if not running
+     * replicates. */
+    static inline size_t getReplicates (){
+        return replicates;
+    }
+    
+    /** Get the name of the file to write phase timings to (empty if not
+     * used). */
+    static inline const string& getTimingsName (){
+        return timingsName;
+    }
+    
+    /** Get the number of time steps after which to stop, or 0 if the
+     * simulation should run to the end. */
+    static inline size_t getMaxSteps (){
+        return maxSteps;
+    }
+    
+    /** Return fileName with suffix inserted before the extension (if any):
+     * withSuffix("output.txt", "_2") is "output_2.txt". */
+    static string withSuffix (const string& fileName, const string& suffix);
+    
+    /** Add a suffix to the names of the output, ctsout and timings files
+     * (see withSuffix). */
+    static void setOutputSuffix (const string& suffix);
         
 	/** Looks through all command line options.
 	*
@@ -113,6 +171,12 @@ namespace OM { namespace util {
 	static string outputName;
     static string ctsoutName;
     static string checkpointFileName;
+    static string validationCacheName;
+    static string grammarCacheName;
+    static size_t threads;
+    static size_t replicates;
+    static string timingsName;
+    static size_t maxSteps;
     };
 } }
 #endif
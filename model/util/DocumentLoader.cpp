@@ -19,15 +19,164 @@
  */
 
 #include "util/DocumentLoader.h"
+#include "util/CommandLine.h"
 #include "util/errors.h"
+#include "util/version.h"
+
+#include <xercesc/dom/DOM.hpp>
+#include <xercesc/util/PlatformUtils.hpp>
+#include <xercesc/util/XMLUniDefs.hpp>
+#include <xercesc/util/BinFileInputStream.hpp>
+#include <xercesc/internal/BinFileOutputStream.hpp>
+#include <xercesc/framework/MemBufInputSource.hpp>
+#include <xercesc/framework/Wrapper4InputSource.hpp>
+#include <xercesc/framework/XMLGrammarPoolImpl.hpp>
+#include <xercesc/validators/common/Grammar.hpp>
+#include <xsd/cxx/xml/dom/bits/error-handler-proxy.hxx>
+#include <xsd/cxx/tree/error-handler.hxx>
 
 #include <iostream>
 #include <sstream>
 #include <fstream>
+#include <iterator>
 #include <map>
+#include <vector>
 
 namespace OM { namespace util {
 
+namespace {
+    /** Validating parser using a pre-parsed scenario grammar.
+     * 
+     * The grammar is read from a file written by a previous run of the same
+     * program and schema version, or otherwise parsed from the schema in the
+     * working directory and then written to the file.
+     * One instance is kept for the life of the process, so loading several
+     * documents parses the grammar only once. */
+    class GrammarCacheParser {
+    public:
+        explicit GrammarCacheParser (const string& cacheFile) : ehp (eh) {
+            using namespace xercesc;
+            XMLPlatformUtils::Initialize ();    // never terminated
+            pool.reset (new XMLGrammarPoolImpl (XMLPlatformUtils::fgMemoryManager));
+            
+            const XMLCh ls_id[] = { chLatin_L, chLatin_S, chNull };
+            DOMImplementation* impl = DOMImplementationRegistry::getDOMImplementation (ls_id);
+            parser.reset (impl->createLSParser (DOMImplementationLS::MODE_SYNCHRONOUS,
+                    0, XMLPlatformUtils::fgMemoryManager, pool.get()));
+            
+            // Same configuration as XSD uses, except that only the cached
+            // grammar is used (schemaLocation is ignored).
+            DOMConfiguration* conf = parser->getDomConfig ();
+            conf->setParameter (XMLUni::fgDOMComments, false);
+            conf->setParameter (XMLUni::fgDOMDatatypeNormalization, true);
+            conf->setParameter (XMLUni::fgDOMEntities, false);
+            conf->setParameter (XMLUni::fgDOMNamespaces, true);
+            conf->setParameter (XMLUni::fgDOMElementContentWhitespace, false);
+            conf->setParameter (XMLUni::fgDOMValidate, true);
+            conf->setParameter (XMLUni::fgXercesSchema, true);
+            conf->setParameter (XMLUni::fgXercesSchemaFullChecking, false);
+            conf->setParameter (XMLUni::fgXercesHandleMultipleImports, true);
+            conf->setParameter (XMLUni::fgXercesUseCachedGrammarInParse, true);
+            conf->setParameter (XMLUni::fgXercesLoadSchema, false);
+            conf->setParameter (XMLUni::fgXercesUserAdoptsDOMDocument, true);
+            conf->setParameter (XMLUni::fgDOMErrorHandler, &ehp);
+            
+            const string header = cacheHeader ();
+            if (isCurrentCache (cacheFile, header)) {
+                BinFileInputStream in (cacheFile.c_str());
+                if (!in.getIsOpen())
+                    throw xml_scenario_error ("unable to read grammar cache " + cacheFile);
+                vector<XMLByte> skip (header.size());
+                XMLSize_t n = 0;
+                while (n < skip.size()) {
+                    XMLSize_t r = in.readBytes (skip.data() + n, skip.size() - n);
+                    if (r == 0)
+                        throw xml_scenario_error ("unable to read grammar cache " + cacheFile);
+                    n += r;
+                }
+                pool->deserializeGrammars (&in);
+            } else {
+                // missing, or written by another program or schema version
+                ostringstream schema;
+                schema << "scenario_" << DocumentLoader::SCHEMA_VERSION << ".xsd";
+                if (!parser->loadGrammar (schema.str().c_str(), Grammar::SchemaGrammarType, true))
+                    throw xml_scenario_error ("unable to load schema " + schema.str());
+                eh.throw_if_failed<xsd::cxx::tree::parsing<char> > ();
+                BinFileOutputStream out (cacheFile.c_str());
+                if (!out.getIsOpen())
+                    throw xml_scenario_error ("unable to write grammar cache " + cacheFile);
+                out.writeBytes (reinterpret_cast<const XMLByte*>(header.data()), header.size());
+                pool->serializeGrammars (&out);
+            }
+            pool->lockPool ();
+        }
+        
+        unique_ptr<scnXml::Scenario> parse (const string& content, const string& name) {
+            using namespace xercesc;
+            MemBufInputSource source (reinterpret_cast<const XMLByte*>(content.data()),
+                    content.size(), name.c_str());
+            Wrapper4InputSource wrapper (&source, false);
+            eh.reset ();
+            xml_schema::dom::unique_ptr<DOMDocument> doc (parser->parse (&wrapper));
+            eh.throw_if_failed<xsd::cxx::tree::parsing<char> > ();
+            return scnXml::parseScenario (*doc);
+        }
+        
+    private:
+        /* First line of a cache file, identifying the program and schema
+         * versions which wrote it. */
+        static string cacheHeader () {
+            ostringstream header;
+            header << "OpenMalaria grammar cache " << semantic_version
+                << " schema " << DocumentLoader::SCHEMA_VERSION << '\n';
+            return header.str();
+        }
+        
+        static bool isCurrentCache (const string& cacheFile, const string& header) {
+            ifstream in (cacheFile.c_str(), ios::binary);
+            string start (header.size(), '\0');
+            in.read (&start[0], start.size());
+            return in.good() && start == header;
+        }
+        
+        xsd::cxx::tree::error_handler<char> eh;
+        xsd::cxx::xml::dom::bits::error_handler_proxy<char> ehp;
+        unique_ptr<xercesc::XMLGrammarPool> pool;
+        xml_schema::dom::unique_ptr<xercesc::DOMLSParser> parser;
+    };
+    unique_ptr<GrammarCacheParser> grammarCacheParser;
+    
+    /* FNV-1a hash of the document content. The program and schema versions
+     * are included since validation may differ between builds. */
+    string contentHash (const string& content) {
+        uint64_t hash = 14695981039346656037ull;
+        auto add = [&hash] (const string& s) {
+            for (unsigned char c : s) {
+                hash ^= c;
+                hash *= 1099511628211ull;
+            }
+        };
+        ostringstream salt;
+        salt << semantic_version << '/' << DocumentLoader::SCHEMA_VERSION << '/';
+        add (salt.str());
+        add (content);
+        ostringstream hex;
+        hex << std::hex << hash;
+        return hex.str();
+    }
+    
+    bool isValidated (const string& cacheFile, const string& hash) {
+        ifstream in (cacheFile.c_str());
+        string line;
+        while (getline (in, line)) {
+            if (line == hash)
+                return true;
+        }
+        return false;
+    }
+}
+
+
 void DocumentLoader::loadDocument (std::string lXmlFile){
     xmlFileName = lXmlFile;
     //Parses the document
@@ -43,17 +192,79 @@ void DocumentLoader::loadDocument (std::string lXmlFile){
 	string msg = "Error: unable to open "+lXmlFile;
 	throw util::xml_scenario_error (msg);
     }
-    scenario = scnXml::parseScenario (fileStream);
+    loadDocument (fileStream, lXmlFile);
     fileStream.close ();
+}
+
+void DocumentLoader::loadDocument (const char* buffer, size_t length){
+    xmlFileName = "";
+    istringstream stream (string (buffer, length), ios::binary);
+    loadDocument (stream, "scenario");
+}
+
+void DocumentLoader::copyDocument (const DocumentLoader& that){
+    xmlFileName = that.xmlFileName;
+    documentChanged = false;
+    scenario.reset (new scnXml::Scenario (*that.scenario));
+}
+
+void DocumentLoader::loadDocument (istream& stream, const string& name){
+    const string& validationCache = CommandLine::getValidationCacheName();
+    const string& grammarCache = CommandLine::getGrammarCacheName();
+    string hash;
+    if (validationCache.empty() && grammarCache.empty()) {
+        scenario = scnXml::parseScenario (stream);
+    } else {
+        string content ((istreambuf_iterator<char>(stream)), istreambuf_iterator<char>());
+        bool validated = false;
+        if (!validationCache.empty()) {
+            hash = contentHash (content);
+            validated = isValidated (validationCache, hash);
+        }
+        if (validated) {
+            // content identical to a document which passed validation
+            istringstream in (content);
+            scenario = scnXml::parseScenario (in, xml_schema::Flags::dont_validate);
+            hash.clear();       // nothing to record
+        } else if (!grammarCache.empty()) {
+            if (!grammarCacheParser)
+                grammarCacheParser.reset (new GrammarCacheParser (grammarCache));
+            scenario = grammarCacheParser->parse (content, name);
+        } else {
+            istringstream in (content);
+            scenario = scnXml::parseScenario (in);
+        }
+    }
     int scenarioVersion = scenario->getSchemaVersion();
     if (scenarioVersion < SCHEMA_VERSION) {
         // Don't bother aborting. Mostly if something really is incompatible
         // loading will not succeed anyway.
-        cerr<<"Warning: "<<lXmlFile<<" uses an old schema version (latest is "
+        cerr<<"Warning: "<<name<<" uses an old schema version (latest is "
             <<SCHEMA_VERSION<<")."<<endl;
     }
     if (scenarioVersion > SCHEMA_VERSION)
         throw util::xml_scenario_error ("Error: new schema version unsupported");
+    
+    if (!hash.empty()) {
+        ofstream out (validationCache.c_str(), ios::app);
+        out << hash << endl;
+    }
+}
+
+void DocumentLoader::setParameter (int number, double value){
+    scnXml::Parameters::ParameterSequence& paramSeq =
+        scenario->getModel().getParameters().getParameter();
+    for (auto it = paramSeq.begin(); it != paramSeq.end(); ++it) {
+        if (it->getNumber() == number) {
+            it->setValue (value);
+            return;
+        }
+    }
+    paramSeq.push_back (scnXml::Parameter (number, value));
+}
+
+void DocumentLoader::setSeed (int seed){
+    scenario->getModel().getParameters().setIseed (seed);
 }
 
 void DocumentLoader::saveDocument()
@@ -43,6 +43,24 @@ public:
     * Throws on failure. */
     void loadDocument(std::string);
     
+    /** @brief Reads the document from a memory buffer
+    * 
+    * The schema is looked up relative to the working directory.
+    * Throws on failure. */
+    void loadDocument(const char* buffer, size_t length);
+    
+    /** @brief Make this a copy of another loaded document
+    * 
+    * Allows running a scenario several times without re-parsing it. */
+    void copyDocument(const DocumentLoader& that);
+    
+    /** Set model parameter number to value in the document, adding the
+     * parameter if not already described. */
+    void setParameter(int number, double value);
+    
+    /// Set the seed of the master random number generator in the document.
+    void setSeed(int seed);
+    
     /** Save any changes which occurred to the document, if
         * documentChanged is true. */
     void saveDocument();
@@ -72,6 +90,9 @@ public:
     bool documentChanged;
 
 private:
+    /// Parse from stream; name is used in messages
+    void loadDocument(std::istream& stream, const std::string& name);
+    
     /// Sometimes used to save changes to the xml.
     std::string xmlFileName;
     
@@ -0,0 +1,84 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "util/GslWorkspaces.h"
+#include "util/errors.h"
+
+#include <gsl/gsl_integration.h>
+#include <gsl/gsl_interp.h>
+#include <atomic>
+#include <unordered_map>
+
+namespace OM { namespace util {
+
+namespace {
+    std::atomic<size_t> nextInterpAccelId(0);
+
+    struct Workspaces {
+        gsl_integration_workspace *integration = nullptr;
+        size_t integrationLimit = 0;
+        // Accelerators of splines this thread has evaluated. Splines are
+        // only created during initialisation, so this does not grow.
+        std::unordered_map<size_t, gsl_interp_accel*> interpAccels;
+
+        ~Workspaces(){
+            if( integration != nullptr ) gsl_integration_workspace_free( integration );
+            for( auto it = interpAccels.begin(); it != interpAccels.end(); ++it ){
+                gsl_interp_accel_free( it->second );
+            }
+        }
+    };
+
+    inline Workspaces& workspaces(){
+        thread_local Workspaces instance;
+        return instance;
+    }
+}
+
+gsl_integration_workspace* GslWorkspaces::integration( size_t limit ){
+    Workspaces& w = workspaces();
+    if( w.integrationLimit < limit ){
+        if( w.integration != nullptr ) gsl_integration_workspace_free( w.integration );
+        w.integration = gsl_integration_workspace_alloc( limit );
+        if( w.integration == nullptr ){
+            w.integrationLimit = 0;
+            throw TRACED_EXCEPTION( "unable to allocate GSL integration workspace", util::Error::GSL );
+        }
+        w.integrationLimit = limit;
+    }
+    return w.integration;
+}
+
+size_t GslWorkspaces::newInterpAccelId(){
+    return nextInterpAccelId.fetch_add( 1, std::memory_order_relaxed );
+}
+
+gsl_interp_accel* GslWorkspaces::interpAccel( size_t id ){
+    gsl_interp_accel*& acc = workspaces().interpAccels[id];
+    if( acc == nullptr ){
+        acc = gsl_interp_accel_alloc();
+        if( acc == nullptr ){
+            throw TRACED_EXCEPTION( "unable to allocate GSL interpolation accelerator", util::Error::GSL );
+        }
+    }
+    return acc;
+}
+
+} }
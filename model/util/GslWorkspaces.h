@@ -0,0 +1,53 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef Hmod_util_GslWorkspaces
+#define Hmod_util_GslWorkspaces
+
+#include <cstddef>
+
+struct gsl_integration_workspace;
+struct gsl_interp_accel;
+
+namespace OM { namespace util {
+
+/** Owns the mutable scratch objects GSL routines need (integration
+ * workspaces, interpolation accelerators).
+ *
+ * These must not be shared between threads, so each thread gets its own,
+ * allocated on first use and freed when the thread exits. Callers must not
+ * keep the returned pointers beyond the current call. */
+class GslWorkspaces {
+public:
+    /** Integration workspace of this thread holding at least limit
+     * intervals (the limit passed to gsl_integration_qag). */
+    static gsl_integration_workspace* integration( size_t limit );
+
+    /** Get a new identifier for use with interpAccel(). Identifiers are
+     * never re-used, so an accelerator never sees data of another spline. */
+    static size_t newInterpAccelId();
+
+    /** Interpolation accelerator of this thread for the interpolation
+     * object with identifier id (from newInterpAccelId()). */
+    static gsl_interp_accel* interpAccel( size_t id );
+};
+
+} }
+#endif
@@ -0,0 +1,51 @@
+/* This file is part of OpenMalaria.
+ * 
+ * Copyright (C) 2005-2015 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * 
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+
+#include "util/MemoryUsage.h"
+
+#include <algorithm>
+
+namespace OM { namespace util {
+
+MemoryUsage::MemoryUsage() :
+    human(0), transmission(0), withinHost(0), pkpd(0), yLag(0),
+    infIncidence(0), clinical(0), nHumans(0)
+{}
+
+size_t MemoryUsage::total() const{
+    return human + transmission + withinHost + pkpd + yLag + infIncidence + clinical;
+}
+
+void MemoryUsage::print( std::ostream& stream ) const{
+    const double n = std::max<size_t>( nHumans, 1 );
+    stream << "Approximate memory use per human (bytes), mean over "
+        << nHumans << " humans:" << std::endl
+        << "\thuman:\t\t" << human / n << std::endl
+        << "\ttransmission:\t" << transmission / n << std::endl
+        << "\twithin-host:\t" << withinHost / n << std::endl
+        << "\tPK/PD:\t\t" << pkpd / n << std::endl
+        << "\tlagged density:\t" << yLag / n << std::endl
+        << "\tinf. incidence:\t" << infIncidence / n << std::endl
+        << "\tclinical:\t" << clinical / n << std::endl
+        << "\ttotal:\t\t" << total() / n << std::endl;
+}
+
+} }
@@ -0,0 +1,55 @@
+/* This file is part of OpenMalaria.
+ * 
+ * Copyright (C) 2005-2015 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * 
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef Hmod_util_MemoryUsage
+#define Hmod_util_MemoryUsage
+
+#include <cstddef>
+#include <ostream>
+
+namespace OM { namespace util {
+
+/** Approximate heap and object memory used by humans, by sub-model.
+ * 
+ * Each model adds its own usage to the relevant field (units: bytes). Sizes
+ * are estimates: container capacities are counted, but not allocator
+ * overhead. */
+struct MemoryUsage {
+    MemoryUsage();
+    
+    size_t human;       ///< Human objects, excluding sub-models below
+    size_t transmission;        ///< Per-host transmission and intervention data
+    size_t withinHost;  ///< Within-host model objects and infections
+    size_t pkpd;        ///< PK/PD drug models
+    size_t yLag;        ///< Lagged densities used for infectiousness
+    size_t infIncidence;        ///< Infection incidence models
+    size_t clinical;    ///< Clinical (case management) models
+    size_t nHumans;     ///< Number of humans summed over
+    
+    /// Total of all sub-models (bytes)
+    size_t total() const;
+    
+    /// Print mean usage per human by sub-model
+    void print( std::ostream& stream ) const;
+};
+
+} }
+#endif
@@ -76,6 +76,11 @@ namespace OM { namespace util {
             ignoreOptions.insert("PROPHYLACTIC_DRUG_ACTION_MODEL");
             codeMap["VIVAX_SIMPLE_MODEL"] = VIVAX_SIMPLE_MODEL;
             codeMap["INDIRECT_MORTALITY_FIX"] = INDIRECT_MORTALITY_FIX;
+            codeMap["VECTOR_FAST_FITTING"] = VECTOR_FAST_FITTING;
+            codeMap["GENOTYPE_ALIAS_SAMPLING"] = GENOTYPE_ALIAS_SAMPLING;
+            codeMap["REMOVE_NEGLIGIBLE_DRUGS"] = REMOVE_NEGLIGIBLE_DRUGS;
+            codeMap["POPULATION_SKIP_SAMPLING"] = POPULATION_SKIP_SAMPLING;
+            codeMap["TABULATED_NORMAL_QUANTILES"] = TABULATED_NORMAL_QUANTILES;
 	}
 	
 	OptionCodes operator[] (const string s) {
@@ -241,6 +241,58 @@ namespace OM { namespace util {
          */
         CFR_PF_USE_HOSPITAL,
         
+        /** Fit vector emergence rates during initialisation by driving the
+         * mosquito model alone with human availability and infectiousness
+         * recorded over the last year of warm-up, then check the fit with a
+         * single year of the full simulation (falling back to the usual
+         * iterative fitting if this fails). This replaces most of the
+         * six-year iterations of the normal fitting procedure.
+         * 
+         * Requires vector model (otherwise has no effect). */
+        VECTOR_FAST_FITTING,
+        
+        /** Sample genotypes of new infections using alias tables: a static
+         * table over initial frequencies, and in tracking mode one table per
+         * mosquito species built each step from that species' EIR by
+         * genotype (the species being sampled first). Each sample then costs
+         * O(1) instead of O(number of genotypes).
+         * 
+         * The distribution sampled is unchanged, but the samples drawn differ
+         * from those without this option. Only has an effect with parasite
+         * genetics. */
+        GENOTYPE_ALIAS_SAMPLING,
+        
+        /** Remove a human's per-drug PK/PD state once its concentration has
+         * fallen below the drug's negligible_concentration and no doses are
+         * pending, instead of keeping it for the rest of the human's life.
+         * 
+         * Below that cutoff concentrations are already set to zero, so drug
+         * factors, concentrations and reported drug outputs are unchanged.
+         * Results differ only when the same drug is given again later:
+         * without this option the human keeps the PK parameters (volume of
+         * distribution, elimination rates) sampled at first use, with it new
+         * parameters are sampled. */
+        REMOVE_NEGLIGIBLE_DRUGS,
+        
+        /** Select humans for imported infections and timed (mass) deployments
+         * using a population-level RNG with geometric skips between selected
+         * humans (util::BernoulliSkip), instead of one Bernoulli draw from
+         * each human's RNG. Cost then scales with the number selected instead
+         * of population size, which matters for small rates.
+         * 
+         * Selection probabilities are unchanged but the humans selected
+         * differ from those without this option. */
+        POPULATION_SKIP_SAMPLING,
+        
+        /** In the descriptive infection model, sample the maximum density over
+         * the days of a time step using a tabulated (interpolated) inverse
+         * normal CDF (util::MaxNormalQuantileTable) instead of computing it
+         * for each infection and step.
+         * 
+         * Random number usage is unchanged; sampled log-densities differ by
+         * at most 1e-6 times the standard deviation of log-density. */
+        TABULATED_NORMAL_QUANTILES,
+        
 	// Used by tests; should be 1 more than largest option
 	NUM_OPTIONS,
         
@@ -0,0 +1,114 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "util/ObjectPool.h"
+
+#include <atomic>
+#include <new>
+
+namespace OM { namespace util {
+
+namespace {
+    // Size classes are multiples of ALIGN bytes up to MAX_SIZE; larger
+    // objects use the system allocator directly.
+    const size_t ALIGN = 16;
+    const size_t MAX_SIZE = 1024;
+    const size_t NUM_CLASSES = MAX_SIZE / ALIGN;
+
+    inline size_t sizeClass( size_t size ){
+        return (size + ALIGN - 1) / ALIGN - 1;
+    }
+
+    std::atomic<uint64_t> nFromSystem(0), nRecycled(0), nLarge(0);
+
+    // A free block stores a pointer to the next free block
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    // Set when the lists of this thread have been destroyed (at thread exit);
+    // trivially destructible so it may still be read afterwards.
+    thread_local bool listsDestroyed = false;
+
+    struct FreeLists {
+        FreeBlock* head[NUM_CLASSES] = {};
+
+        ~FreeLists(){
+            listsDestroyed = true;
+            for( size_t c = 0; c < NUM_CLASSES; ++c ){
+                while( head[c] != nullptr ){
+                    FreeBlock* block = head[c];
+                    head[c] = block->next;
+                    ::operator delete( block );
+                }
+            }
+        }
+    };
+
+    FreeLists* lists(){
+        if( listsDestroyed ) return nullptr;
+        thread_local FreeLists instance;
+        return &instance;
+    }
+}
+
+void* ObjectPool::allocate( size_t size ){
+    if( size == 0 || size > MAX_SIZE ){
+        nLarge.fetch_add( 1, std::memory_order_relaxed );
+        return ::operator new( size );
+    }
+    size_t c = sizeClass( size );
+    FreeLists* free = lists();
+    if( free != nullptr && free->head[c] != nullptr ){
+        FreeBlock* block = free->head[c];
+        free->head[c] = block->next;
+        nRecycled.fetch_add( 1, std::memory_order_relaxed );
+        return block;
+    }
+    nFromSystem.fetch_add( 1, std::memory_order_relaxed );
+    return ::operator new( (c + 1) * ALIGN );
+}
+
+void ObjectPool::release( void* block, size_t size ){
+    if( block == nullptr ) return;
+    FreeLists* free = lists();
+    if( size == 0 || size > MAX_SIZE || free == nullptr ){
+        ::operator delete( block );
+        return;
+    }
+    size_t c = sizeClass( size );
+    FreeBlock* freed = static_cast<FreeBlock*>( block );
+    freed->next = free->head[c];
+    free->head[c] = freed;
+}
+
+ObjectPool::Stats ObjectPool::stats(){
+    return Stats{ nFromSystem.load(), nRecycled.load(), nLarge.load() };
+}
+
+void ObjectPool::print( std::ostream& stream ){
+    Stats s = stats();
+    stream << "Pooled object allocations:" << std::endl
+        << "\tfrom system:\t" << s.fromSystem << std::endl
+        << "\trecycled:\t" << s.recycled << std::endl
+        << "\ttoo large:\t" << s.large << std::endl;
+}
+
+} }
@@ -0,0 +1,105 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef Hmod_util_ObjectPool
+#define Hmod_util_ObjectPool
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <ostream>
+#include <vector>
+
+namespace OM { namespace util {
+
+/** Recycles the storage of small objects which are frequently created and
+ * destroyed (e.g. per-human sub-models on birth and death, infections).
+ *
+ * Freed blocks are kept on per-thread free lists by size class and handed
+ * out again for the next object of the same size class, instead of going
+ * through the system allocator. Lists never shrink, so retained memory is
+ * bounded by the peak number of live objects. */
+class ObjectPool {
+public:
+    /// Allocate size bytes
+    static void* allocate( size_t size );
+    /// Release a block allocated with allocate(size)
+    static void release( void* block, size_t size );
+
+    /// Counts of allocations (summed over all threads)
+    struct Stats {
+        uint64_t fromSystem;    ///< blocks newly obtained from the system
+        uint64_t recycled;      ///< blocks re-used from a free list
+        uint64_t large;         ///< blocks too large to pool (always from the system)
+    };
+    static Stats stats();
+
+    /// Print statistics
+    static void print( std::ostream& stream );
+};
+
+/** Base class giving derived classes (including polymorphic ones, through a
+ * virtual destructor) storage from ObjectPool. */
+class PooledObject {
+public:
+    static void* operator new( size_t size ){
+        return ObjectPool::allocate( size );
+    }
+    static void operator delete( void* block, size_t size ){
+        ObjectPool::release( block, size );
+    }
+};
+
+/** Standard-library allocator with storage from ObjectPool, for the
+ * containers of per-human state (e.g. lists of infections or deployed
+ * interventions), which are freed on death and refilled after birth. */
+template<class T>
+class PoolAllocator {
+public:
+    typedef T value_type;
+
+    PoolAllocator() {}
+    template<class U>
+    PoolAllocator( const PoolAllocator<U>& ) {}
+
+    T* allocate( size_t n ){
+        return static_cast<T*>( ObjectPool::allocate( n * sizeof(T) ) );
+    }
+    void deallocate( T* p, size_t n ){
+        ObjectPool::release( p, n * sizeof(T) );
+    }
+
+    // All instances share the pool
+    template<class U>
+    bool operator==( const PoolAllocator<U>& ) const{ return true; }
+    template<class U>
+    bool operator!=( const PoolAllocator<U>& ) const{ return false; }
+};
+
+template<class T>
+using PooledVector = std::vector<T, PoolAllocator<T>>;
+template<class T>
+using PooledList = std::list<T, PoolAllocator<T>>;
+template<class K, class V>
+using PooledMap = std::map<K, V, std::less<K>, PoolAllocator<std::pair<const K, V>>>;
+
+} }
+#endif
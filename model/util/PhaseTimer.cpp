@@ -0,0 +1,89 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+
+#include "util/PhaseTimer.h"
+#include "util/errors.h"
+
+#include <fstream>
+
+namespace OM { namespace util {
+
+namespace {
+    const char* componentNames[PhaseTimer::NUM_COMPONENTS] = {
+        "monitoring",
+        "interventions",
+        "vectorUpdate",
+        "populationUpdate",
+        "transmissionUpdate"
+    };
+}
+
+PhaseTimer::PhaseTimer( bool enabled ) :
+    m_enabled(enabled), m_steps(0), m_humanSteps(0),
+    m_phaseStart(Clock::now()), m_last(m_phaseStart), m_phase(nullptr)
+{
+    for( size_t c = 0; c < NUM_COMPONENTS; ++c ) m_components[c] = 0.0;
+}
+
+void PhaseTimer::phase( const char* name ){
+    if( !m_enabled ) return;
+    Clock::time_point now = Clock::now();
+    if( m_phase != nullptr ){
+        double time = std::chrono::duration<double>( now - m_phaseStart ).count();
+        // a phase may be entered several times (e.g. transmission init)
+        bool found = false;
+        for( auto& p : m_phases ){
+            if( p.first == m_phase ){
+                p.second += time;
+                found = true;
+            }
+        }
+        if( !found ) m_phases.push_back( std::make_pair( std::string(m_phase), time ) );
+    }
+    m_phase = name;
+    m_phaseStart = now;
+}
+
+void PhaseTimer::write( const std::string& fileName ){
+    if( !m_enabled ) return;
+    phase( nullptr );
+
+    std::ofstream stream( fileName );
+    stream.precision( 9 );
+    stream << "{\n  \"steps\": " << m_steps
+        << ",\n  \"humanSteps\": " << m_humanSteps
+        << ",\n  \"phases\": {";
+    for( size_t i = 0; i < m_phases.size(); ++i ){
+        stream << (i == 0 ? "\n" : ",\n") << "    \"" << m_phases[i].first
+            << "\": " << m_phases[i].second;
+    }
+    stream << "\n  },\n  \"components\": {";
+    for( size_t c = 0; c < NUM_COMPONENTS; ++c ){
+        stream << (c == 0 ? "\n" : ",\n") << "    \"" << componentNames[c]
+            << "\": " << m_components[c];
+    }
+    stream << "\n  }\n}\n";
+    stream.close();
+    if( !stream )
+        throw base_exception( "unable to write " + fileName, Error::FileIO );
+}
+
+} }
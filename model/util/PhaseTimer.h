@@ -0,0 +1,86 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef Hmod_util_PhaseTimer
+#define Hmod_util_PhaseTimer
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace OM { namespace util {
+
+/** Records wall-clock time spent in simulation phases and in the parts of
+ * each time step, and writes it as JSON (see --timings and test/bench).
+ *
+ * When not enabled, all functions return immediately. */
+class PhaseTimer {
+public:
+    /// Parts of a time step
+    enum Component {
+        MONITORING,
+        INTERVENTIONS,
+        VECTOR_UPDATE,
+        POPULATION_UPDATE,
+        TRANSMISSION_UPDATE,
+        NUM_COMPONENTS
+    };
+
+    explicit PhaseTimer( bool enabled );
+
+    inline bool enabled() const { return m_enabled; }
+
+    /// End the current phase (if any) and start a phase called name
+    void phase( const char* name );
+
+    /// Start timing a step of nHumans humans
+    inline void startStep( size_t nHumans ){
+        if( !m_enabled ) return;
+        m_steps += 1;
+        m_humanSteps += nHumans;
+        m_last = Clock::now();
+    }
+    /// Add the time since the last call (or startStep) to component c
+    inline void lap( Component c ){
+        if( !m_enabled ) return;
+        Clock::time_point now = Clock::now();
+        m_components[c] += std::chrono::duration<double>( now - m_last ).count();
+        m_last = now;
+    }
+
+    /// End the current phase and write all times to fileName
+    void write( const std::string& fileName );
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    bool m_enabled;
+    uint64_t m_steps, m_humanSteps;
+    Clock::time_point m_phaseStart, m_last;
+    const char* m_phase;
+    std::vector<std::pair<std::string, double>> m_phases;   // in order
+    double m_components[NUM_COMPONENTS];
+};
+
+} }
+#endif
@@ -0,0 +1,146 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef Hmod_OM_util_SmallVector
+#define Hmod_OM_util_SmallVector
+
+#include "Global.h"
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+namespace OM {
+namespace util {
+
+/** A vector of trivially copyable elements which stores up to N elements
+ * inline (in the object itself), only allocating when it grows beyond this.
+ *
+ * Only the needed bits of the std::vector interface are implemented.
+ * Checkpoints use the same format as std::vector. */
+template<typename T, uint32_t N>
+class SmallVector {
+    static_assert( std::is_trivially_copyable<T>::value,
+                   "SmallVector only supports trivially copyable types" );
+public:
+    typedef T* iterator;
+    typedef const T* const_iterator;
+
+    SmallVector() : m_size(0), m_capacity(N) {}
+    SmallVector( const SmallVector& x ) : m_size(0), m_capacity(N) {
+        assign( x.begin(), x.end() );
+    }
+    SmallVector( SmallVector&& x ) : m_size(0), m_capacity(N) {
+        take( x );
+    }
+    SmallVector& operator= ( const SmallVector& x ){
+        if( this != &x ) assign( x.begin(), x.end() );
+        return *this;
+    }
+    SmallVector& operator= ( SmallVector&& x ){
+        if( this != &x ){
+            m_heap.reset();
+            m_capacity = N;
+            take( x );
+        }
+        return *this;
+    }
+
+    inline uint32_t size() const{ return m_size; }
+    inline bool empty() const{ return m_size == 0; }
+    inline uint32_t capacity() const{ return m_capacity; }
+    /// True when elements are stored inline (no allocated memory)
+    inline bool isInline() const{ return m_heap == nullptr; }
+
+    inline T* data(){ return m_heap ? m_heap.get() : m_inline; }
+    inline const T* data() const{ return m_heap ? m_heap.get() : m_inline; }
+    inline iterator begin(){ return data(); }
+    inline iterator end(){ return data() + m_size; }
+    inline const_iterator begin() const{ return data(); }
+    inline const_iterator end() const{ return data() + m_size; }
+
+    inline T& operator[]( uint32_t i ){ assert( i < m_size ); return data()[i]; }
+    inline const T& operator[]( uint32_t i ) const{ assert( i < m_size ); return data()[i]; }
+    inline T& back(){ assert( m_size > 0 ); return data()[m_size - 1]; }
+    inline const T& back() const{ assert( m_size > 0 ); return data()[m_size - 1]; }
+
+    inline void push_back( const T& x ){
+        if( m_size == m_capacity ) reserve( 2 * m_capacity );
+        data()[m_size++] = x;
+    }
+    inline void pop_back(){ assert( m_size > 0 ); --m_size; }
+    /// Remove all elements; keeps any allocated memory
+    inline void clear(){ m_size = 0; }
+
+    void reserve( uint32_t n ){
+        if( n <= m_capacity ) return;
+        std::unique_ptr<T[]> heap( new T[n] );
+        std::memcpy( heap.get(), data(), m_size * sizeof(T) );
+        m_heap = std::move( heap );
+        m_capacity = n;
+    }
+
+    void assign( const T* first, const T* last ){
+        uint32_t n = static_cast<uint32_t>( last - first );
+        m_size = 0;
+        reserve( n );
+        std::memcpy( data(), first, n * sizeof(T) );
+        m_size = n;
+    }
+
+    /// Checkpointing
+    void operator& (ostream& stream) {
+        using namespace OM::util::checkpoint;
+        static_cast<size_t>(m_size) & stream;
+        for( T& x : *this ) x & stream;
+    }
+    void operator& (istream& stream) {
+        using namespace OM::util::checkpoint;
+        size_t l;
+        l & stream;
+        validateListSize (l);
+        m_size = 0;
+        reserve( static_cast<uint32_t>(l) );
+        m_size = static_cast<uint32_t>(l);
+        for( T& x : *this ) x & stream;
+    }
+
+private:
+    // Move the contents of x, which is left empty; requires this to be empty
+    // with no allocated memory
+    void take( SmallVector& x ){
+        if( x.m_heap ){
+            m_heap = std::move( x.m_heap );
+            m_capacity = x.m_capacity;
+        }else{
+            std::memcpy( m_inline, x.m_inline, x.m_size * sizeof(T) );
+        }
+        m_size = x.m_size;
+        x.m_size = 0;
+        x.m_capacity = N;
+    }
+
+    uint32_t m_size, m_capacity;
+    std::unique_ptr<T[]> m_heap;    // null while elements are inline
+    T m_inline[N];
+};
+
+}
+}
+#endif
@@ -0,0 +1,108 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+
+#include "util/StepArena.h"
+
+#include <atomic>
+#include <memory>
+#include <optional>
+
+namespace OM { namespace util {
+
+namespace {
+    const size_t INITIAL_SIZE = 4096;
+
+    std::atomic<uint64_t> step(0), nSystemAllocs(0);
+
+    // Upstream of the monotonic resource: allocates from the system, counting
+    // the bytes obtained since the last reset
+    class CountingResource : public std::pmr::memory_resource {
+    public:
+        size_t bytes = 0;
+    protected:
+        void* do_allocate( size_t size, size_t alignment ) override {
+            bytes += size;
+            nSystemAllocs.fetch_add( 1, std::memory_order_relaxed );
+            return std::pmr::new_delete_resource()->allocate( size, alignment );
+        }
+        void do_deallocate( void* p, size_t size, size_t alignment ) override {
+            std::pmr::new_delete_resource()->deallocate( p, size, alignment );
+        }
+        bool do_is_equal( const std::pmr::memory_resource& other ) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    struct Arena {
+        uint64_t step = 0;
+        size_t size = 0;
+        std::unique_ptr<char[]> buffer;
+        CountingResource upstream;
+        std::optional<std::pmr::monotonic_buffer_resource> monotonic;
+
+        Arena(){
+            allocate( INITIAL_SIZE );
+        }
+
+        void allocate( size_t newSize ){
+            monotonic.reset();      // returns upstream blocks
+            size = newSize;
+            buffer.reset( new char[size] );
+            nSystemAllocs.fetch_add( 1, std::memory_order_relaxed );
+            upstream.bytes = 0;
+            monotonic.emplace( buffer.get(), size, &upstream );
+        }
+
+        void reclaim(){
+            if( upstream.bytes > 0 ) allocate( size + upstream.bytes );
+            else monotonic->release();
+        }
+    };
+
+    Arena& threadArena(){
+        thread_local Arena arena;
+        return arena;
+    }
+}
+
+std::pmr::memory_resource* StepArena::resource(){
+    Arena& arena = threadArena();
+    const uint64_t current = step.load( std::memory_order_relaxed );
+    if( arena.step != current ){
+        arena.reclaim();
+        arena.step = current;
+    }
+    return &*arena.monotonic;
+}
+
+void StepArena::nextStep(){
+    step.fetch_add( 1, std::memory_order_relaxed );
+}
+
+void StepArena::nextThreadStep(){
+    threadArena().reclaim();
+}
+
+uint64_t StepArena::systemAllocations(){
+    return nSystemAllocs.load();
+}
+
+} }
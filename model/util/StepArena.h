@@ -0,0 +1,57 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef Hmod_util_StepArena
+#define Hmod_util_StepArena
+
+#include <cstdint>
+#include <memory_resource>
+
+namespace OM { namespace util {
+
+/** Per-thread arenas for temporaries which live no longer than one time step
+ * (e.g. working copies made by the vector model each step).
+ *
+ * Use resource() as the allocator of std::pmr containers; allocation is a
+ * pointer increment and deallocation is a no-op. Everything handed out is
+ * reclaimed at once when the thread next uses its arena after nextStep().
+ * If a step needs more than the arena's buffer, the buffer is enlarged to
+ * the step's total when reclaimed, so in steady state steps do not touch the
+ * system allocator. Do not keep arena storage beyond the current step. */
+class StepArena {
+public:
+    /// Memory resource of the calling thread's arena
+    static std::pmr::memory_resource* resource();
+
+    /// Start a new step: storage from earlier steps may be re-used
+    static void nextStep();
+
+    /** Start a new step for the calling thread's arena only, e.g. between
+     * iterations of a loop run within one time step. No storage from this
+     * thread's arena may still be in use. */
+    static void nextThreadStep();
+
+    /// Number of allocations made from the system by arenas of all threads
+    static uint64_t systemAllocations();
+};
+
+} }
+#endif
@@ -0,0 +1,162 @@
+/* This file is part of OpenMalaria.
+ * 
+ * Copyright (C) 2005-2015 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * 
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "util/TaskPool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace OM { namespace util {
+
+namespace {
+    std::vector<std::thread> workers;
+    std::mutex poolMutex;
+    std::condition_variable workAvailable, workDone;
+    
+    // Current job; protected by poolMutex except for nextIndex
+    const std::function<void(size_t)>* job = nullptr;
+    size_t jobSize = 0;
+    std::atomic<size_t> nextIndex(0);
+    size_t nCompleted = 0;
+    size_t nActiveWorkers = 0;   // workers which have taken the current job
+    unsigned long jobGeneration = 0;
+    bool stopping = false;
+    std::vector<std::exception_ptr> errors;
+    
+    thread_local bool inTask = false;
+    
+    // Workers must be joined before static destruction of the above.
+    struct ShutdownOnExit {
+        ~ShutdownOnExit(){ TaskPool::shutdown(); }
+    } shutdownOnExit;
+    
+    /* Run tasks from the current job until none remain. Returns the number
+     * of tasks run. */
+    size_t runTasks( const std::function<void(size_t)>& task, size_t n ){
+        size_t nRun = 0;
+        inTask = true;
+        for( size_t i = nextIndex++; i < n; i = nextIndex++ ){
+            try{
+                task( i );
+            }catch( ... ){
+                errors[i] = std::current_exception();
+            }
+            ++nRun;
+        }
+        inTask = false;
+        return nRun;
+    }
+    
+    void workerMain(){
+        std::unique_lock<std::mutex> lock( poolMutex );
+        unsigned long seenGeneration = jobGeneration;
+        while( true ){
+            workAvailable.wait( lock, [&]{
+                return stopping || jobGeneration != seenGeneration; } );
+            if( stopping ) return;
+            seenGeneration = jobGeneration;
+            // The caller may have run all tasks and finished the job before
+            // this worker woke; only join a job which still has tasks left
+            // (the caller then waits for this worker before ending the job).
+            if( job == nullptr || nextIndex >= jobSize ) continue;
+            const std::function<void(size_t)>& task = *job;
+            const size_t n = jobSize;
+            ++nActiveWorkers;
+            
+            lock.unlock();
+            size_t nRun = runTasks( task, n );
+            lock.lock();
+            
+            // The job (and task) must outlive all workers which took it, even
+            // if they found no task left to run.
+            nCompleted += nRun;
+            --nActiveWorkers;
+            if( nCompleted == jobSize && nActiveWorkers == 0 )
+                workDone.notify_all();
+        }
+    }
+}
+
+void TaskPool::init( size_t nThreads ){
+    if( nThreads == 0 ) nThreads = std::thread::hardware_concurrency();
+    if( nThreads == 0 ) nThreads = 1;
+#   ifdef OM_STREAM_VALIDATOR
+    // StreamValidator needs values in a deterministic order
+    nThreads = 1;
+#   endif
+    
+    shutdown();
+    workers.reserve( nThreads - 1 );
+    for( size_t i = 1; i < nThreads; ++i )
+        workers.emplace_back( workerMain );
+}
+
+void TaskPool::shutdown(){
+    {
+        std::lock_guard<std::mutex> lock( poolMutex );
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for( std::thread& worker : workers )
+        worker.join();
+    workers.clear();
+    stopping = false;
+}
+
+size_t TaskPool::threads(){
+    return workers.size() + 1;
+}
+
+void TaskPool::forEach( size_t n, const std::function<void(size_t)>& task ){
+    if( workers.empty() || inTask || n <= 1 ){
+        for( size_t i = 0; i < n; ++i )
+            task( i );
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock( poolMutex );
+        job = &task;
+        jobSize = n;
+        nextIndex = 0;
+        nCompleted = 0;
+        errors.assign( n, std::exception_ptr() );
+        ++jobGeneration;
+    }
+    workAvailable.notify_all();
+    
+    size_t nRun = runTasks( task, n );
+    
+    std::unique_lock<std::mutex> lock( poolMutex );
+    nCompleted += nRun;
+    workDone.wait( lock, [&]{
+        return nCompleted == jobSize && nActiveWorkers == 0; } );
+    job = nullptr;
+    
+    for( const std::exception_ptr& e : errors ){
+        if( e ) std::rethrow_exception( e );
+    }
+}
+
+} }
@@ -0,0 +1,61 @@
+/* This file is part of OpenMalaria.
+ * 
+ * Copyright (C) 2005-2015 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * 
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef Hmod_util_TaskPool
+#define Hmod_util_TaskPool
+
+#include <cstddef>
+#include <functional>
+
+namespace OM { namespace util {
+
+/** A small pool of worker threads used to run independent tasks.
+ * 
+ * With one thread (the default) no workers are created and all tasks are run
+ * serially on the calling thread, in index order.
+ * 
+ * Tasks must only write state belonging to their own index; any combination
+ * of results should be done after forEach() returns, in index order, so that
+ * results do not depend on the number of threads used. */
+class TaskPool {
+public:
+    /** Set the number of threads to use, including the calling thread.
+     * Zero means use the number of hardware threads. May be called again to
+     * change the number of threads, but not while tasks are running. */
+    static void init( size_t nThreads );
+    
+    /** Stop and join all worker threads. */
+    static void shutdown();
+    
+    /** Number of threads which may run tasks concurrently (at least 1). */
+    static size_t threads();
+    
+    /** Call task(i) for each i in [0, n) and return once all calls have
+     * completed. The calling thread also runs tasks.
+     * 
+     * If called from within a task, the nested tasks are run serially.
+     * 
+     * If any task throws, remaining tasks may still run; the exception from
+     * the task with lowest index is rethrown. */
+    static void forEach( size_t n, const std::function<void(size_t)>& task );
+};
+
+} }
+#endif
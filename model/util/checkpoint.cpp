@@ -279,7 +279,7 @@ namespace OM { namespace util { namespace checkpoint {
         }
     }
 
-    void operator& (const map<interventions::ComponentId,SimTime>& x, ostream& stream) {
+    void operator& (const PooledMap<interventions::ComponentId,SimTime>& x, ostream& stream) {
         x.size() & stream;
         for(auto pos = x.begin (); pos != x.end() ; ++pos) {
             pos->first & stream;
@@ -287,7 +287,7 @@ namespace OM { namespace util { namespace checkpoint {
             t & stream;
         }
     }
-    void operator& (map<interventions::ComponentId,SimTime>& x, istream& stream) {
+    void operator& (PooledMap<interventions::ComponentId,SimTime>& x, istream& stream) {
         size_t l;
         l & stream;
         validateListSize (l);
@@ -26,6 +26,8 @@
 // otherwise "using ..." declaration in Global.h won't work
 #endif
 
+#include "util/ObjectPool.h"
+
 /** Provides some extra functions. See checkpoint.h. */
 namespace OM {
 namespace util {
@@ -50,15 +52,15 @@ namespace checkpoint {
         x.second & stream;
     }
     
-    template<class T>
-    void operator& (vector<T>& x, ostream& stream) {
+    template<class T, class A>
+    void operator& (vector<T,A>& x, ostream& stream) {
         x.size() & stream;
         for (T& y : x) {
             y & stream;
         }
     }
-    template<class T>
-    void operator& (vector<T>& x, istream& stream) {
+    template<class T, class A>
+    void operator& (vector<T,A>& x, istream& stream) {
         size_t l;
         l & stream;
         validateListSize (l);
@@ -68,8 +70,8 @@ namespace checkpoint {
         }
     }
     /// Version of above taking an element to initialize each element from.
-    template<class T>
-    void checkpoint (vector<T>& x, istream& stream, T templateInstance) {
+    template<class T, class A>
+    void checkpoint (vector<T,A>& x, istream& stream, T templateInstance) {
         size_t l;
         l & stream;
         validateListSize (l);
@@ -79,15 +81,15 @@ namespace checkpoint {
         }
     }
     
-    template<class T>
-    void operator& (list<T> x, ostream& stream) {
+    template<class T, class A>
+    void operator& (list<T,A> x, ostream& stream) {
         x.size() & stream;
         for (T& y : x) {
             y & stream;
         }
     }
-    template<class T>
-    void operator& (list<T>& x, istream& stream) {
+    template<class T, class A>
+    void operator& (list<T,A>& x, istream& stream) {
         size_t l;
         l & stream;
         validateListSize (l);
@@ -134,8 +136,8 @@ namespace checkpoint {
     void operator& (const map<double,double>& x, ostream& stream);
     void operator& (map<double, double>& x, istream& stream);
     
-    void operator& (const map<interventions::ComponentId,SimTime>& x, ostream& stream);
-    void operator& (map<interventions::ComponentId,SimTime>& x, istream& stream);
+    void operator& (const PooledMap<interventions::ComponentId,SimTime>& x, ostream& stream);
+    void operator& (PooledMap<interventions::ComponentId,SimTime>& x, istream& stream);
     
     void operator& (const multimap<double,double>& x, ostream& stream);
     void operator& (multimap<double, double>& x, istream& stream);
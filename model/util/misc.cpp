@@ -44,14 +44,9 @@ SimDate sim::s_end;
 
 SimTime sim::s_max_human_age;
 
-// Global variables
-#ifndef NDEBUG
-bool sim::in_update = false;
-#endif
-SimTime sim::s_t0;
-SimTime sim::s_t1;
-
-SimTime sim::s_interv;
+// Time variables
+sim::State sim::s_defaultState;
+sim::State* sim::s_state = &sim::s_defaultState;
 
 using util::CommandLine;
 
@@ -262,7 +257,7 @@ void sim::init( const scnXml::Scenario& scenario ){
         }
     }
     
-    sim::s_interv = SimTime::never();    // large negative number
+    sim::s_state->interv = SimTime::never();    // large negative number
     
     sim::s_end = mon::readSurveyDates( mon );
 }
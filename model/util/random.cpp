@@ -1,7 +0,0 @@
-#include "random.h"
-
-namespace OM{
-    namespace util {
-        MasterRng master_RNG(0, 0);
-    }
-}
\ No newline at end of file
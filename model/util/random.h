@@ -76,6 +76,15 @@ gsl_rng_type make_gsl_rng_type(T& rng) {
     };
 }
 
+/** Seed for a LocalRng, drawn from another RNG.
+ *
+ * A LocalRng constructed from a seed is identical to one constructed directly
+ * from the source RNG. Seeds allow drawing from the source sequentially but
+ * constructing generators later, e.g. on other threads. */
+struct RngSeed {
+    uint64_t s[4];
+};
+
 /// Our random number generator.
 template<class T>
 struct RNG {
@@ -101,6 +110,13 @@ struct RNG {
         m_gsl_gen.state = reinterpret_cast<void*>(&m_rng);
     }
     
+    /// Seed from a seed drawn by gen_rng_seed() (LocalRng only)
+    explicit RNG(const RngSeed& seed): m_rng(seed.s[0], seed.s[1], seed.s[2], seed.s[3]) {
+        m_gsl_type = make_gsl_rng_type(m_rng);
+        m_gsl_gen.type = &m_gsl_type;
+        m_gsl_gen.state = reinterpret_cast<void*>(&m_rng);
+    }
+    
     // Disable copying
     RNG(const RNG&) = delete;
     RNG& operator=(const RNG&) = delete;
@@ -140,6 +156,14 @@ struct RNG {
         return (high << 32) | low;
     }
     
+    /// Draw a seed for a LocalRng, consuming the same output as seeding
+    /// a LocalRng from this generator directly
+    RngSeed gen_rng_seed() {
+        RngSeed seed;
+        for( uint64_t& word : seed.s ) word = m_rng.gen_u64();
+        return seed;
+    }
+    
     ///@brief Random number distributions
     //@{
     /** Generate a random number in the range [0,1). */
@@ -255,8 +279,57 @@ private:
 typedef RNG<Xoshiro256P> LocalRng;
 typedef RNG<ChaCha<8>> MasterRng;
 
-/// The master RNG, used only for seeding local RNGs
-extern MasterRng master_RNG;
+/** Sampler for a sequence of independent Bernoulli trials with a common
+ * success probability p.
+ *
+ * Instead of drawing one variate per trial, the number of failures before
+ * each success is drawn from the geometric distribution, so only successes
+ * cost a random variate. Sweeps over many items with small p (e.g. a whole
+ * population) are then cheap. The successes depend only on the RNG state and
+ * p, not on what is done with the results. */
+class BernoulliSkip {
+public:
+    /// Largest number of failures returned by skip()
+    static constexpr size_t maxSkip = std::numeric_limits<size_t>::max() / 2;
+
+    BernoulliSkip( LocalRng& rng, double p ) : m_rng(rng), m_p(p),
+            m_logq(std::log1p(-p)), m_next(notDrawn)
+    {
+        assert( (std::isfinite)(p) );
+    }
+
+    /** Sample the number of failures before the next success (capped at
+     * maxSkip). Usage to visit successes among n items:
+     * @code
+     * for( size_t i = trials.skip(); i < n; i += 1 + trials.skip() )
+     * @endcode
+     * Do not mix with next() on the same object. */
+    inline size_t skip(){
+        if( m_p >= 1.0 ) return 0;
+        if( !(m_p > 0.0) ) return maxSkip;
+        // 1 - u is in (0,1], hence the log is finite and non-positive
+        double x = std::floor( std::log(1.0 - m_rng.uniform_01()) / m_logq );
+        return x < maxSkip ? static_cast<size_t>(x) : maxSkip;
+    }
+
+    /// Returns true if the next trial is a success
+    inline bool next(){
+        if( m_next == notDrawn ) m_next = skip();
+        if( m_next > 0 ){
+            m_next -= 1;
+            return false;
+        }
+        m_next = skip();
+        return true;
+    }
+
+private:
+    static constexpr size_t notDrawn = std::numeric_limits<size_t>::max();
+    
+    LocalRng& m_rng;
+    double m_p, m_logq;
+    size_t m_next;      // failures before the next success (for next())
+};
 
 } }
 #endif
@@ -22,6 +22,7 @@
 #include "util/errors.h"
 #include "util/random.h"
 #include <cmath>
+#include <sstream>
 
 namespace OM { namespace util {
 
@@ -161,5 +162,92 @@ double BetaSampler::sample(LocalRng& rng) const{
     }
 }
 
+void AliasSampler::setWeights( const vector<double>& weights ){
+    const size_t n = weights.size();
+    prob.resize( n );
+    alias.resize( n );
+    m_total = 0.0;
+    for( double w : weights ){
+        assert( w >= 0.0 );
+        m_total += w;
+    }
+    if( !(m_total > 0.0) ) return;
+    
+    // Scale so that the mean weight is 1, then pair each column with weight
+    // below 1 with one above 1 which tops it up.
+    vector<uint32_t> small, large;
+    small.reserve( n );
+    large.reserve( n );
+    const double scale = n / m_total;
+    for( size_t i = 0; i < n; ++i ){
+        prob[i] = weights[i] * scale;
+        alias[i] = i;
+        (prob[i] < 1.0 ? small : large).push_back( i );
+    }
+    while( !small.empty() && !large.empty() ){
+        uint32_t s = small.back(), l = large.back();
+        small.pop_back();
+        alias[s] = l;
+        prob[l] -= 1.0 - prob[s];
+        if( prob[l] < 1.0 ){
+            large.pop_back();
+            small.push_back( l );
+        }
+    }
+    // Remaining columns are full, up to rounding errors
+    for( uint32_t i : large ) prob[i] = 1.0;
+    for( uint32_t i : small ) prob[i] = 1.0;
+}
+
+double MaxNormalQuantileTable::exactQuantile( double u ) const{
+    return gsl_cdf_ugaussian_Pinv( pow( u, 1.0 / m_n ) );
+}
+
+void MaxNormalQuantileTable::init( int n, double tolerance ){
+    assert( n > 0 );
+    m_n = n;
+    m_nodes.resize( 2 * N_SEGMENTS * (N_STEPS + 1) );
+    // dz/du = u^(1/n - 1) / (n φ(z))
+    auto derivative = [n]( double u, double z ){
+        return pow( u, 1.0 / n - 1.0 ) / (n * gsl_ran_ugaussian_pdf( z ));
+    };
+    for( size_t seg = 0; seg < N_SEGMENTS; ++seg ){
+        const double lower = ldexp( 1.0, -2 - static_cast<int>(seg) );
+        const double step = lower / N_STEPS;
+        m_scale[seg] = N_STEPS / lower;
+        for( size_t i = 0; i <= N_STEPS; ++i ){
+            const double v = lower + i * step;
+            Node& l = m_nodes[seg * (N_STEPS + 1) + i];
+            l.z = exactQuantile( v );
+            l.dz = derivative( v, l.z ) * step;
+            // on the upper side x increases with v, thus decreases with u
+            Node& r = m_nodes[(N_SEGMENTS + seg) * (N_STEPS + 1) + i];
+            r.z = exactQuantile( 1.0 - v );
+            r.dz = -derivative( 1.0 - v, r.z ) * step;
+        }
+    }
+    
+    // Check the error within each interval (largest near the middle)
+    m_maxError = 0.0;
+    for( size_t seg = 0; seg < N_SEGMENTS; ++seg ){
+        const double step = ldexp( 1.0, -2 - static_cast<int>(seg) ) / N_STEPS;
+        for( size_t i = 0; i < N_STEPS; ++i ){
+            for( double t : { 0.25, 0.5, 0.75 } ){
+                const double v = ldexp( 1.0, -2 - static_cast<int>(seg) ) + (i + t) * step;
+                for( double u : { v, 1.0 - v } ){
+                    m_maxError = std::max( m_maxError,
+                            fabs( quantile( u ) - exactQuantile( u ) ) );
+                }
+            }
+        }
+    }
+    if( !(m_maxError <= tolerance) ){
+        ostringstream msg;
+        msg << "MaxNormalQuantileTable: interpolation error " << m_maxError
+            << " exceeds tolerance " << tolerance;
+        throw TRACED_EXCEPTION_DEFAULT( msg.str() );
+    }
+}
+
 
 } }
@@ -204,5 +204,100 @@ namespace OM { namespace util {
         double scale, shape;    // λ, k
     };
     
+    /** Sampler for a discrete distribution over indices 0..n-1 with given
+     * (non-negative) weights, using Walker's alias method (with Vose's
+     * construction). Construction is O(n), each sample O(1) and uses a single
+     * uniform variate. */
+    class AliasSampler {
+    public:
+        AliasSampler() : m_total(0.0) {}
+        
+        /** Build the table. Weights need not sum to one. If all weights are
+         * zero, total() is zero and sample() must not be called. */
+        void setWeights( const vector<double>& weights );
+        
+        /** Sample an index. */
+        inline size_t sample(LocalRng& rng) const{
+            assert( m_total > 0.0 );
+            const double u = rng.uniform_01() * prob.size();
+            size_t i = static_cast<size_t>( u );
+            if( i >= prob.size() ) i = prob.size() - 1;   // in case of rounding
+            return (u - i < prob[i]) ? i : alias[i];
+        }
+        
+        /// Sum of weights given to setWeights()
+        inline double total() const{ return m_total; }
+        
+    private:
+        vector<double> prob;    // probability of keeping column i
+        vector<uint32_t> alias; // alternative when not keeping column i
+        double m_total;
+    };
+    
+    /** Tabulated quantile function of the maximum of n standard normal
+     * samples, z(u) = Φ⁻¹(u^(1/n)), for sampling by inversion as in
+     * LocalRng::max_multi_log_normal without calls to pow and the inverse
+     * normal CDF.
+     * 
+     * Values are interpolated with cubic Hermite splines on a grid which is
+     * uniform within [2^e, 2^(e+1)] for each e, applied to min(u, 1-u), so
+     * that nodes get denser towards both tails where z diverges. Arguments
+     * closer than 2^-32 to 0 or 1 are computed exactly. */
+    class MaxNormalQuantileTable {
+    public:
+        MaxNormalQuantileTable() : m_n(0), m_maxError(numeric_limits<double>::quiet_NaN()) {}
+        
+        /** Build the table for the maximum of n samples. The interpolation
+         * error is measured between all nodes; throws if it exceeds
+         * tolerance (absolute error in z). */
+        void init( int n, double tolerance );
+        
+        /// Largest interpolation error found by init()
+        inline double maxError() const{ return m_maxError; }
+        
+        /// Evaluate z(u) for u in [0,1]
+        inline double quantile( double u ) const{
+            assert( m_n > 0 );
+            const bool upper = u >= 0.5;
+            const double v = upper ? 1.0 - u : u;     // exact for u >= 0.5
+            if( !(v >= V_MIN) ) return exactQuantile( u );
+            const int e = std::ilogb( v );    // v in [2^e, 2^(e+1))
+            const size_t seg = e <= -2 ? -2 - e : 0;  // v == 0.5 is the end of segment 0
+            double x = v * m_scale[seg] - N_STEPS;
+            size_t i = static_cast<size_t>( x );
+            if( i >= N_STEPS ) i = N_STEPS - 1;
+            const double t = x - i;
+            const Node* a = &m_nodes[((upper ? N_SEGMENTS : 0) + seg) * (N_STEPS + 1) + i];
+            const double s = 1.0 - t;
+            return s * s * ((1.0 + 2.0 * t) * a[0].z + t * a[0].dz)
+                + t * t * ((3.0 - 2.0 * t) * a[1].z - s * a[1].dz);
+        }
+        
+        /// Equivalent to LocalRng::max_multi_log_normal using this table
+        inline double max_multi_log_normal( LocalRng& rng, double start,
+                double meanlog, double stdlog ) const
+        {
+            double zval = quantile( rng.uniform_01() );
+            double multi_sample = exp(meanlog + stdlog * zval);
+            return std::max(start, multi_sample);
+        }
+        
+    private:
+        double exactQuantile( double u ) const;
+        
+        static const size_t N_STEPS = 32;       // intervals per segment
+        static const size_t N_SEGMENTS = 31;    // e = -2, ..., -32
+        static constexpr double V_MIN = 1.0 / 4294967296.0;    // 2^-32
+        
+        struct Node {
+            double z;   // z at node
+            double dz;  // derivative of z with respect to x (by interval)
+        };
+        int m_n;
+        vector<Node> m_nodes;   // (N_STEPS + 1) nodes per segment, lower side then upper
+        double m_scale[N_SEGMENTS];     // N_STEPS / 2^e
+        double m_maxError;
+    };
+    
 } }
 #endif
@@ -265,6 +265,14 @@ namespace vectors{
   /// Return sum of all elements
   double sum (const vecDay<double>& vec);
   
+  /** Rotate elements towards the front by n days, such that the element at
+   * index (i + n) mod size moves to index i. Used to relabel circular arrays
+   * indexed by time modulo their size. */
+  void rotate (vecDay<double>& vec, SimTime n);
+  
+  /// As above, rotating along the first dimension
+  void rotate (vecDay2D<double>& vec, SimTime n);
+  
   /** The inverse of logDFT (or an approximation, when N&lt;T or
    * tArray.size() ≠ T). Result may also be rotated.
    * 
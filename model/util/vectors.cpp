@@ -52,6 +52,22 @@ double vectors::sum (const vecDay<double>& vec) {
   return r;
 }
 
+void vectors::rotate (vecDay<double>& vec, SimTime n) {
+  if( vec.size() == SimTime::zero() ) return;
+  const vecDay<double> copy( vec );
+  for( SimTime i = SimTime::zero(); i < vec.size(); i += SimTime::oneDay() )
+    vec[i] = copy[mod_nn(i + n, vec.size())];
+}
+void vectors::rotate (vecDay2D<double>& vec, SimTime n) {
+  if( vec.size_all() == 0 ) return;
+  const vecDay2D<double> copy( vec );
+  for( SimTime i = SimTime::zero(); i < vec.size1(); i += SimTime::oneDay() ){
+    const SimTime j = mod_nn(i + n, vec.size1());
+    for( size_t k = 0; k < vec.size2(); ++k )
+      vec.at(i, k) = copy.at(j, k);
+  }
+}
+
 double vectors::sum (const gsl_vector *vec) {
   double r = 0.0;
   for(size_t i = 0; i < vec->size; ++i)
@@ -177,7 +177,18 @@ struct vector2D {
     }
     
     inline vec_t& internal_vec(){ return v; }
-    
+
+    /// True if no elements are stored
+    inline bool empty() const{ return v.empty(); }
+    /// Total number of elements (all dimensions)
+    inline size_t size_all() const{ return v.size(); }
+
+    /// Remove all elements and release their memory. The second dimension
+    /// (stride) is kept.
+    inline void clear(){
+        vec_t().swap( v );
+    }
+
     inline void set_all( val_t x ){
         v.assign( v.size(), x );
     }
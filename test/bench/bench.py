@@ -0,0 +1,334 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+# This file is part of OpenMalaria.
+#
+# Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+# Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+#
+# OpenMalaria is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2 of the License, or (at
+# your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+
+# Performance benchmarks (CMake target om_bench).
+#
+# Synthetic scenarios are derived from two box-test scenarios, varying one
+# property at a time along independent axes:
+#   population  population size
+#   timestep    1-day (scenarioMSAT) vs 5-day (scenarioGenotypes) base
+#   species     number of mosquito species
+#   genotypes   number of parasite genotypes (5-day base)
+#   pkpd        fraction of uncomplicated cases reaching a provider who
+#               treats with PK/PD drugs (1-day base)
+#   infection   Molineaux vs descriptive infections (5-day base)
+#
+# Each scenario is run for a fixed number of simulated years from the start
+# of the warm-up (openMalaria --max-steps), which exercises the same per-step
+# code as the main phase except for deployment of interventions. Results are
+# written as JSON: human-steps per second, peak resident set size and time
+# per phase and per part of the time step (from openMalaria --timings).
+# Compare two result files with util/compareBench.py.
+#
+# Example (from the build dir):
+#   ../test/bench/bench.py -e ./openMalaria -s schema/scenario_current.xsd -o bench.json
+
+import sys
+import os
+import re
+import copy
+import json
+import time
+import shutil
+import platform
+import tempfile
+import subprocess
+import xml.etree.ElementTree as ET
+from optparse import OptionParser
+
+testSrcDir = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+BASES = {1: "scenarioMSAT.xml", 5: "scenarioGenotypes.xml"}
+
+# Values of each axis; the first set is run by default, the second with --full
+AXES = [
+    ("population", [10000, 100000], [10000, 100000, 1000000]),
+    ("timestep", [1, 5], [1, 5]),
+    ("species", [1, 3, 6], [1, 3, 6, 12]),
+    ("genotypes", [2, 4, 16], [2, 4, 16, 64]),
+    ("pkpd", [0.0, 0.2, 0.8], [0.0, 0.2, 0.5, 0.8]),
+    ("infection", ["molineaux", "descriptive"], ["molineaux", "descriptive"]),
+]
+
+# Configuration varied by each axis
+DEFAULT = {"popSize": 10000, "interval": 1, "species": None,
+        "genotypes": None, "pkpd": None, "infection": "molineaux"}
+AXIS_BASE = {"genotypes": 5, "infection": 5}
+
+class BenchError(Exception):
+    pass
+
+
+# -----  Scenario generation  -----
+
+def setPopulation(root, n):
+    root.find("demography").set("popSize", str(n))
+
+def setSpecies(root, n):
+    vector = root.find("entomology/vector")
+    anopheles = vector.findall("anopheles")
+    names = [a.get("mosquito") for a in anopheles]
+    if n < len(anopheles):
+        removed = set(names[n:])
+        for parent in list(root.iter()):
+            for child in list(parent):
+                if child.get("mosquito") in removed:
+                    parent.remove(child)
+        return
+    # Add copies of existing species, with their intervention parameters
+    for i in range(len(anopheles), n):
+        src = names[i % len(names)]
+        name = "%s_%d" % (src, i)
+        for parent in list(root.iter()):
+            children = list(parent)
+            for j, child in enumerate(children):
+                if child.get("mosquito") == src:
+                    clone = copy.deepcopy(child)
+                    clone.set("mosquito", name)
+                    # keep elements of the same kind together
+                    last = j
+                    while last + 1 < len(children) and children[last + 1].tag == child.tag:
+                        last += 1
+                    parent.insert(list(parent).index(children[last]) + 1, clone)
+
+def setGenotypes(root, n):
+    genetics = root.find("parasiteGenetics")
+    if genetics is None:
+        raise BenchError("base scenario has no parasiteGenetics element")
+    count = 1
+    for locus in genetics.findall("locus"):
+        count *= len(locus.findall("allele"))
+    k = 0
+    while count * 2 <= n:
+        locus = ET.SubElement(genetics, "locus", name="bench%d" % k)
+        for allele in ["a", "b"]:
+            ET.SubElement(locus, "allele", name=allele, initialFrequency="0.5", fitness="1")
+        count *= 2
+        k += 1
+    if count != n:
+        raise BenchError("can't configure %d genotypes (base has %d)" % (n, count))
+
+def setTreatment(root, p):
+    found = False
+    for random in root.iter("random"):
+        outcomes = random.findall("outcome")
+        if any(o.get("name") == "formal" for o in outcomes):
+            for o in outcomes:
+                o.set("p", "%.10g" % (p if o.get("name") == "formal" else 1.0 - p))
+            found = True
+    if not found:
+        raise BenchError("base scenario has no 'formal' treatment provider outcome")
+
+def setInfection(root, model):
+    if model == "molineaux":
+        return
+    if model != "descriptive":
+        raise BenchError("unknown infection model: " + model)
+    options = root.find("model/ModelOptions")
+    for option in list(options):
+        if option.get("name", "").startswith("MOLINEAUX"):
+            options.remove(option)
+    # treatment with PK/PD drugs is not available with descriptive infections
+    interventions = root.find("interventions")
+    for changeHS in interventions.findall("changeHS"):
+        interventions.remove(changeHS)
+
+def generate(config, fileName):
+    base = os.path.join(testSrcDir, BASES[config["interval"]])
+    with open(base, "r") as f:
+        text = f.read()
+    m = re.search(r'xmlns:om="([^"]*)"', text)
+    if m is not None:
+        ET.register_namespace("om", m.group(1))
+    ET.register_namespace("xsi", "http://www.w3.org/2001/XMLSchema-instance")
+    root = ET.fromstring(text)
+    setPopulation(root, config["popSize"])
+    if config["species"] is not None:
+        setSpecies(root, config["species"])
+    if config["genotypes"] is not None:
+        setGenotypes(root, config["genotypes"])
+    if config["pkpd"] is not None:
+        setTreatment(root, config["pkpd"])
+    setInfection(root, config["infection"])
+    ET.ElementTree(root).write(fileName, encoding="UTF-8", xml_declaration=True)
+    m = re.search(r'(scenario_\w+\.xsd)', text)
+    return m.group(1) if m else None
+
+
+# -----  Running  -----
+
+def runOnce(options, scenario, schemaName, steps):
+    simDir = tempfile.mkdtemp(prefix="om-bench-")
+    try:
+        if schemaName is not None:
+            shutil.copy2(options.schema, os.path.join(simDir, schemaName))
+        cmd = [options.executable, "--scenario", scenario,
+                "--timings", "timings.json", "--max-steps", str(steps),
+                "--threads", str(options.threads)]
+        start = time.time()
+        proc = subprocess.Popen(cmd, cwd=simDir,
+                stdout=subprocess.DEVNULL, stderr=subprocess.PIPE)
+        rss = None
+        if hasattr(os, "wait4"):
+            stderr = proc.stderr.read()
+            pid, status, usage = os.wait4(proc.pid, 0)
+            proc.returncode = os.waitstatus_to_exitcode(status) if hasattr(os, "waitstatus_to_exitcode") else (status >> 8)
+            # ru_maxrss is in kilobytes on Linux, bytes on macOS
+            rss = usage.ru_maxrss / (1024.0 * 1024.0 if sys.platform == "darwin" else 1024.0)
+        else:
+            stderr = proc.communicate()[1]
+        wallTime = time.time() - start
+        if proc.returncode != 0:
+            raise BenchError("openMalaria exited with status %d:\n%s" %
+                    (proc.returncode, stderr.decode(errors="replace")))
+        with open(os.path.join(simDir, "timings.json"), "r") as f:
+            timings = json.load(f)
+    finally:
+        shutil.rmtree(simDir)
+    return wallTime, rss, timings
+
+def runConfig(options, name, config, workDir):
+    scenario = os.path.join(workDir, "scenario-%s.xml" % name)
+    schemaName = generate(config, scenario)
+    steps = int(round(options.years * 365 / config["interval"]))
+    best = None
+    for i in range(options.repeat):
+        wallTime, rss, timings = runOnce(options, scenario, schemaName, steps)
+        if best is None or wallTime < best[0]:
+            best = (wallTime, rss, timings)
+    wallTime, rss, timings = best
+    stepTime = sum(timings["components"].values())
+    return {
+        "popSize": config["popSize"],
+        "interval": config["interval"],
+        "steps": timings["steps"],
+        "humanSteps": timings["humanSteps"],
+        "wallTime": wallTime,
+        "humanStepsPerSecond": timings["humanSteps"] / stepTime if stepTime > 0 else None,
+        "peakRSSMiB": rss,
+        "phases": timings["phases"],
+        "components": timings["components"],
+    }
+
+def key(config):
+    return tuple(sorted(config.items()))
+
+def benchmarks(full):
+    for axis, quick, values in AXES:
+        for value in (values if full else quick):
+            config = dict(DEFAULT)
+            config["interval"] = AXIS_BASE.get(axis, config["interval"])
+            if axis == "population":
+                config["popSize"] = value
+            elif axis == "timestep":
+                config["interval"] = value
+            else:
+                config[axis] = value
+            yield "%s-%s" % (axis, value), axis, value, config
+
+def gitCommit():
+    try:
+        out = subprocess.check_output(["git", "rev-parse", "HEAD"],
+                cwd=testSrcDir, stderr=subprocess.DEVNULL)
+        return out.decode().strip()
+    except (OSError, subprocess.CalledProcessError):
+        return None
+
+def main(args):
+    parser = OptionParser(usage="Usage: %prog [options]")
+    parser.add_option("-e", "--executable", default="./openMalaria",
+            help="Path to the openMalaria executable (default: %default)")
+    parser.add_option("-s", "--schema", default="schema/scenario_current.xsd",
+            help="Path to the inlined scenario schema (default: %default)")
+    parser.add_option("-o", "--output", default="bench.json",
+            help="File to write results to (default: %default)")
+    parser.add_option("-f", "--filter", default=None,
+            help="Only run benchmarks with names matching this regular expression")
+    parser.add_option("-y", "--years", type="float", default=2.0,
+            help="Simulated years per run (default: %default)")
+    parser.add_option("-r", "--repeat", type="int", default=1,
+            help="Runs per benchmark; the fastest is reported (default: %default)")
+    parser.add_option("-t", "--threads", type="int", default=1,
+            help="Value of openMalaria --threads (default: %default)")
+    parser.add_option("--full", action="store_true", default=False,
+            help="Use the full set of axis values (including 1M humans; slow)")
+    parser.add_option("-l", "--list", action="store_true", default=False,
+            help="List benchmarks and exit")
+    (options, others) = parser.parse_args(args=args)
+    if others:
+        parser.print_usage()
+        return 1
+
+    selected = [b for b in benchmarks(options.full)
+            if options.filter is None or re.search(options.filter, b[0])]
+    if options.list:
+        for b in selected:
+            print(b[0])
+        return 0
+
+    options.executable = os.path.abspath(options.executable)
+    options.schema = os.path.abspath(options.schema)
+    if not os.path.isfile(options.executable):
+        print("can't find " + options.executable)
+        return 1
+    if not os.path.isfile(options.schema):
+        print("can't find " + options.schema)
+        return 1
+
+    report = {
+        "commit": gitCommit(),
+        "host": platform.node(),
+        "platform": platform.platform(),
+        "date": time.strftime("%Y-%m-%dT%H:%M:%S"),
+        "years": options.years,
+        "threads": options.threads,
+        "results": [],
+    }
+    failed = False
+    done = {}   # configurations shared by several axes are run once
+    workDir = tempfile.mkdtemp(prefix="om-bench-scenarios-")
+    try:
+        for name, axis, value, config in selected:
+            if key(config) not in done:
+                print("%-24s" % name, end="", flush=True)
+                try:
+                    done[key(config)] = runConfig(options, name, config, workDir)
+                    r = done[key(config)]
+                    print("%12.0f human-steps/s %10.1f MiB" %
+                            (r["humanStepsPerSecond"] or 0, r["peakRSSMiB"] or 0))
+                except BenchError as e:
+                    print("failed: " + str(e))
+                    failed = True
+                    continue
+            result = {"name": name, "axis": axis, "value": value}
+            result.update(done[key(config)])
+            report["results"].append(result)
+    finally:
+        shutil.rmtree(workDir)
+
+    with open(options.output, "w") as f:
+        json.dump(report, f, indent=2)
+    print("results written to " + options.output)
+    return 1 if failed else 0
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,132 @@
+/*
+ This file is part of OpenMalaria.
+
+ Copyright (C) 2005-2014 Swiss Tropical and Public Health Institute
+ Copyright (C) 2005-2014 Liverpool School Of Tropical Medicine
+
+ OpenMalaria is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or (at
+ your option) any later version.
+
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#ifndef Hmod_AnophelesFitSuite
+#define Hmod_AnophelesFitSuite
+
+#include <cxxtest/TestSuite.h>
+#include "UnittestUtil.h"
+#include "ExtraAsserts.h"
+#include "Transmission/Anopheles/AnophelesModel.h"
+
+#include <cmath>
+#include <vector>
+
+using Transmission::Anopheles::AnophelesModel;
+
+/** Tests fitting of emergence with AnophelesModel::initFastFit() (model
+ * option VECTOR_FAST_FITTING) against the usual iterative fitting, as driven
+ * by VectorModel::initIterate(), for one species of a vector scenario.
+ *
+ * Humans are represented by fixed per-day inputs with seasonal
+ * infectiousness, repeated every year, as initFastFit() assumes. */
+class AnophelesFitSuite : public CxxTest::TestSuite
+{
+public:
+    void setUp () {
+        UnittestUtil::initTime( 1 );
+        sim::end_update();      // initTime() leaves us within an update
+        WithinHost::Genotypes::initSingle();
+
+        double humanAvail, humanDf;
+        UnittestUtil::AnophelesModel_initFit( standard, N_HUMANS, humanAvail, humanDf );
+        UnittestUtil::AnophelesModel_initFit( fast, N_HUMANS, humanAvail, humanDf );
+        sum_avail.assign( SimTime::oneYear(), humanAvail );
+        sigma_df.assign( SimTime::oneYear(), humanDf );
+        sigma_dif.assign( SimTime::oneYear(), 1, 0.0 );
+        for( SimTime d = SimTime::zero(); d < SimTime::oneYear(); d += SimTime::oneDay() ){
+            const double kappa = 0.1 * (1.0 + 0.5 * cos( 2.0 * M_PI * d.inDays() / 365.0 ));
+            sigma_dif.at( d, 0 ) = humanDf * kappa;
+        }
+        start = sim::now();
+    }
+    void tearDown () {
+        UnittestUtil::initTime( 1 );
+    }
+
+    // Both methods fit the same emergence rates, matching forcedS_v
+    void testFastFit () {
+        // Standard: after (shortened) pre-initialisation, adjust emergence
+        // then run one year of stabilisation and five of data collection,
+        // until initIterate() is satisfied; then one more year
+        run( standard, SimTime::fromYearsI(5) );
+        int iterations = 0;
+        while( standard.initIterate() ){
+            TS_ASSERT( ++iterations <= 30 );
+            run( standard, SimTime::oneYear() + SimTime::fromYearsI(5) );
+        }
+        run( standard, SimTime::oneYear() );
+        TS_ASSERT( standard.initFastFitCheck() );
+
+        // Fast: the same pre-initialisation and final year, fitting between
+        resetTime();
+        run( fast, SimTime::fromYearsI(5) );
+        fast.initFastFit( sum_avail, sigma_df, sigma_dif, sigma_df );
+        run( fast, SimTime::oneYear() );
+        TS_ASSERT( fast.initFastFitCheck() );
+
+        // States at the same time of year, when fitted from the same data,
+        // differ only by the (negligible) transients of the first year
+        const util::vecDay<double>& standardRate =
+                UnittestUtil::AnophelesModel_mosqEmergeRate( standard );
+        const util::vecDay<double>& fastRate =
+                UnittestUtil::AnophelesModel_mosqEmergeRate( fast );
+        for( SimTime d = SimTime::zero(); d < SimTime::oneYear(); d += SimTime::oneDay() ){
+            TS_ASSERT_APPROX_TOL( fastRate[d], standardRate[d], 1e-6, 1e-6 );
+        }
+    }
+
+    // When transmission changes after fast fitting, initFastFitCheck() fails,
+    // so VectorModel falls back to iterative fitting
+    void testFastFitCheck () {
+        run( fast, SimTime::fromYearsI(5) );
+        fast.initFastFit( sum_avail, sigma_df, sigma_dif, sigma_df );
+        util::vectors::scale( sigma_dif, 1.5 );
+        run( fast, SimTime::oneYear() );
+        TS_ASSERT( !fast.initFastFitCheck() );
+    }
+
+private:
+    // Run m from sim::now() for duration, as the simulation does
+    void run( AnophelesModel& m, SimTime duration ){
+        vector<double> tsSigma_dif;
+        for( SimTime end = sim::now() + duration; sim::now() < end; ){
+            sim::start_update();
+            const SimTime d = mod_nn( sim::ts0(), SimTime::oneYear() );
+            tsSigma_dif.assign( &sigma_dif.at( d, 0 ), &sigma_dif.at( d, 0 ) + sigma_dif.size2() );
+            m.advancePeriod( sum_avail[d], sigma_df[d], tsSigma_dif, sigma_df[d], false );
+            sim::end_update();
+        }
+    }
+    // Go back to the time at the start of the test
+    void resetTime(){
+        UnittestUtil::incrTime( start - sim::now() );
+    }
+
+    static const int N_HUMANS = 1000;
+
+    AnophelesModel standard, fast;
+    SimTime start;
+    util::vecDay<double> sum_avail, sigma_df;
+    util::vecDay2D<double> sigma_dif;
+};
+
+#endif
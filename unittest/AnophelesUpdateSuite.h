@@ -0,0 +1,115 @@
+/*
+ This file is part of OpenMalaria.
+
+ Copyright (C) 2005-2014 Swiss Tropical and Public Health Institute
+ Copyright (C) 2005-2014 Liverpool School Of Tropical Medicine
+
+ OpenMalaria is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or (at
+ your option) any later version.
+
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#ifndef Hmod_AnophelesUpdateSuite
+#define Hmod_AnophelesUpdateSuite
+
+#include <cxxtest/TestSuite.h>
+#include "UnittestUtil.h"
+#include "ExtraAsserts.h"
+#include "Transmission/Anopheles/AnophelesModel.h"
+#include "util/random.h"
+
+#include <vector>
+
+using Transmission::Anopheles::AnophelesModel;
+
+/** Tests AnophelesModel::update(), which reuses fArray and ftauArray and
+ * keeps uninfected_v per day, against a direct recalculation of the
+ * difference equations on each day. */
+class AnophelesUpdateSuite : public CxxTest::TestSuite
+{
+public:
+    AnophelesUpdateSuite() : rng( 0, 721347520444481703 ) {}
+
+    void setUp () {
+        UnittestUtil::initTime( 1 );
+        UnittestUtil::setNumGenotypes( N_GENOTYPES );
+    }
+    void tearDown () {
+        WithinHost::Genotypes::initSingle();
+    }
+
+    // Over 240 days, i.e. many times the length of the day-indexed arrays
+    // (EIPDuration + mosqRestDuration), P_A and P_df change daily, every five
+    // days (as with a 5-day time step) and not at all for longer than
+    // EIPDuration, so that all of fArray and ftauArray are reused.
+    void testIncrementalUpdate () {
+        const SimTime tau = SimTime::fromDays( 3 ), theta_s = SimTime::fromDays( 10 );
+        AnophelesModel incremental, direct;
+        LocalRng rngInc( 1, 721347520444481703 ), rngDirect( 1, 721347520444481703 );
+        UnittestUtil::AnophelesModel_init( incremental, tau, theta_s, rngInc );
+        UnittestUtil::AnophelesModel_init( direct, tau, theta_s, rngDirect );
+
+        double P_A = 0.0, P_df = 0.0;
+        vector<double> P_dif( N_GENOTYPES );
+        vector<double> eirInc( N_GENOTYPES, 0.0 ), eirDirect( N_GENOTYPES, 0.0 );
+        for( int day = 0; day < 240; ++day ){
+            const int phase = (day / 40) % 3;  // 0: daily, 1: 5-daily, 2: constant
+            if( day % 40 == 0 || phase == 0 || (phase == 1 && day % 5 == 0) ){
+                P_A = 0.6 + 0.1 * rng.uniform_01();
+                P_df = 0.05 + 0.05 * rng.uniform_01();
+                for( size_t g = 0; g < N_GENOTYPES; ++g )
+                    P_dif[g] = 0.01 * P_df * rng.uniform_01();
+            }
+            const SimTime d0 = SimTime::fromDays( day );
+            incremental.update( d0, P_A, 0.2, 0.1, 0.0, P_df, P_dif, P_df,
+                    true, eirInc, 1.0 );
+            UnittestUtil::AnophelesModel_updateDirect( direct, d0, P_A, P_df,
+                    P_dif, P_df, eirDirect );
+            assertStateMatches( incremental, direct );
+        }
+        for( size_t g = 0; g < N_GENOTYPES; ++g ){
+            TS_ASSERT_APPROX_TOL( eirInc[g], eirDirect[g], REL_TOL, ABS_TOL );
+        }
+    }
+
+private:
+    // Compare N_v, O_v and S_v on all stored days, and uninfected_v with
+    // N_v minus the sum of O_v over genotypes
+    static void assertStateMatches( const AnophelesModel& incremental,
+            const AnophelesModel& direct ){
+        const util::vecDay<double>& N_v = UnittestUtil::AnophelesModel_N_v( direct );
+        const util::vecDay2D<double>& O_v = UnittestUtil::AnophelesModel_O_v( direct );
+        const util::vecDay2D<double>& S_v = UnittestUtil::AnophelesModel_S_v( direct );
+        for( SimTime t = SimTime::zero(); t < N_v.size(); t += SimTime::oneDay() ){
+            TS_ASSERT_APPROX_TOL( UnittestUtil::AnophelesModel_N_v( incremental )[t],
+                    N_v[t], REL_TOL, ABS_TOL );
+            double uninfected = N_v[t];
+            for( size_t g = 0; g < N_GENOTYPES; ++g ){
+                TS_ASSERT_APPROX_TOL( UnittestUtil::AnophelesModel_O_v( incremental ).at( t, g ),
+                        O_v.at( t, g ), REL_TOL, ABS_TOL );
+                TS_ASSERT_APPROX_TOL( UnittestUtil::AnophelesModel_S_v( incremental ).at( t, g ),
+                        S_v.at( t, g ), REL_TOL, ABS_TOL );
+                uninfected -= O_v.at( t, g );
+            }
+            TS_ASSERT_APPROX_TOL( UnittestUtil::AnophelesModel_uninfected_v( incremental )[t],
+                    uninfected, REL_TOL, ABS_TOL );
+        }
+    }
+
+    static const size_t N_GENOTYPES = 3;
+    static constexpr double REL_TOL = 1e-12, ABS_TOL = 1e-12;
+
+    LocalRng rng;
+};
+
+#endif
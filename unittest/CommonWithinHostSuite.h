@@ -0,0 +1,94 @@
+/*
+ This file is part of OpenMalaria.
+
+ Copyright (C) 2005-2014 Swiss Tropical and Public Health Institute
+ Copyright (C) 2005-2014 Liverpool School Of Tropical Medicine
+
+ OpenMalaria is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or (at
+ your option) any later version.
+
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#ifndef Hmod_CommonWithinHostSuite
+#define Hmod_CommonWithinHostSuite
+
+#include <cxxtest/TestSuite.h>
+#include "UnittestUtil.h"
+#include "WithinHost/CommonWithinHost.h"
+#include "util/random.h"
+
+#include <vector>
+
+using namespace OM::WithinHost;
+
+/** Tests CommonWithinHost::update() with the Molineaux infection model and
+ * PK/PD on a 5-day time step, where it updates each host daily within the
+ * step but skips days on which the host is quiet. */
+class CommonWithinHostSuite : public CxxTest::TestSuite
+{
+public:
+    void setUp () {
+        UnittestUtil::initTime( 5 );
+        UnittestUtil::PkPdSuiteSetup();
+        UnittestUtil::MolineauxWHM_setup( "original", false );
+        UnittestUtil::Infection_init_latentP_and_NaN();
+        UnittestUtil::CommonWithinHost_setup();
+        start = sim::ts0();
+    }
+    void tearDown () {
+        UnittestUtil::CommonWithinHost_setSkipQuietDays( true );
+        PkPd::LSTMDrugType::clear();
+        ModelOptions::reset();
+    }
+
+    // Results are bit-identical whether or not quiet days are skipped
+    void testSkipQuietDays () {
+        const std::vector<double> skipped = run( true );
+        const std::vector<double> full = run( false );
+        ETS_ASSERT_EQUALS( skipped.size(), full.size() );
+        for( size_t i = 0; i < full.size(); ++i ){
+            TS_ASSERT_EQUALS( skipped[i], full[i] );
+        }
+    }
+
+private:
+    // Update one host over 100 steps, returning its total density and
+    // cumulative density after each step, then a sample of its RNG. The host
+    // is quiet until its first infection reaches the blood stage, and again
+    // on any steps with only liver-stage infections before treatment at
+    // step 70 (drugs then stay until the end).
+    std::vector<double> run( bool skipQuietDays ){
+        UnittestUtil::CommonWithinHost_setSkipQuietDays( skipQuietDays );
+        UnittestUtil::incrTime( start - sim::ts0() );
+        LocalRng rng( 0, 721347520444481703 );
+        CommonWithinHost host( rng, 1.0 );
+        GenotypeWeights weights;
+        std::vector<double> result;
+        for( int step = 0; step < 100; ++step ){
+            const int nNewInfs = (step % 20 == 5 || step == 60 || step == 62) ? 1 : 0;
+            if( step == 70 ) host.treatPkPd( 1 /* sched2 */, 0 /* dosage1 */, AGE, 0.0 );
+            host.update( rng, nNewInfs, weights, AGE, 1.0 );
+            result.push_back( host.getTotalDensity() );
+            result.push_back( host.getCumulative_Y() );
+            UnittestUtil::incrTime( SimTime::oneTS() );
+        }
+        result.push_back( rng.uniform_01() );
+        return result;
+    }
+
+    static constexpr double AGE = 21.0;
+
+    SimTime start;
+};
+
+#endif
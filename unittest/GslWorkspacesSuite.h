@@ -0,0 +1,120 @@
+/*
+ This file is part of OpenMalaria.
+
+ Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+
+ OpenMalaria is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or (at
+ your option) any later version.
+
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#ifndef Hmod_GslWorkspacesSuite
+#define Hmod_GslWorkspacesSuite
+
+#include <cxxtest/TestSuite.h>
+#include "util/GslWorkspaces.h"
+#include "PkPd/LSTMModel.h"
+#include "WithinHost/Infection/DummyInfection.h"
+#include "UnittestUtil.h"
+#include <gsl/gsl_integration.h>
+#include <thread>
+#include <vector>
+
+using namespace OM;
+using namespace OM::PkPd;
+
+/** Checks that the drug models, which integrate with GSL, give the same
+ * results when run concurrently from several threads as when run serially. */
+class GslWorkspacesSuite : public CxxTest::TestSuite
+{
+public:
+    void setUp () {
+        UnittestUtil::initTime(1);
+        UnittestUtil::PkPdSuiteSetup();
+    }
+    void tearDown () {
+        LSTMDrugType::clear();
+    }
+
+    // One patient treated with piperaquine (three-compartment model) and
+    // artemether (conversion model); doses differ between patients so that
+    // integrations in different threads differ. Returns the drug factor of
+    // each day.
+    static std::vector<double> runPatient( size_t patient ){
+        const double bodymass = 50;
+        const size_t PPQ = LSTMDrugType::findDrug( "PPQ3" );
+        const size_t AR = LSTMDrugType::findDrug( "AR" );
+        LocalRng rng( patient, 721347520444481703 );
+        LSTMModel model;
+        unique_ptr<CommonInfection> inf( createDummyInfection( rng, 0 ) );
+        std::vector<double> factors;
+        for( size_t day = 0; day < 3; ++day ){
+            const double scale = 1.0 + 0.1 * patient;
+            UnittestUtil::medicate( rng, model, PPQ, scale * 18 * bodymass, 0.0 );
+            UnittestUtil::medicate( rng, model, AR, scale * 1.7 * bodymass, 0.0 );
+            UnittestUtil::medicate( rng, model, AR, scale * 1.7 * bodymass, 0.5 );
+            for( size_t i = 0; i < 2; ++i ){
+                factors.push_back( model.getDrugFactor( rng, inf.get(), bodymass ) );
+                model.decayDrugs( bodymass );
+            }
+        }
+        return factors;
+    }
+
+    void testConcurrentDrugFactors () {
+        const size_t N_THREADS = 8, N_PATIENTS = 40;
+        std::vector<std::vector<double>> serial( N_PATIENTS );
+        for( size_t p = 0; p < N_PATIENTS; ++p ) serial[p] = runPatient( p );
+
+        std::vector<std::vector<double>> parallel( N_PATIENTS );
+        std::vector<int> failed( N_THREADS, 0 );
+        std::vector<std::thread> threads;
+        for( size_t t = 0; t < N_THREADS; ++t ){
+            threads.emplace_back( [t, &parallel, &failed] () {
+                try{
+                    for( size_t p = t; p < N_PATIENTS; p += N_THREADS )
+                        parallel[p] = runPatient( p );
+                }catch( ... ){
+                    failed[t] = 1;
+                }
+            } );
+        }
+        for( std::thread& thread : threads ) thread.join();
+
+        for( size_t t = 0; t < N_THREADS; ++t ) TS_ASSERT_EQUALS( failed[t], 0 );
+        for( size_t p = 0; p < N_PATIENTS; ++p ){
+            TS_ASSERT_EQUALS( parallel[p].size(), serial[p].size() );
+            for( size_t i = 0; i < serial[p].size() && i < parallel[p].size(); ++i ){
+                // same operations in the same order: results must be identical
+                TS_ASSERT_EQUALS( parallel[p][i], serial[p][i] );
+            }
+        }
+    }
+
+    void testIntegrationWorkspacePerThread () {
+        gsl_integration_workspace *w = util::GslWorkspaces::integration( 100 );
+        TS_ASSERT( w->limit >= 100 );
+        TS_ASSERT_EQUALS( util::GslWorkspaces::integration( 10 ), w );
+        TS_ASSERT( util::GslWorkspaces::integration( 2000 )->limit >= 2000 );
+
+        gsl_integration_workspace *other = nullptr;
+        std::thread thread( [&other] () {
+            other = util::GslWorkspaces::integration( 100 );
+        } );
+        thread.join();
+        TS_ASSERT_DIFFERS( other, util::GslWorkspaces::integration( 100 ) );
+    }
+};
+
+#endif
@@ -0,0 +1,398 @@
+/*
+ This file is part of OpenMalaria.
+
+ Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+
+ OpenMalaria is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or (at
+ your option) any later version.
+
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/* Micro-benchmarks of the hottest within-host, PK/PD and vector model
+ * kernels, for measuring optimisations of these in isolation. Build and run
+ * with 'make om_microbench' (in the build dir); see --help for options.
+ *
+ * Each benchmark sets up a fixed-seed population of inputs (infections of
+ * staggered ages, medicated hosts, or the humans of a scenario) using the
+ * unit-test helpers, then times updating all of them; the reported time per
+ * item is thus an average over a stable distribution of inputs.
+ *
+ * Model state is process-global, and the scenario benchmarks (vector model,
+ * births) initialise it from a scenario (--scenario) which is only loaded
+ * once. These are therefore listed (and run) last.
+ * 
+ * Calls to the global operator new are counted and reported per item, to
+ * show allocation churn. Some benchmarks also have a limit on allocations
+ * per iteration; exceeding it fails the run. With --check-allocations only
+ * these are run, briefly, as a test (see 'microbench_allocations'). */
+
+#include <cassert>
+
+// UnittestUtil.h uses this assertion from cxxtest, whose runner we don't use
+#define ETS_ASSERT( e ) do{ if( !(e) ){ \
+    std::cerr << "assertion failed: " #e << std::endl; std::abort(); } }while(0)
+
+#include "UnittestUtil.h"
+#include "MicroBench.h"
+#include "SimulationContext.h"
+#include "Population.h"
+#include "Parameters.h"
+#include "WithinHost/CommonWithinHost.h"
+#include "WithinHost/Infection/DescriptiveInfection.h"
+#include "WithinHost/Infection/DummyInfection.h"
+#include "WithinHost/Infection/EmpiricalInfection.h"
+#include "WithinHost/Infection/PennyInfection.h"
+#include "util/CommandLine.h"
+#include "util/errors.h"
+#include "util/random.h"
+#include "util/StepArena.h"
+
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <optional>
+
+// Count allocations (see microbench::allocations). The array and sized forms
+// default to these.
+void* operator new( size_t size ){
+    microbench::allocations.fetch_add( 1, std::memory_order_relaxed );
+    if( void* p = std::malloc( size == 0 ? 1 : size ) ) return p;
+    throw std::bad_alloc();
+}
+void operator delete( void* p ) noexcept{
+    std::free( p );
+}
+void operator delete( void* p, size_t ) noexcept{
+    std::free( p );
+}
+
+using namespace OM;
+using microbench::State;
+using microbench::doNotOptimize;
+
+namespace {
+
+const size_t N_INFECTIONS = 1000;       // infections updated per iteration
+const size_t N_HOSTS = 200;             // medicated hosts per iteration
+const double BODY_MASS = 50.0;          // kg
+
+void seedRng( LocalRng& rng ){
+    rng.seed( 3978236241, 721347520444481703 );
+}
+
+// ———  within-host models  ———
+
+/* Infections of a CommonWithinHost model, created at staggered times over a
+ * warm-up period and updated daily. Extinct infections are replaced by new
+ * ones, so the distribution of infection ages (and densities) stays roughly
+ * stationary over iterations. */
+class InfectionPopulation {
+public:
+    explicit InfectionPopulation( size_t warmupDays ) : rng( 0, 0 ) {
+        seedRng( rng );
+        for( size_t d = 0; d < warmupDays; ++d ){
+            while( infections.size() < N_INFECTIONS * (d + 1) / warmupDays )
+                infections.emplace_back( CommonWithinHost::createInfection( rng, 0xFFFFFFFF ) );
+            updateDay();
+        }
+    }
+
+    void updateDay(){
+        UnittestUtil::incrTime( SimTime::oneDay() );
+        const SimTime now = sim::ts1();
+        for( auto& infection : infections ){
+            if( infection->update( rng, 1.0, now, BODY_MASS ) )
+                infection.reset( CommonWithinHost::createInfection( rng, 0xFFFFFFFF ) );
+        }
+        doNotOptimize( infections.front()->getDensity() );
+    }
+
+private:
+    LocalRng rng;
+    vector<unique_ptr<CommonInfection>> infections;
+};
+
+void runInfections( State& state ){
+    InfectionPopulation population( 200 );
+    while( state.keepRunning() ){
+        population.updateDay();
+    }
+    state.setItemsPerIteration( N_INFECTIONS );
+}
+
+void benchMolineaux( State& state ){
+    UnittestUtil::initTime( 1 );
+    UnittestUtil::Infection_init_latentP_and_NaN();
+    UnittestUtil::MolineauxWHM_setup( "original", false );
+    runInfections( state );
+}
+
+void benchPenny( State& state ){
+    UnittestUtil::initTime( 1 );
+    UnittestUtil::Infection_init_latentP_and_NaN();
+    ModelOptions::reset();
+    WithinHost::PennyInfection::init();
+    runInfections( state );
+}
+
+void benchEmpirical( State& state ){
+    UnittestUtil::initTime( 1 );
+    UnittestUtil::Infection_init_latentP_and_NaN();
+    UnittestUtil::EmpiricalWHM_setup();
+    WithinHost::EmpiricalInfection::init();
+    runInfections( state );
+}
+
+/* As for InfectionPopulation, but 5-day steps of the descriptive model. The
+ * immunity inputs are sampled once per infection. */
+void benchDescriptive( State& state ){
+    UnittestUtil::initTime( 5 );
+    UnittestUtil::Infection_init_latentP_and_NaN();
+    UnittestUtil::DescriptiveInfection_init();
+    scnXml::Parameters xmlParams( UnittestUtil::prepareParameters() );
+    xmlParams.getParameter().push_back( scnXml::Parameter( Parameters::SIGMA0_SQ, 0.656515 ) );
+    xmlParams.getParameter().push_back( scnXml::Parameter( Parameters::X_NU_STAR, 0.918108 ) );
+    WithinHost::DescriptiveInfection::init( Parameters( xmlParams ) );
+
+    struct Inputs {
+        double cumulativeh, immSurvFact, innateImmSurvFact;
+    };
+    LocalRng rng( 0, 0 );
+    seedRng( rng );
+    vector<WithinHost::DescriptiveInfection> infections;
+    vector<Inputs> inputs;
+    auto sampleInputs = [&rng](){
+        return Inputs{ 1.0 + 50.0 * rng.uniform_01(),
+            0.2 + 0.8 * rng.uniform_01(), 0.5 + 0.5 * rng.uniform_01() };
+    };
+    auto updateStep = [&](){
+        UnittestUtil::incrTime( SimTime::oneTS() );
+        for( size_t i = 0; i < infections.size(); ++i ){
+            if( infections[i].expired() ){
+                infections[i] = WithinHost::DescriptiveInfection( rng, 0 );
+                inputs[i] = sampleInputs();
+            }
+            double timeStepMaxDensity = 0.0;
+            infections[i].determineDensities( rng, inputs[i].cumulativeh,
+                    timeStepMaxDensity, inputs[i].immSurvFact,
+                    inputs[i].innateImmSurvFact, 1.0 );
+            doNotOptimize( timeStepMaxDensity );
+        }
+    };
+
+    const size_t warmupSteps = 40;
+    for( size_t t = 0; t < warmupSteps; ++t ){
+        while( infections.size() < N_INFECTIONS * (t + 1) / warmupSteps ){
+            infections.push_back( WithinHost::DescriptiveInfection( rng, 0 ) );
+            inputs.push_back( sampleInputs() );
+        }
+        updateStep();
+    }
+    while( state.keepRunning() ){
+        updateStep();
+    }
+    state.setItemsPerIteration( N_INFECTIONS );
+}
+
+// ———  PK/PD  ———
+
+/* Hosts given a dose of drugName (mg/kg varying by host) at one of several
+ * times of day, between zero and six days ago. */
+void runDrugFactor( State& state, const char* drugName ){
+    UnittestUtil::initTime( 1 );
+    UnittestUtil::PkPdSuiteSetup();
+    const size_t index = PkPd::LSTMDrugType::findDrug( drugName );
+    LocalRng rng( 0, 0 );
+    seedRng( rng );
+    unique_ptr<CommonInfection> infection( createDummyInfection( rng, 0 ) );
+
+    vector<PkPd::LSTMModel> hosts( N_HOSTS );
+    for( size_t i = 0; i < N_HOSTS; ++i ){
+        const double mgPerKg = 1.0 + 0.5 * (i % 7);
+        const double time = 0.25 * (i % 4);
+        UnittestUtil::medicate( rng, hosts[i], index, mgPerKg * BODY_MASS, time );
+        for( size_t d = 0; d < i % 7; ++d )
+            hosts[i].decayDrugs( BODY_MASS );
+    }
+
+    while( state.keepRunning() ){
+        for( const PkPd::LSTMModel& host : hosts ){
+            doNotOptimize( host.getDrugFactor( rng, infection.get(), BODY_MASS ) );
+        }
+    }
+    state.setItemsPerIteration( N_HOSTS );
+    PkPd::LSTMDrugType::clear();
+}
+
+void benchThreeComp( State& state ){
+    runDrugFactor( state, "PPQ3" );     // three-compartment model
+}
+
+void benchConversion( State& state ){
+    runDrugFactor( state, "AR" );       // artemether with conversion to DHA
+}
+
+// ———  scenario: vector model, births  ———
+
+string vectorScenario;
+unique_ptr<SimulationContext> vectorContext;
+
+/* Load vectorScenario and create its initial population (once). Returns
+ * false, having skipped the benchmark, if this is not possible. Note that
+ * the warm-up is not run: hosts are not infected. */
+bool loadScenario( State& state ){
+    if( vectorContext == nullptr ){
+        if( vectorScenario.empty() ){
+            state.skip( "no vector scenario given (--scenario FILE)" );
+            return false;
+        }
+        vectorContext.reset( new SimulationContext(
+            util::CommandLine::lookupResource( vectorScenario ) ) );
+        vectorContext->population().createInitialHumans();
+        vectorContext->transmission().init2( vectorContext->population() );
+        sim::start_update();    // all benchmarks update the first step
+        vectorContext->transmission().vectorUpdate( vectorContext->population() );
+    }
+    return true;
+}
+
+Transmission::VectorModel* vectorModel( State& state ){
+    if( !loadScenario( state ) ) return nullptr;
+    auto model = dynamic_cast<Transmission::VectorModel*>( &vectorContext->transmission() );
+    if( model == nullptr ) state.skip( "scenario does not use the vector model" );
+    return model;
+}
+
+void benchCalculateEIR( State& state ){
+    Transmission::VectorModel* model = vectorModel( state );
+    if( model == nullptr ) return;
+    WithinHost::GenotypeWeights weights;
+    while( state.keepRunning() ){
+        for( Host::Human& human : vectorContext->population() ){
+            model->calculateEIR( human, human.age( sim::ts1() ).inYears(), weights );
+            doNotOptimize( weights.byGenotype[0] );
+        }
+    }
+    state.setItemsPerIteration( vectorContext->population().size() );
+}
+
+void benchAnophelesUpdate( State& state ){
+    Transmission::VectorModel* model = vectorModel( state );
+    if( model == nullptr ) return;
+    const size_t nSpecies = Transmission::VectorModel::getSpeciesIndexMap().size();
+    vector<double> sigma_dif;
+    while( state.keepRunning() ){
+        util::StepArena::nextStep();    // as each step of the simulation
+        for( size_t s = 0; s < nSpecies; ++s )
+            UnittestUtil::advanceVectorSpecies( *model, s, sigma_dif );
+    }
+    // one update per species and day
+    state.setItemsPerIteration( nSpecies * SimTime::oneTS().inDays() );
+}
+
+void benchVectorUpdate( State& state ){
+    Transmission::VectorModel* model = vectorModel( state );
+    if( model == nullptr ) return;
+    while( state.keepRunning() ){
+        util::StepArena::nextStep();
+        model->vectorUpdate( vectorContext->population() );
+    }
+    state.setItemsPerIteration( vectorContext->population().size() );
+}
+
+/* Replace each of N_HOSTS humans by a newborn, as Population::update does
+ * for deaths and births. Storage of per-human sub-models and containers
+ * comes from util::ObjectPool, so once the pool is warm a birth makes no
+ * system allocations. */
+void benchBirths( State& state ){
+    if( !loadScenario( state ) ) return;
+    util::MasterRng rng( 0, 0 );
+    vector<std::optional<Host::Human>> hosts( N_HOSTS );
+    for( auto& host : hosts ) host.emplace( sim::nowOrTs1(), rng.gen_rng_seed() );
+    while( state.keepRunning() ){
+        for( auto& host : hosts ){
+            host.reset();
+            host.emplace( sim::nowOrTs1(), rng.gen_rng_seed() );
+        }
+    }
+    state.setItemsPerIteration( N_HOSTS );
+}
+
+const microbench::Benchmark benchmarks[] = {
+    { "MolineauxInfection::updateDensity", &benchMolineaux },
+    { "PennyInfection::updateDensity", &benchPenny },
+    { "EmpiricalInfection::updateDensity", &benchEmpirical },
+    { "DescriptiveInfection::determineDensities", &benchDescriptive },
+    { "LSTMDrugThreeComp::calculateDrugFactor", &benchThreeComp },
+    { "LSTMDrugConversion::calculateDrugFactor", &benchConversion },
+    // scenario benchmarks last (see above)
+    { "VectorModel::calculateEIR", &benchCalculateEIR },
+    // in steady state, a step of the vector model makes no allocations
+    { "AnophelesModel::update", &benchAnophelesUpdate, 0 },
+    { "VectorModel::vectorUpdate", &benchVectorUpdate, 0 },
+    // replacing a warmed-up human makes no allocations
+    { "Human births and deaths", &benchBirths, 0 },
+};
+
+void printHelp(){
+    cout << "Usage: microbench [options]\n\n"
+        << "Options:\n"
+        << "  --list            list benchmarks and exit\n"
+        << "  --scenario FILE   scenario using the vector model, for scenario benchmarks\n";
+    microbench::Runner::printOptions( cout );
+}
+
+}
+
+int main( int argc, char* argv[] ){
+    microbench::Runner runner;
+    for( int i = 1; i < argc; ++i ){
+        string arg = argv[i];
+        if( arg == "--help" ){
+            printHelp();
+            return 0;
+        }else if( arg == "--list" ){
+            for( const auto& b : benchmarks ) cout << b.name << endl;
+            return 0;
+        }else if( arg == "--check-allocations" ){
+            runner.setCheckOnly();
+        }else if( arg == "--scenario" && i + 1 < argc ){
+            vectorScenario = argv[++i];
+        }else if( !runner.parse( argc, argv, i ) ){
+            printHelp();
+            return 1;
+        }
+    }
+
+    try {
+        util::set_gsl_handler();
+        // Set defaults (e.g. the resource path) as for a run without options
+        util::CommandLine::parse( 1, argv );
+
+        microbench::Runner::printHeading();
+        for( const auto& b : benchmarks ) runner.run( b );
+        vectorContext.reset();
+    } catch (const ::xsd::cxx::tree::exception<char>& e) {
+        cerr << "XSD error: " << e.what() << '\n' << e << endl;
+        return util::Error::XSD;
+    } catch (const util::base_exception& e) {
+        cerr << "Error: " << e.message() << endl;
+        return e.getCode() != util::Error::None ? e.getCode() : util::Error::Default;
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        return util::Error::Default;
+    }
+    if( !runner.writeJson() ) return util::Error::FileIO;
+    return runner.failures == 0 ? 0 : util::Error::Default;
+}
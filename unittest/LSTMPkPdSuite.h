@@ -61,11 +61,14 @@ public:
     
     void testNone () {
 	TS_ASSERT_EQUALS (proxy->getDrugFactor (m_rng, inf, massAt21), 1.0);
+	TS_ASSERT (proxy->empty());
     }
     
     void testOral () {
 	UnittestUtil::medicate( m_rng, *proxy, MQ_index, 3000, 0 );
 	TS_ASSERT_APPROX (proxy->getDrugFactor (m_rng, inf, massAt21), 0.03174563638523168);
+	TS_ASSERT (!proxy->empty());
+	TS_ASSERT (proxy->memoryUsage() > sizeof(LSTMModel));
     }
     
     void testOralHalves () {	// the point being: check it can handle two doses at the same time-point correctly
@@ -92,7 +95,21 @@ public:
 	UnittestUtil::medicate( m_rng, *proxy, MQ_index, 3000, 0 );
 	TS_ASSERT_APPROX (proxy->getDrugFactor (m_rng, inf, massAt21), 0.03174563637686205);
     }
-    
+
+    void testRemoveNegligible () {
+	ModelOptions::set(util::REMOVE_NEGLIGIBLE_DRUGS);
+	UnittestUtil::medicate( m_rng, *proxy, MQ_index, 3000, 0 );
+	proxy->decayDrugs (massAt21);
+	TS_ASSERT (!proxy->empty());
+	// concentration eventually falls below the negligible level
+	for( int day = 0; day < 10000 && !proxy->empty(); ++day )
+	    proxy->decayDrugs (massAt21);
+	TS_ASSERT (proxy->empty());
+	TS_ASSERT_EQUALS (proxy->getDrugFactor (m_rng, inf, massAt21), 1.0);
+	TS_ASSERT_EQUALS (proxy->getDrugConc (MQ_index), 0.0);
+	ModelOptions::reset();
+    }
+
 private:
     LocalRng m_rng;
     LSTMModel *proxy;
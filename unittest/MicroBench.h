@@ -0,0 +1,280 @@
+/*
+ This file is part of OpenMalaria.
+
+ Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+
+ OpenMalaria is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or (at
+ your option) any later version.
+
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+// A minimal, self-contained micro-benchmark harness (used by KernelBench.cpp).
+
+#ifndef Hmod_MicroBench
+#define Hmod_MicroBench
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace microbench {
+
+/** Number of calls to the global operator new; the benchmark program counts
+ * these by replacing operator new (see KernelBench.cpp). */
+inline std::atomic<uint64_t> allocations( 0 );
+
+/** Prevent the compiler from optimising away the computation of value. */
+template<class T>
+inline void doNotOptimize( const T& value ){
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile( "" : : "r,m"(value) : "memory" );
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+/** Passed to a benchmark function. Usage is similar to Google Benchmark:
+ *
+ *      void benchFoo( microbench::State& state ){
+ *          // set-up (not timed)
+ *          while( state.keepRunning() ){
+ *              // timed code
+ *          }
+ *          state.setItemsPerIteration( n );
+ *      }
+ *
+ * The timer starts on the first call to keepRunning(). Allocations made by
+ * the timed code are counted too. */
+class State {
+public:
+    explicit State( uint64_t iterations ) :
+        m_iterations( iterations ), m_left( iterations ), m_items( 1 ) {}
+
+    inline bool keepRunning(){
+        if( m_left == m_iterations ){
+            m_allocs = allocations.load( std::memory_order_relaxed );
+            m_start = Clock::now();
+        }
+        if( m_left == 0 ){
+            m_end = Clock::now();
+            m_allocs = allocations.load( std::memory_order_relaxed ) - m_allocs;
+            return false;
+        }
+        --m_left;
+        return true;
+    }
+
+    /// Number of items (e.g. infections updated) processed per iteration
+    void setItemsPerIteration( uint64_t items ){ m_items = items; }
+
+    /// Skip this benchmark, with an explanation
+    void skip( const std::string& reason ){ m_skipped = reason; }
+
+    uint64_t iterations() const{ return m_iterations; }
+    uint64_t items() const{ return m_items; }
+    const std::string& skipped() const{ return m_skipped; }
+    double seconds() const{
+        return std::chrono::duration<double>( m_end - m_start ).count();
+    }
+    /// Allocations during the timed loop
+    uint64_t allocs() const{ return m_allocs; }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+    uint64_t m_iterations, m_left, m_items, m_allocs = 0;
+    Clock::time_point m_start, m_end;
+    std::string m_skipped;
+};
+
+typedef void (*Function)( State& );
+
+struct Benchmark {
+    const char* name;
+    Function function;
+    /** If not negative, the run fails when the timed code makes more than
+     * this number of allocations per iteration (after warm-up). */
+    double maxAllocs = -1.0;
+};
+
+struct Result {
+    std::string name;
+    uint64_t iterations, items;
+    double medianNs, minNs, maxNs;      // per iteration
+    double allocs;      // allocations per iteration (last repetition)
+};
+
+/** Runs benchmarks: the number of iterations is chosen such that one run
+ * takes at least minTime seconds; the run is then repeated and the median,
+ * minimum and maximum time per iteration are reported. */
+class Runner {
+public:
+    Runner() : minTime( 0.5 ), repetitions( 5 ), checkOnly( false ), failures( 0 ) {}
+
+    double minTime;
+    size_t repetitions;
+    /// Only run benchmarks with an allocation limit, with one short repetition
+    bool checkOnly;
+    /// Number of benchmarks which exceeded their allocation limit
+    size_t failures;
+    std::string filter;         // run benchmarks whose name contains this
+    std::string jsonFile;       // write results here if not empty
+
+    /// Parse options; returns false (having printed a message) on error
+    bool parse( int argc, char* argv[], int& i ){
+        std::string arg = argv[i];
+        if( i + 1 >= argc ){
+            std::cerr << arg << " requires an argument" << std::endl;
+            return false;
+        }
+        const char* value = argv[++i];
+        if( arg == "--filter" ) filter = value;
+        else if( arg == "--json" ) jsonFile = value;
+        else if( arg == "--min-time" ) minTime = std::atof( value );
+        else if( arg == "--repetitions" ) repetitions = std::max( 1, std::atoi( value ) );
+        else {
+            std::cerr << "unknown option: " << arg << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    static void printOptions( std::ostream& stream ){
+        stream << "  --filter TEXT     only run benchmarks whose name contains TEXT\n"
+            << "  --json FILE       also write results to FILE in JSON format\n"
+            << "  --min-time S      minimum time of one repetition (default: 0.5s)\n"
+            << "  --repetitions N   number of timed repetitions (default: 5)\n"
+            << "  --check-allocations\n"
+            << "                    only run benchmarks with an allocation limit, briefly,\n"
+            << "                    failing if any exceeds its limit\n";
+    }
+
+    bool selected( const Benchmark& b ) const{
+        if( checkOnly && b.maxAllocs < 0.0 ) return false;
+        return filter.empty() || std::strstr( b.name, filter.c_str() ) != nullptr;
+    }
+
+    /// Use check mode (see checkOnly)
+    void setCheckOnly(){
+        checkOnly = true;
+        minTime = 0.0;
+        repetitions = 1;
+    }
+
+    void run( const Benchmark& b ){
+        if( !selected( b ) ) return;
+        // Find the number of iterations; the first run also warms up
+        uint64_t n = 1;
+        for(;;){
+            State state( n );
+            b.function( state );
+            if( !state.skipped().empty() ){
+                std::cout << std::left << std::setw( 48 ) << b.name
+                    << "skipped: " << state.skipped() << std::endl;
+                return;
+            }
+            double t = state.seconds();
+            if( t >= minTime || n >= (uint64_t(1) << 40) ) break;
+            // aim 20% over minTime, growing by at most 10x per step
+            double factor = t > 0.0 ? std::min( 10.0, 1.2 * minTime / t ) : 10.0;
+            n = std::max( n + 1, static_cast<uint64_t>( n * factor ) );
+        }
+
+        std::vector<double> times;
+        uint64_t items = 1;
+        double allocs = 0.0;
+        for( size_t r = 0; r < repetitions; ++r ){
+            State state( n );
+            b.function( state );
+            times.push_back( state.seconds() * 1e9 / n );
+            items = state.items();
+            allocs = static_cast<double>( state.allocs() ) / n;
+        }
+        std::sort( times.begin(), times.end() );
+        Result result{ b.name, n, items, times[times.size() / 2],
+            times.front(), times.back(), allocs };
+        print( result );
+        results.push_back( result );
+        if( b.maxAllocs >= 0.0 && allocs > b.maxAllocs ){
+            std::cout << "FAILED: " << b.name << " made " << allocs
+                << " allocations per iteration; expected at most "
+                << b.maxAllocs << std::endl;
+            ++failures;
+        }
+    }
+
+    /// Print the table heading
+    static void printHeading(){
+        std::cout << std::left << std::setw( 48 ) << "benchmark"
+            << std::right << std::setw( 12 ) << "iterations"
+            << std::setw( 14 ) << "ns/iter"
+            << std::setw( 10 ) << "spread"
+            << std::setw( 12 ) << "ns/item"
+            << std::setw( 14 ) << "allocs/item" << std::endl;
+    }
+
+    /// Write results in JSON format (if requested); returns false on error
+    bool writeJson() const{
+        if( jsonFile.empty() ) return true;
+        std::ofstream stream( jsonFile );
+        stream << "{\n  \"minTime\": " << minTime
+            << ",\n  \"repetitions\": " << repetitions
+            << ",\n  \"benchmarks\": [";
+        for( size_t i = 0; i < results.size(); ++i ){
+            const Result& r = results[i];
+            stream << (i == 0 ? "\n" : ",\n")
+                << "    { \"name\": \"" << r.name << "\""
+                << ", \"iterations\": " << r.iterations
+                << ", \"itemsPerIteration\": " << r.items
+                << ", \"medianNs\": " << r.medianNs
+                << ", \"minNs\": " << r.minNs
+                << ", \"maxNs\": " << r.maxNs
+                << ", \"allocationsPerIteration\": " << r.allocs << " }";
+        }
+        stream << "\n  ]\n}\n";
+        stream.close();
+        if( !stream ){
+            std::cerr << "unable to write " << jsonFile << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    static void print( const Result& r ){
+        double spread = r.medianNs > 0.0 ? (r.maxNs - r.minNs) / r.medianNs : 0.0;
+        std::cout << std::left << std::setw( 48 ) << r.name
+            << std::right << std::setw( 12 ) << r.iterations
+            << std::fixed << std::setprecision( 1 )
+            << std::setw( 14 ) << r.medianNs
+            << std::setw( 9 ) << spread * 100.0 << '%'
+            << std::setw( 12 ) << r.medianNs / r.items
+            << std::setprecision( 2 )
+            << std::setw( 14 ) << r.allocs / r.items
+            << std::defaultfloat << std::endl;
+    }
+
+    std::vector<Result> results;
+};
+
+}
+#endif
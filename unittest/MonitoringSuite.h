@@ -0,0 +1,245 @@
+/*
+ This file is part of OpenMalaria.
+ 
+ Copyright (C) 2005-2014 Swiss Tropical and Public Health Institute
+ Copyright (C) 2005-2014 Liverpool School Of Tropical Medicine
+ 
+ OpenMalaria is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or (at
+ your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+
+#ifndef Hmod_MonitoringSuite
+#define Hmod_MonitoringSuite
+
+#include <cxxtest/TestSuite.h>
+#include "UnittestUtil.h"
+
+#include "Clinical/Episode.h"
+#include "mon/management.h"
+#include "mon/reporting.h"
+#include "mon/MonIndex.h"
+#include "util/TaskPool.h"
+
+#include <memory>
+#include <sstream>
+#include <vector>
+
+using Clinical::Episode;
+
+class MonitoringSuite : public CxxTest::TestSuite
+{
+public:
+    void setUp () {
+        // Monitoring can only be initialised once, so later tests start from
+        // a checkpoint of the empty stores instead
+        static string initial;
+        if( initial.empty() ){
+            const char* options[] = { "nUncomp", "nSevere", "nSeq",
+                "nHospitalDeaths", "nDirDeaths", "nHospitalRecovs",
+                "nNMFever", "sumAge" };
+            for( const char* name : options ){
+                dummyXML::survOpts.getOption().push_back( scnXml::MonitoringOption( name ) );
+            }
+            dummyXML::monitoring.setSurveyOptions( dummyXML::survOpts );
+            dummyXML::monAgeGroup.getGroup().push_back( scnXml::MonGroupBounds( 5.0 ) );
+            dummyXML::monAgeGroup.getGroup().push_back( scnXml::MonGroupBounds( 90.0 ) );
+            dummyXML::monitoring.setAgeGroup( dummyXML::monAgeGroup );
+            dummyXML::surveys.getSurveyTime().push_back( scnXml::SurveyTime( "2t" ) );
+            UnittestUtil::initTime( 1 );     // adds survey "1t" and reads surveys
+    
+            mon::initReporting( dummyXML::scenario );
+            mon::initMainSim();
+            ostringstream stream;
+            mon::checkpoint( stream );
+            initial = stream.str();
+        }
+        istringstream stream( initial );
+        mon::checkpoint( stream );
+    }
+    
+    // Buffered episode reports must give the same survey totals as reporting
+    // each episode directly, also when a checkpoint is taken in between
+    void testBufferedEpisodes () {
+        const string empty = output();
+    
+        for( const TestEpisode& e : episodes() ){
+            for( mon::Measure measure : e.measures ){
+                mon::reportMSACI( measure, e.survey, ageGroup( e.age ),
+                        e.cohortSet, 1 );
+            }
+        }
+        const string direct = output();
+        TS_ASSERT_DIFFERS( direct, empty );
+    
+        setUp();
+        const vector<TestEpisode> eps = episodes();
+        const size_t half = eps.size() / 2;
+        for( size_t i = 0; i < half; ++i ){
+            UnittestUtil::reportEpisode( eps[i].survey, eps[i].age,
+                    eps[i].cohortSet, eps[i].state );
+        }
+        ostringstream checkpoint;
+        mon::checkpoint( checkpoint );
+        // A resumed simulation has an empty buffer: anything left in the
+        // buffer now is discarded when the checkpoint is loaded
+        Episode::flushBuffered();
+        istringstream resume( checkpoint.str() );
+        mon::checkpoint( resume );
+        for( size_t i = half; i < eps.size(); ++i ){
+            UnittestUtil::reportEpisode( eps[i].survey, eps[i].age,
+                    eps[i].cohortSet, eps[i].state );
+        }
+        TS_ASSERT_EQUALS( output(), direct );
+    }
+    
+    // Reports made by concurrent tasks under ShardScope must give the same
+    // survey totals as serial reporting, with int and double reports of
+    // each shard merged into the right surveys
+    void testShards () {
+        const size_t N = 64;
+        util::TaskPool::init( 1 );
+        reportTwoSurveys( N, false );
+        const string serial = output();
+        
+        setUp();
+        util::TaskPool::init( 4 );
+        reportTwoSurveys( N, true );
+        util::TaskPool::init( 1 );
+        const string sharded = output();
+        TS_ASSERT_EQUALS( sharded, serial );
+        
+        for( size_t survey = 0; survey < 2; ++survey ){
+            double nUncomp = 0.0, sumAge = 0.0;
+            for( size_t i = 0; i < N; ++i ){
+                if( i % 2 == survey ) nUncomp += 2 * (i + 1);     // once per survey period
+                sumAge += 0.5 * (i + 1);
+            }
+            TS_ASSERT_EQUALS( total( sharded, survey, 14 ), nUncomp );
+            TS_ASSERT_EQUALS( total( sharded, survey, 68 ), sumAge );
+        }
+    }
+    
+    // IndexPlan::index must match MonIndex::index, including for
+    // non-categorised dimensions (any category maps to 0) and out-of-range
+    // categories (which wrap around)
+    void testIndexPlan () {
+        LocalRng rng( 0, 721347520444481703 );
+        // MonIndex::index reports out-of-range categories in debug builds
+        ostringstream discard;
+        streambuf* coutBuf = cout.rdbuf( discard.rdbuf() );
+        for( int i = 0; i < 100000; ++i ){
+            mon::MonIndex ind;
+            ind.measure = mon::MHR_HOSTS;
+            ind.outMeasure = 0;
+            ind.offset = rng.uniform( 1000 );
+            size_t* dims[] = { &ind.nAges, &ind.nCohorts, &ind.nSpecies,
+                &ind.nGenotypes, &ind.nDrugs };
+            for( size_t* n : dims ) *n = 1 + rng.uniform( 4 );
+            ind.deployMask = 0;
+            const mon::IndexPlan plan( ind );
+            
+            size_t x[5];
+            for( int k = 0; k < 5; ++k ){
+                // mostly in range; sometimes up to three times too large
+                size_t n = *dims[k];
+                x[k] = rng.uniform( 10 ) == 0 ? rng.uniform( static_cast<int>(3 * n) ) : rng.uniform( static_cast<int>(n) );
+            }
+            const size_t expected = ind.index( x[0], x[1], x[2], x[3], x[4] );
+            TS_ASSERT_EQUALS( plan.index( x[0], x[1], x[2], x[3], x[4] ), expected );
+            TS_ASSERT_LESS_THAN( expected, ind.offset + ind.size() );
+        }
+        cout.rdbuf( coutBuf );
+    }
+    
+private:
+    // In each of two survey periods, report from n tasks (optionally in
+    // shards): int reports to survey i % 2, double reports to the current
+    // survey. Values are exact in binary so that summation order is irrelevant.
+    static void reportTwoSurveys( size_t n, bool sharded ){
+        const SimTime child = SimTime::fromYearsI( 2 ), adult = SimTime::fromYearsI( 30 );
+        for( size_t period = 0; period < 2; ++period ){
+            util::TaskPool::forEach( n, [=]( size_t i ){
+                unique_ptr<mon::ShardScope> scope;
+                if( sharded ) scope.reset( new mon::ShardScope( i ) );
+                mon::reportMSACI( mon::MHE_UNCOMPLICATED_EPISODES, i % 2,
+                        ageGroup( i % 3 == 0 ? child : adult ), 0, i + 1 );
+                mon::reportStatMACGF( mon::MHF_AGE, i % 2, 0, 0, 0.5 * (i + 1) );
+            } );
+            mon::concludeSurvey();
+        }
+    }
+    
+    // An episode and the measures it should report
+    struct TestEpisode {
+        size_t survey;
+        SimTime age;
+        uint32_t cohortSet;
+        Episode::State state;
+        vector<mon::Measure> measures;
+    };
+    
+    static vector<TestEpisode> episodes () {
+        const Episode::State UC = Episode::State( Episode::SICK | Episode::MALARIA );
+        const Episode::State SEVERE = Episode::State( UC | Episode::COMPLICATED );
+        const SimTime child = SimTime::fromYearsI( 2 ), adult = SimTime::fromYearsI( 30 );
+        vector<TestEpisode> eps = {
+            { 0, child, 0, UC, { mon::MHE_UNCOMPLICATED_EPISODES } },
+            { 0, child, 0, UC, { mon::MHE_UNCOMPLICATED_EPISODES } },
+            { 0, adult, 0, UC, { mon::MHE_UNCOMPLICATED_EPISODES } },
+            { 1, child, 0, UC, { mon::MHE_UNCOMPLICATED_EPISODES } },
+            { 0, child, 0, Episode::SICK, { mon::MHE_NON_MALARIA_FEVERS } },
+            { 1, adult, 0, Episode::State( Episode::SICK | Episode::DIRECT_DEATH ),
+                { mon::MHE_NON_MALARIA_FEVERS, mon::MHO_NMF_DEATHS } },
+            { 0, child, 0, Episode::State( SEVERE | Episode::EVENT_IN_HOSPITAL | Episode::DIRECT_DEATH ),
+                { mon::MHE_SEVERE_EPISODES, mon::MHO_DIRECT_DEATHS, mon::MHO_HOSPITAL_DEATHS } },
+            { 1, child, 0, Episode::State( SEVERE | Episode::EVENT_IN_HOSPITAL | Episode::RECOVERY ),
+                { mon::MHE_SEVERE_EPISODES, mon::MHO_HOSPITAL_RECOVERIES } },
+            { 1, adult, 0, Episode::State( SEVERE | Episode::SEQUELAE ),
+                { mon::MHE_SEVERE_EPISODES, mon::MHO_SEQUELAE } },
+            { 0, adult, 0, Episode::State( SEVERE | Episode::DIRECT_DEATH ),
+                { mon::MHE_SEVERE_EPISODES, mon::MHO_DIRECT_DEATHS } },
+            { 1, adult, 0, UC, { mon::MHE_UNCOMPLICATED_EPISODES } },
+            { 0, child, 0, UC, { mon::MHE_UNCOMPLICATED_EPISODES } }
+        };
+        return eps;
+    }
+    
+    static mon::AgeGroup ageGroup( SimTime age ){
+        mon::AgeGroup group;
+        group.update( age );
+        return group;
+    }
+    
+    // Survey output, as written to output.txt
+    static string output () {
+        ostringstream stream;
+        mon::writeToStream( stream );
+        return stream.str();
+    }
+    
+    // Sum of values in output for some survey (from 0) and measure number
+    static double total( const string& out, size_t survey, int outId ){
+        istringstream stream( out );
+        double sum = 0.0;
+        int s, group, id;
+        double value;
+        while( stream >> s >> group >> id >> value ){
+            if( s == static_cast<int>(survey + 1) && id == outId ) sum += value;
+        }
+        return sum;
+    }
+};
+
+#endif
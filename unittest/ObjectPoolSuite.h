@@ -0,0 +1,84 @@
+/*
+ This file is part of OpenMalaria.
+
+ Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+
+ OpenMalaria is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or (at
+ your option) any later version.
+
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#ifndef Hmod_ObjectPoolSuite
+#define Hmod_ObjectPoolSuite
+
+#include <cxxtest/TestSuite.h>
+#include "util/ObjectPool.h"
+#include <memory>
+#include <vector>
+
+using namespace OM::util;
+
+namespace {
+    struct PoolBase : public PooledObject {
+        virtual ~PoolBase() {}
+        double x = 0.0;
+    };
+    struct PoolDerived : public PoolBase {
+        double data[20] = {};
+    };
+}
+
+class ObjectPoolSuite : public CxxTest::TestSuite
+{
+public:
+    void testRecycling() {
+        ObjectPool::Stats before = ObjectPool::stats();
+        std::vector<std::unique_ptr<PoolBase>> objects;
+        for( int i = 0; i < 10; ++i ) objects.emplace_back( new PoolDerived );
+        objects.clear();    // deleted through base: storage of derived size
+        // further "births" and "deaths" use recycled storage only
+        for( int cycle = 0; cycle < 100; ++cycle ){
+            for( int i = 0; i < 10; ++i ) objects.emplace_back( new PoolDerived );
+            objects.clear();
+        }
+        ObjectPool::Stats after = ObjectPool::stats();
+        TS_ASSERT_EQUALS( after.fromSystem - before.fromSystem, 10u );
+        TS_ASSERT_EQUALS( after.recycled - before.recycled, 1000u );
+    }
+
+    // Containers of a dead host refilled for a newborn reuse its nodes
+    void testContainers() {
+        struct Item { double data[37]; };
+        ObjectPool::Stats before = ObjectPool::stats();
+        for( int cycle = 0; cycle < 100; ++cycle ){
+            PooledList<Item> items( 5 );
+        }
+        ObjectPool::Stats after = ObjectPool::stats();
+        TS_ASSERT_EQUALS( after.fromSystem - before.fromSystem, 5u );
+        TS_ASSERT_EQUALS( after.recycled - before.recycled, 495u );
+    }
+
+    void testLarge() {
+        ObjectPool::Stats before = ObjectPool::stats();
+        void* block = ObjectPool::allocate( 4096 );
+        ObjectPool::release( block, 4096 );
+        ObjectPool::Stats after = ObjectPool::stats();
+        // not pooled
+        TS_ASSERT_EQUALS( after.fromSystem, before.fromSystem );
+        TS_ASSERT_EQUALS( after.recycled, before.recycled );
+        TS_ASSERT_EQUALS( after.large - before.large, 1u );
+    }
+};
+
+#endif
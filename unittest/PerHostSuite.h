@@ -0,0 +1,159 @@
+/*
+ This file is part of OpenMalaria.
+ 
+ Copyright (C) 2005-2014 Swiss Tropical and Public Health Institute
+ Copyright (C) 2005-2014 Liverpool School Of Tropical Medicine
+ 
+ OpenMalaria is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or (at
+ your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+
+#ifndef Hmod_PerHostSuite
+#define Hmod_PerHostSuite
+
+#include <cxxtest/TestSuite.h>
+#include "UnittestUtil.h"
+
+#include "Transmission/PerHost.h"
+
+#include <sstream>
+#include <vector>
+
+using Transmission::PerHost;
+using Transmission::PerHostInterventionData;
+using Transmission::HumanVectorInterventionComponent;
+using interventions::Component;
+using interventions::ComponentId;
+
+// Per-host part of a vector intervention without any effect
+class DummyHumanPart : public PerHostInterventionData {
+public:
+    explicit DummyHumanPart( ComponentId id ) : PerHostInterventionData( id ) {}
+    DummyHumanPart( istream& stream, ComponentId id ) : PerHostInterventionData( id ) {
+        deployTime & stream;
+    }
+    
+    virtual void redeploy( LocalRng& rng, const HumanVectorInterventionComponent& params ){
+        deployTime = sim::now();
+    }
+    virtual void update( Host::Human& human ){}
+    virtual double relativeAttractiveness( size_t species ) const{ return 1.0; }
+    virtual double preprandialSurvivalFactor( size_t species ) const{ return 1.0; }
+    virtual double postprandialSurvivalFactor( size_t species ) const{ return 1.0; }
+    virtual double relFecundity( size_t species ) const{ return 1.0; }
+    virtual size_t memoryUsage() const{ return sizeof(DummyHumanPart); }
+    
+protected:
+    virtual void checkpoint( ostream& stream ){
+        deployTime & stream;
+    }
+};
+
+// Vector intervention component of a given type, deploying DummyHumanPart
+class DummyVectorComponent : public HumanVectorInterventionComponent {
+public:
+    DummyVectorComponent( ComponentId id, Component::Type type ) :
+            HumanVectorInterventionComponent( id ), type( type ) {}
+    
+    virtual void deploy( Host::Human& human, mon::Deploy::Method method,
+            interventions::VaccineLimits vaccLimits ) const {}
+    virtual Component::Type componentType() const{ return type; }
+    virtual void print_details( std::ostream& out )const{ out << id().id << "\tdummy"; }
+    
+    virtual unique_ptr<PerHostInterventionData> makeHumanPart( LocalRng& rng ) const{
+        return unique_ptr<PerHostInterventionData>( new DummyHumanPart( id() ) );
+    }
+    virtual unique_ptr<PerHostInterventionData> makeHumanPart( istream& stream,
+            ComponentId id ) const{
+        return unique_ptr<PerHostInterventionData>( new DummyHumanPart( stream, id ) );
+    }
+    
+private:
+    Component::Type type;
+};
+
+class PerHostSuite : public CxxTest::TestSuite
+{
+public:
+    PerHostSuite() : rng( 0, 721347520444481703 ) {}
+    
+    void setUp () {
+        UnittestUtil::initTime( 1 );
+        PerHost::resetCounts();
+    }
+    void tearDown () {
+        UnittestUtil::clearHumanComponents();
+        PerHost::resetCounts();
+    }
+    
+    // Counts follow deployment and removal of hosts
+    void testCounts () {
+        const DummyVectorComponent& itn = UnittestUtil::addHumanComponent<DummyVectorComponent>( Component::ITN );
+        const DummyVectorComponent& irs = UnittestUtil::addHumanComponent<DummyVectorComponent>( Component::IRS );
+    
+        vector<PerHost> hosts( 5 );
+        for( size_t i = 0; i < 4; ++i ) hosts[i].deployComponent( rng, itn );
+        for( size_t i = 2; i < 5; ++i ) hosts[i].deployComponent( rng, irs );
+        hosts[0].deployComponent( rng, itn );     // redeployment: no change
+        assertCounts( 4, 3 );
+        TS_ASSERT( hosts[2].hasActiveInterv( Component::ITN ) );
+    
+        hosts[2].removeFromCounts();
+        hosts[4].removeFromCounts();
+        assertCounts( 3, 1 );
+        TS_ASSERT( !hosts[2].hasActiveInterv( Component::ITN ) );
+        TS_ASSERT( !hosts[2].hasActiveInterv( Component::IRS ) );
+    
+        // a new host list (e.g. a new population) starts from zero
+        PerHost::resetCounts();
+        assertCounts( 0, 0 );
+        hosts[4].deployComponent( rng, itn );
+        assertCounts( 1, 0 );
+    }
+    
+    // Loading a checkpoint after a reset restores the counts of the loaded hosts
+    void testCheckpoint () {
+        const DummyVectorComponent& itn = UnittestUtil::addHumanComponent<DummyVectorComponent>( Component::ITN );
+        const DummyVectorComponent& gvi = UnittestUtil::addHumanComponent<DummyVectorComponent>( Component::GVI );
+    
+        vector<PerHost> hosts( 4 );
+        for( size_t i = 0; i < 3; ++i ) hosts[i].deployComponent( rng, itn );
+        hosts[1].deployComponent( rng, gvi );
+        hosts[3].deployComponent( rng, gvi );
+        hosts[1].removeFromCounts();
+        TS_ASSERT_EQUALS( PerHost::numActiveHosts( Component::GVI ), 1 );
+    
+        ostringstream out;
+        for( size_t i : { 0, 2, 3 } ) hosts[i] & out;
+    
+        PerHost::resetCounts();
+        istringstream in( out.str() );
+        vector<PerHost> loaded( 3 );
+        for( PerHost& host : loaded ) host & in;
+        assertCounts( 2, 0 );
+        TS_ASSERT_EQUALS( PerHost::numActiveHosts( Component::GVI ), 1 );
+        TS_ASSERT( loaded[2].hasActiveInterv( Component::GVI ) );
+    }
+    
+private:
+    static void assertCounts( int nITN, int nIRS ){
+        TS_ASSERT_EQUALS( PerHost::numActiveHosts( Component::ITN ), nITN );
+        TS_ASSERT_EQUALS( PerHost::numActiveHosts( Component::IRS ), nIRS );
+    }
+    
+    LocalRng rng;
+};
+
+#endif
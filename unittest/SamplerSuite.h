@@ -0,0 +1,108 @@
+/*
+ This file is part of OpenMalaria.
+
+ Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+
+ OpenMalaria is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or (at
+ your option) any later version.
+
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#ifndef Hmod_SamplerSuite
+#define Hmod_SamplerSuite
+
+#include <cxxtest/TestSuite.h>
+#include "ExtraAsserts.h"
+#include "util/sampler.h"
+
+using namespace OM::util;
+
+class SamplerSuite : public CxxTest::TestSuite
+{
+public:
+    void testAliasSampler() {
+        const double data[] = { 0.5, 0.0, 2.0, 1.0, 0.5 };
+        vector<double> weights( data, data+5 );
+        AliasSampler sampler;
+        sampler.setWeights( weights );
+        TS_ASSERT_APPROX( sampler.total(), 4.0 );
+
+        LocalRng rng(0, 721347520444481703);
+        const int N = 200000;
+        vector<int> counts( weights.size(), 0 );
+        for( int i = 0; i < N; ++i ){
+            size_t x = sampler.sample( rng );
+            ETS_ASSERT_LESS_THAN( x, weights.size() );
+            counts[x] += 1;
+        }
+        // zero weight is never sampled; others within a few standard errors
+        TS_ASSERT_EQUALS( counts[1], 0 );
+        for( size_t i = 0; i < weights.size(); ++i ){
+            double p = weights[i] / sampler.total();
+            TS_ASSERT_DELTA( counts[i] / double(N), p, 0.005 );
+        }
+    }
+
+    void testAliasSamplerZero() {
+        AliasSampler sampler;
+        sampler.setWeights( vector<double>( 3, 0.0 ) );
+        TS_ASSERT_EQUALS( sampler.total(), 0.0 );
+    }
+
+    void testBernoulliSkip() {
+        LocalRng rng(0, 721347520444481703);
+        const size_t N = 1000000;
+        const double p = 0.002;
+        BernoulliSkip trials( rng, p );
+        size_t hits = 0;
+        for( size_t i = trials.skip(); i < N; i += 1 + trials.skip() )
+            hits += 1;
+        // binomial standard deviation is about 45
+        TS_ASSERT_DELTA( double(hits), N * p, 250.0 );
+
+        BernoulliSkip seq( rng, p );
+        hits = 0;
+        for( size_t i = 0; i < N; ++i )
+            hits += seq.next() ? 1 : 0;
+        TS_ASSERT_DELTA( double(hits), N * p, 250.0 );
+
+        // edge cases need no random numbers
+        BernoulliSkip never( rng, 0.0 ), always( rng, 1.0 );
+        TS_ASSERT_EQUALS( never.skip(), BernoulliSkip::maxSkip );
+        TS_ASSERT( !never.next() );
+        TS_ASSERT_EQUALS( always.skip(), 0u );
+        TS_ASSERT( always.next() );
+    }
+
+    void testMaxNormalQuantileTable() {
+        MaxNormalQuantileTable table;
+        table.init( 4, 1e-7 );
+        TS_ASSERT_LESS_THAN( table.maxError(), 1e-7 );
+        // nodes, between nodes, both tails and beyond the table
+        const double u[] = { 0.5, 0.3, 0.123456, 0.97, 1.0 - 1e-6, 3e-9, 1e-12, 1.0 - 1e-12 };
+        for( double x : u ){
+            TS_ASSERT_DELTA( table.quantile( x ),
+                    gsl_cdf_ugaussian_Pinv( pow( x, 0.25 ) ), 1e-7 );
+        }
+
+        // same random number use as LocalRng::max_multi_log_normal
+        LocalRng rng1(0, 721347520444481703), rng2(0, 721347520444481703);
+        for( int i = 0; i < 100; ++i ){
+            TS_ASSERT_DELTA( table.max_multi_log_normal( rng1, 1.0, 2.0, 0.8 ),
+                    rng2.max_multi_log_normal( 1.0, 4, 2.0, 0.8 ), 1e-5 );
+        }
+    }
+};
+
+#endif
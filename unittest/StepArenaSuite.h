@@ -0,0 +1,77 @@
+/*
+ This file is part of OpenMalaria.
+
+ Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+
+ OpenMalaria is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or (at
+ your option) any later version.
+
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#ifndef Hmod_StepArenaSuite
+#define Hmod_StepArenaSuite
+
+#include <cxxtest/TestSuite.h>
+#include "util/StepArena.h"
+#include <map>
+#include <vector>
+
+using namespace OM::util;
+
+class StepArenaSuite : public CxxTest::TestSuite
+{
+public:
+    // Temporaries of the kind a time step creates, including more than fits
+    // in the arena's initial buffer
+    static double step() {
+        std::pmr::vector<double> values( StepArena::resource() );
+        for( int i = 0; i < 2000; ++i ) values.push_back( i );
+        std::pmr::map<int,double> nodes( StepArena::resource() );
+        for( int i = 0; i < 100; ++i ) nodes[i] = values[i * 20];
+        return nodes[99];
+    }
+
+    void testSteadyState() {
+        // the arena grows during the first steps...
+        for( int i = 0; i < 3; ++i ){
+            StepArena::nextStep();
+            TS_ASSERT_EQUALS( step(), 1980.0 );
+        }
+        // ...after which steps make no system allocations
+        uint64_t before = StepArena::systemAllocations();
+        for( int i = 0; i < 100; ++i ){
+            StepArena::nextStep();
+            TS_ASSERT_EQUALS( step(), 1980.0 );
+        }
+        TS_ASSERT_EQUALS( StepArena::systemAllocations(), before );
+    }
+
+    // Many iterations within one step (as in fast fitting) do not make the
+    // arena grow when each is ended with nextThreadStep()
+    void testThreadStep() {
+        StepArena::nextStep();
+        for( int i = 0; i < 3; ++i ){
+            TS_ASSERT_EQUALS( step(), 1980.0 );
+            StepArena::nextThreadStep();
+        }
+        uint64_t before = StepArena::systemAllocations();
+        for( int i = 0; i < 100; ++i ){
+            TS_ASSERT_EQUALS( step(), 1980.0 );
+            StepArena::nextThreadStep();
+        }
+        TS_ASSERT_EQUALS( StepArena::systemAllocations(), before );
+    }
+};
+
+#endif
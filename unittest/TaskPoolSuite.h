@@ -0,0 +1,109 @@
+/*
+ This file is part of OpenMalaria.
+ 
+ Copyright (C) 2005-2014 Swiss Tropical and Public Health Institute
+ Copyright (C) 2005-2014 Liverpool School Of Tropical Medicine
+ 
+ OpenMalaria is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or (at
+ your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+
+#ifndef Hmod_TaskPoolSuite
+#define Hmod_TaskPoolSuite
+
+#include <cxxtest/TestSuite.h>
+#include "ExtraAsserts.h"
+
+#include "util/TaskPool.h"
+
+#include <stdexcept>
+#include <vector>
+#include <cmath>
+
+using namespace OM::util;
+
+class TaskPoolSuite : public CxxTest::TestSuite
+{
+public:
+    void tearDown() {
+        TaskPool::init( 1 );
+    }
+    
+    // Results combined in index order must not depend on the thread count
+    void testDeterministic() {
+        const size_t N = 257;
+        std::vector<double> serial( N ), parallel( N );
+        auto fill = [N]( std::vector<double>& out ){
+            TaskPool::forEach( N, [&out]( size_t i ){
+                double x = 0.0;
+                for( size_t j = 0; j < 1000; ++j )
+                    x += std::sin( i * 0.1 + j * 0.01 );
+                out[i] = x;
+            } );
+        };
+        TaskPool::init( 1 );
+        TS_ASSERT_EQUALS( TaskPool::threads(), 1u );
+        fill( serial );
+        TaskPool::init( 4 );
+        TS_ASSERT_EQUALS( TaskPool::threads(), 4u );
+        for( int rep = 0; rep < 50; ++rep ){
+            fill( parallel );
+            TS_ASSERT_EQUALS( serial, parallel );
+        }
+    }
+    
+    // Jobs which the calling thread finishes before workers wake must not
+    // leave workers running tasks of an ended job
+    void testBackToBack() {
+        TaskPool::init( 4 );
+        for( size_t n = 1; n <= 3; ++n ){
+            for( int rep = 0; rep < 2000; ++rep ){
+                std::vector<int> counts( n, 0 );
+                TaskPool::forEach( n, [&counts]( size_t i ){
+                    counts[i] += 1;
+                } );
+                for( int c : counts )
+                    TS_ASSERT_EQUALS( c, 1 );
+            }
+        }
+    }
+    
+    void testNested() {
+        TaskPool::init( 3 );
+        std::vector<int> counts( 5 * 4, 0 );
+        TaskPool::forEach( 5, [&counts]( size_t i ){
+            TaskPool::forEach( 4, [&counts, i]( size_t j ){
+                counts[i * 4 + j] += 1;
+            } );
+        } );
+        for( int c : counts )
+            TS_ASSERT_EQUALS( c, 1 );
+    }
+    
+    void testException() {
+        TaskPool::init( 4 );
+        try{
+            TaskPool::forEach( 20, []( size_t i ){
+                if( i == 7 || i == 13 )
+                    throw std::runtime_error( i == 7 ? "seven" : "thirteen" );
+            } );
+            TS_FAIL( "expected exception" );
+        }catch( const std::runtime_error& e ){
+            TS_ASSERT_EQUALS( std::string( e.what() ), "seven" );
+        }
+    }
+};
+
+#endif
@@ -26,8 +26,10 @@
 
 #include "Global.h"
 #include "util/ModelOptions.h"
+#include "util/AgeGroupInterpolation.h"
 
 #include "Clinical/ClinicalModel.h"
+#include "Clinical/Episode.h"
 #include "Host/Human.h"
 #include "PkPd/LSTMModel.h"
 #include "PkPd/Drug/LSTMDrugType.h"
@@ -35,8 +37,11 @@
 #include "WithinHost/WHInterface.h"
 #include "WithinHost/Infection/Infection.h"
 #include "WithinHost/WHFalciparum.h"
+#include "WithinHost/CommonWithinHost.h"
 #include "WithinHost/Infection/MolineauxInfection.h"
 #include "WithinHost/Genotypes.h"
+#include "Transmission/VectorModel.h"
+#include "interventions/InterventionManager.hpp"
 #include "mon/management.h"
 
 #include "schema/scenario.h"
@@ -49,6 +54,8 @@ using ::OM::util::ModelOptions;
 namespace OM {
     namespace WithinHost {
         extern bool opt_common_whm;
+        extern double hetMassMultStdDev, minHetMassMult;
+        extern util::AgeGroupInterpolator massByAge;
     }
 }
 
@@ -265,16 +272,16 @@ public:
         sim::init( dummyXML::scenario );
         
         // we could just use zero, but we may spot more errors by using some weird number
-        sim::s_t0 = SimTime::fromYearsN(83.2591);
-        sim::s_t1 = sim::s_t0;
+        sim::s_state->t0 = SimTime::fromYearsN(83.2591);
+        sim::s_state->t1 = sim::s_state->t0;
 #ifndef NDEBUG
-        sim::in_update = true;  // may not always be correct but we're more interested in getting around this check than using it in unit tests
+        sim::s_state->in_update = true;  // may not always be correct but we're more interested in getting around this check than using it in unit tests
 #endif
     }
     static void incrTime(SimTime incr){
-        //NOTE: for unit tests, we do not differentiate between s_t0 and s_t1
-        sim::s_t0 += incr;
-        sim::s_t1 = sim::s_t0;
+        //NOTE: for unit tests, we do not differentiate between t0 and t1
+        sim::s_state->t0 += incr;
+        sim::s_state->t1 = sim::s_state->t0;
     }
     
     static const scnXml::Parameters& prepareParameters(){
@@ -450,6 +457,22 @@ public:
         WithinHost::MolineauxInfection::init(params);
     }
     
+    // Parameters CommonWithinHost::init would read from the scenario: a body
+    // mass of 50kg at all ages without heterogeneity, and the y_lag length
+    static void CommonWithinHost_setup () {
+        scnXml::AgeGroupValues weight;
+        weight.getGroup().push_back( scnXml::Group( 0.0, 0.0 ) );
+        weight.getGroup()[0].setLowerbound( 0.0 );
+        weight.getGroup()[0].setValue( 50.0 );
+        WithinHost::massByAge.set( weight, "weight" );
+        WithinHost::hetMassMultStdDev = 0.0;
+        WithinHost::minHetMassMult = 0.0;
+        CommonWithinHost::y_lag_len = SimTime::fromDays(20).inSteps() + 1;
+    }
+    static void CommonWithinHost_setSkipQuietDays( bool skip ){
+        CommonWithinHost::skipQuietDays = skip;
+    }
+    
     static void MosqLifeCycle_init() {
         ModelOptions::reset();
         ModelOptions::set(util::VECTOR_LIFE_CYCLE_MODEL);
@@ -480,6 +503,222 @@ public:
         human.withinHostModel = move(wh);
         return &*human.withinHostModel;
     }
+    
+    // Report an episode through Clinical::Episode (i.e. buffered), as if it
+    // started in survey `survey` at age `age`.
+    static void reportEpisode(size_t survey, SimTime age, uint32_t cohortSet,
+                              Clinical::Episode::State state){
+        Clinical::Episode episode;
+        episode.time = sim::ts0();
+        episode.surveyPeriod = survey;
+        episode.ageGroup.update(age);
+        episode.cohortSet = cohortSet;
+        episode.state = state;
+        episode.flush();
+    }
+    
+    // Register a human intervention component of class C, constructed from
+    // its id and args, as InterventionManager::init would. Returns it.
+    template<class C, class... Args>
+    static const C& addHumanComponent(Args... args){
+        auto& components = interventions::InterventionManager::s_state->humanComponents;
+        C* component = new C(interventions::ComponentId(components.size()), args...);
+        components.push_back(unique_ptr<interventions::HumanInterventionComponent>(component));
+        return *component;
+    }
+    static void clearHumanComponents(){
+        interventions::InterventionManager::s_state->humanComponents.clear();
+    }
+    
+    // Advance species s of the vector model over the time step from sim::ts0()
+    // using the sums over hosts saved by the last vectorUpdate(), as
+    // vectorUpdate() does but always in dynamic mode. sigma_dif is working space.
+    static void advanceVectorSpecies(Transmission::VectorModel& model, size_t s,
+                                     vector<double>& sigma_dif){
+        SimTime i = mod_nn(sim::ts0(), model.saved_sum_avail.size1());
+        auto range = model.saved_sigma_dif.range_at12(i, s);
+        sigma_dif.assign(range.first, range.second);
+        model.species[s]->advancePeriod(model.saved_sum_avail.at(i, s),
+                model.saved_sigma_df.at(i, s), sigma_dif,
+                model.saved_sigma_dff.at(i, s), true);
+    }
+    
+    // Use n genotypes in models sized by Genotypes::N(). Genotype details
+    // (e.g. initial frequencies) are not set; Genotypes::initSingle() restores
+    // a consistent state.
+    static void setNumGenotypes(size_t n){
+        WithinHost::Genotypes::N_genotypes = n;
+    }
+    
+    // Set up an AnophelesModel as initialise() and init2() would, with
+    // resting duration tau and EIP duration theta_s, constant emergence and
+    // random state on each of the previous N_v_length days.
+    static void AnophelesModel_init(Transmission::Anopheles::AnophelesModel& m,
+            SimTime tau, SimTime theta_s, LocalRng& rng){
+        const size_t nGenotypes = WithinHost::Genotypes::N();
+        m.mosqRestDuration = tau;
+        m.EIPDuration = theta_s;
+        m.N_v_length = theta_s + tau;
+        m.minInfectedThreshold = 0.001;
+        m.fArray.resize(theta_s - tau + SimTime::oneDay());
+        m.fArray[SimTime::zero()] = 1.0;
+        m.ftauArray.assign(theta_s, 0.0);
+        m.ftauArray[tau] = 1.0;
+        m.uninfected_v.resize(m.N_v_length);
+        m.mosqEmergeRate.assign(SimTime::oneYear(), 1000.0);
+        
+        const SimTime len = m.N_v_length;
+        m.N_v.assign(len, 0.0);
+        m.O_v.assign(len, nGenotypes, 0.0);
+        m.S_v.assign(len, nGenotypes, 0.0);
+        m.P_A.assign(len, 0.0);
+        m.P_df.assign(len, 0.0);
+        m.P_dif.assign(len, nGenotypes, 0.0);
+        m.P_dff.assign(len, 0.0);
+        m.P_Amu.assign(len, 0.0);
+        m.P_A1.assign(len, 0.0);
+        m.P_Ah.assign(len, 0.0);
+        for( SimTime t = SimTime::zero(); t < len; t += SimTime::oneDay() ){
+            m.P_A[t] = 0.6 + 0.1 * rng.uniform_01();
+            m.P_df[t] = 0.05 + 0.05 * rng.uniform_01();
+            m.P_dff[t] = m.P_df[t];
+            m.N_v[t] = 10000.0 * (1.0 + rng.uniform_01());
+            for( size_t g = 0; g < nGenotypes; ++g ){
+                m.P_dif.at(t, g) = 0.01 * m.P_df[t] * rng.uniform_01();
+                m.O_v.at(t, g) = 0.1 * m.N_v[t] * rng.uniform_01() / nGenotypes;
+                m.S_v.at(t, g) = 0.5 * m.O_v.at(t, g) * rng.uniform_01();
+            }
+        }
+        m.calcUninfected_v();
+        m.nDaysP_AStable = SimTime::zero();
+    }
+    
+    // Update m by one day as AnophelesModel::update() does (with isDynamic),
+    // but recalculating fArray, ftauArray and the number of uninfected
+    // mosquitoes on each previous day in full, as the model did before these
+    // were updated incrementally. Does not update m.uninfected_v.
+    static void AnophelesModel_updateDirect(Transmission::Anopheles::AnophelesModel& m,
+            SimTime d0, double tsP_A, double tsP_df, const vector<double>& tsP_dif,
+            double tsP_dff, vector<double>& partialEIR){
+        const size_t nGenotypes = WithinHost::Genotypes::N();
+        const SimTime tau = m.mosqRestDuration, theta_s = m.EIPDuration;
+        const SimTime len = m.N_v_length, one = SimTime::oneDay();
+        const SimTime d1 = d0 + one;
+        const SimTime d1Mod = d1 + len;
+        const SimTime t1 = mod_nn(d1, len), t0 = mod_nn(d0, len);
+        const SimTime ttau = mod_nn(d1Mod - tau, len);
+        
+        m.P_A[t1] = tsP_A;
+        m.P_df[t1] = tsP_df;
+        m.P_dff[t1] = tsP_dff;
+        for( size_t g = 0; g < nGenotypes; ++g ) m.P_dif.at(t1, g) = tsP_dif[g];
+        
+        // NDEMD eq. 1.6
+        for( SimTime n = one; n <= tau; n += one )
+            m.fArray[n] = m.fArray[n - one] * m.P_A[mod_nn(d1Mod - n, len)];
+        m.fArray[tau] += m.P_df[ttau];
+        for( SimTime n = tau + one; n <= theta_s - tau; n += one ){
+            const SimTime tn = mod_nn(d1Mod - n, len);
+            m.fArray[n] = m.P_df[tn] * m.fArray[n - tau] + m.P_A[tn] * m.fArray[n - one];
+        }
+        // NDEMD eq. 1.7
+        for( SimTime n = tau + one; n <= tau * 2; n += one )
+            m.ftauArray[n] = m.ftauArray[n - one] * m.P_A[mod_nn(d1Mod - n, len)];
+        m.ftauArray[tau * 2] += m.P_df[mod_nn(d1Mod - tau * 2, len)];
+        for( SimTime n = tau * 2 + one; n < theta_s; n += one ){
+            const SimTime tn = mod_nn(d1Mod - n, len);
+            m.ftauArray[n] = m.P_df[tn] * m.ftauArray[n - tau] + m.P_A[tn] * m.ftauArray[n - one];
+        }
+        // uninfected[d]: uninfected mosquitoes d days before the end of the day
+        util::vecDay<double> uninfected(len, 0.0);
+        for( SimTime d = one; d < len; d += one ){
+            const SimTime t = mod_nn(d1Mod - d, len);
+            double sum = m.N_v[t];
+            for( size_t g = 0; g < nGenotypes; ++g ) sum -= m.O_v.at(t, g);
+            uninfected[d] = sum;
+        }
+        
+        for( size_t g = 0; g < nGenotypes; ++g ){
+            m.O_v.at(t1, g) = m.P_dif.at(ttau, g) * uninfected[tau]
+                + m.P_A[t0] * m.O_v.at(t0, g) + m.P_df[ttau] * m.O_v.at(ttau, g);
+            double sum = 0.0;
+            const SimTime ts = d1Mod - theta_s;
+            for( SimTime l = one; l < tau; l += one ){
+                const SimTime tsl = mod_nn(ts - l, len);
+                sum += m.P_dif.at(tsl, g) * m.P_df[ttau] * uninfected[theta_s + l] *
+                    m.ftauArray[theta_s + l - tau];
+            }
+            const SimTime tsm = mod_nn(ts, len);
+            double& S_v = m.S_v.at(t1, g);
+            S_v = m.P_dif.at(tsm, g) * m.fArray[theta_s - tau] * uninfected[theta_s]
+                + sum + m.P_A[t0] * m.S_v.at(t0, g) + m.P_df[ttau] * m.S_v.at(ttau, g);
+            if( S_v <= m.minInfectedThreshold ) S_v = 0.0;
+            partialEIR[g] += S_v;
+        }
+        
+        const double nOvipositing = m.P_dff[ttau] * m.N_v[ttau];
+        m.N_v[t1] = m.getEmergenceRate(d0, m.mosqEmergeRate, nOvipositing) * m.interventionSurvival
+            + m.P_A[t0] * m.N_v[t0] + nOvipositing;
+    }
+    
+    static const util::vecDay<double>& AnophelesModel_N_v(const Transmission::Anopheles::AnophelesModel& m){
+        return m.N_v;
+    }
+    static const util::vecDay2D<double>& AnophelesModel_O_v(const Transmission::Anopheles::AnophelesModel& m){
+        return m.O_v;
+    }
+    static const util::vecDay2D<double>& AnophelesModel_S_v(const Transmission::Anopheles::AnophelesModel& m){
+        return m.S_v;
+    }
+    static const util::vecDay<double>& AnophelesModel_uninfected_v(const Transmission::Anopheles::AnophelesModel& m){
+        return m.uninfected_v;
+    }
+    static const util::vecDay<double>& AnophelesModel_mosqEmergeRate(const Transmission::Anopheles::AnophelesModel& m){
+        return m.mosqEmergeRate;
+    }
+    
+    // Set up m as AnophelesModel::initialise() and init2() would for
+    // gambiae_ss of test/scenarioNoInterv.xml, without non-human hosts, and
+    // nHumans humans of mean availability 1. Outputs the humans' sum_avail
+    // and sigma_df (equal to sigma_dff) as passed to advancePeriod().
+    static void AnophelesModel_initFit(Transmission::Anopheles::AnophelesModel& m,
+            int nHumans, double& sum_avail, double& sigma_df){
+        const double A0 = 0.313, Pf = 0.623;
+        const double P_B = 0.95, P_C = 0.95, P_D = 0.99, P_E = 0.88;
+        m.mosqSeekingDuration = 0.33;
+        m.probMosqSurvivalOvipositing = P_E;
+        m.mosqRestDuration = SimTime::fromDays(3);
+        m.EIPDuration = SimTime::fromDays(11);
+        m.N_v_length = m.EIPDuration + m.mosqRestDuration;
+        m.minInfectedThreshold = 0.001;
+        m.fArray.resize(m.EIPDuration - m.mosqRestDuration + SimTime::oneDay());
+        m.fArray[SimTime::zero()] = 1.0;
+        m.ftauArray.assign(m.EIPDuration, 0.0);
+        m.ftauArray[m.mosqRestDuration] = 1.0;
+        m.uninfected_v.resize(m.N_v_length);
+        
+        // as initAvailability(), with χ = 1
+        const double initP_A = 1.0 - A0;
+        const double availFactor = -log(initP_A) / (m.mosqSeekingDuration * (1.0 - initP_A));
+        const double P_A1 = A0 * Pf / (P_B * P_C * P_D * P_E);
+        m.nhh_avail = m.nhh_sigma_df = m.nhh_sigma_dff = 0.0;
+        m.mosqSeekingDeathRate = (1.0 - (initP_A + P_A1)) / (1.0 - initP_A)
+            * -log(initP_A) / m.mosqSeekingDuration;
+        
+        // as initEIR()
+        m.FSCoeffic = { 0.0, -0.2072, 0.8461, 0.0906, -0.0425 };
+        m.EIRRotateAngle = 0.0;
+        util::vecDay<double> speciesEIR(SimTime::oneYear());
+        util::vectors::expIDFT(speciesEIR, m.FSCoeffic, m.EIRRotateAngle);
+        m.FSCoeffic[0] += log(24.826144381650714 / util::vectors::sum(speciesEIR));
+        m.FSRotateAngle = m.EIRRotateAngle - (m.EIPDuration.inDays()+10)/365.*2.*M_PI;
+        m.initNvFromSv = 1.0 / 0.021;
+        m.initOvFromSv = m.initNvFromSv * 0.078;
+        
+        sum_avail = P_A1 * availFactor;
+        sigma_df = sum_avail * P_B * P_C * P_D;
+        m.init2(nHumans, 1.0, sum_avail, sum_avail * P_B, sigma_df, sigma_df);
+    }
 };
 
 #endif
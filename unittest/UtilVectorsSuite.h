@@ -27,6 +27,9 @@
 
 #include "util/vectors.h"
 #include "util/vecDay.h"
+#include "util/SmallVector.h"
+#include "util/checkpoint_containers.h"
+#include <sstream>
 
 using namespace OM::util;
 using OM::sim;
@@ -49,6 +52,63 @@ public:
         for( size_t i=0; i<result.internal().size(); ++i )
             TS_ASSERT_APPROX( input[i], result[SimTime::fromDays(i)] );
     }
+
+    void testRotate() {
+        vecDay<double> vec( SimTime::fromDays(5) );
+        vecDay2D<double> vec2( SimTime::fromDays(5), 2, 0.0 );
+        for( size_t i = 0; i < 5; ++i ){
+            vec[SimTime::fromDays(i)] = i;
+            vec2.at(SimTime::fromDays(i), 0) = i;
+            vec2.at(SimTime::fromDays(i), 1) = 10 + i;
+        }
+        // rotating by more than the length wraps around: 7 = 2 mod 5
+        vectors::rotate( vec, SimTime::fromDays(7) );
+        vectors::rotate( vec2, SimTime::fromDays(2) );
+        for( size_t i = 0; i < 5; ++i ){
+            TS_ASSERT_EQUALS( vec[SimTime::fromDays(i)], double((i + 2) % 5) );
+            TS_ASSERT_EQUALS( vec2.at(SimTime::fromDays(i), 0), double((i + 2) % 5) );
+            TS_ASSERT_EQUALS( vec2.at(SimTime::fromDays(i), 1), double(10 + (i + 2) % 5) );
+        }
+    }
+    
+    void testSmallVector() {
+        SmallVector<SimTime, 4> v;
+        for( int i = 0; i < 4; ++i ) v.push_back( SimTime::fromDays(i) );
+        TS_ASSERT( v.isInline() );
+        v.push_back( SimTime::fromDays(4) );
+        TS_ASSERT( !v.isInline() );
+        TS_ASSERT_EQUALS( v.size(), 5u );
+        
+        // moving takes the allocated storage; the source is left empty
+        SmallVector<SimTime, 4> w( std::move(v) );
+        TS_ASSERT( v.empty() && v.isInline() );
+        TS_ASSERT_EQUALS( w.back(), SimTime::fromDays(4) );
+        w.pop_back();
+        
+        // checkpoints use the format of std::vector
+        using namespace OM::util::checkpoint;
+        std::ostringstream out;
+        w & out;
+        std::istringstream in( out.str() );
+        vector<SimTime> r;
+        r & in;
+        TS_ASSERT_EQUALS( r.size(), 4u );
+        TS_ASSERT_EQUALS( r[3], SimTime::fromDays(3) );
+    }
+    
+    void testVector2DClear() {
+        vector2D<double> v( 3, 2, 1.0 );
+        TS_ASSERT( !v.empty() );
+        TS_ASSERT_EQUALS( v.size_all(), 6u );
+        v.clear();
+        TS_ASSERT( v.empty() );
+        TS_ASSERT_EQUALS( v.internal_vec().capacity(), 0u );
+        // stride is kept, so the vector can be re-allocated by row count
+        v.resize( 4, 2 );
+        TS_ASSERT_EQUALS( v.size_all(), 8u );
+        v.at(3, 1) = 5.0;
+        TS_ASSERT_EQUALS( v.range_at1(3).second - v.range_at1(3).first, 2 );
+    }
 };
 
 #endif
@@ -39,6 +39,9 @@ double WHMock::probTransmissionToMosquito( double, double* ) const{
 double WHMock::pTransGenotype( double, double, size_t ){
     throw util::unimplemented_exception( "not needed in unit test" );
 }
+void WHMock::pTransGenotypes( double, double, vector<pair<uint32_t,double>>& ){
+    throw util::unimplemented_exception( "not needed in unit test" );
+}
 
 bool WHMock::summarize(Host::Human& human)const{
     throw util::unimplemented_exception( "not needed in unit test" );
@@ -64,7 +67,7 @@ void WHMock::treatPkPd(size_t schedule, size_t dosages, double age, double delay
     pkpd.prescribe( schedule, dosages, age, numeric_limits<double>::quiet_NaN(), delay_d );
 }
 
-void WHMock::update(LocalRng& rng, int nNewInfs, vector<double>&, double ageInYears, double bsvFactor){
+void WHMock::update(LocalRng& rng, int nNewInfs, GenotypeWeights&, double ageInYears, double bsvFactor){
     throw util::unimplemented_exception( "not needed in unit test" );
 }
 
@@ -95,6 +98,10 @@ double WHMock::getCumulative_h() const{
 double WHMock::getCumulative_Y() const{
     throw util::unimplemented_exception( "not needed in unit test" );
 }
+void WHMock::memoryUsage( util::MemoryUsage& usage ) const{
+    usage.withinHost += sizeof(*this);
+    usage.pkpd += pkpd.memoryUsage() - sizeof(pkpd);
+}
 
 void WHMock::checkpoint (istream& stream){
     throw util::unimplemented_exception( "not needed in unit test" );
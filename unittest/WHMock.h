@@ -47,19 +47,22 @@ public:
     
     virtual double probTransmissionToMosquito( double tbvFactor, double *sumX ) const;
     virtual double pTransGenotype( double pTrans, double sumX, size_t genotype );
+    virtual void pTransGenotypes( double pTrans, double sumX,
+            vector<pair<uint32_t,double>>& probs );
     virtual bool summarize(Host::Human& human)const;
     virtual void importInfection(LocalRng& rng);
     virtual void treatment( Host::Human& human, TreatmentId treatId );
     virtual void optionalPqTreatment( Host::Human& human );
     virtual bool treatSimple( Host::Human& human, SimTime timeLiver, SimTime timeBlood );
     virtual void treatPkPd(size_t schedule, size_t dosages, double age, double delay_d);
-    virtual void update(LocalRng& rng, int nNewInfs, vector<double>& genotype_weights,double ageInYears, double bsvFactor);
+    virtual void update(LocalRng& rng, int nNewInfs, GenotypeWeights& genotype_weights,double ageInYears, double bsvFactor);
     virtual double getTotalDensity() const;
     virtual bool diagnosticResult( LocalRng& rng, const Diagnostic& diagnostic ) const;
     virtual Pathogenesis::StatePair determineMorbidity( Host::Human& human, double ageYears, bool isDoomed );
     virtual void clearImmunity();
     virtual double getCumulative_h() const;
     virtual double getCumulative_Y() const;
+    virtual void memoryUsage( util::MemoryUsage& usage ) const;
 
     // This mock class does not have actual infections. Just set this as you please.
     double totalDensity;
@@ -23,6 +23,7 @@
 
 #include <cxxtest/TestSuite.h>
 #include "util/xoshiro.hpp"
+#include "util/random.h"
 
 class XoshiroSuite : public CxxTest::TestSuite
 {
@@ -51,6 +52,19 @@ public:
             TS_ASSERT_EQUALS(x, vector[n]);
         }
     }
+    
+    void testRngSeed () {
+        // Seeding via RngSeed must give the same generators as seeding directly
+        OM::util::MasterRng master1(7, 0), master2(7, 0);
+        for (int h = 0; h < 3; h++) {
+            OM::util::LocalRng direct(master1);
+            OM::util::LocalRng seeded(master2.gen_rng_seed());
+            for (int n = 0; n < 10; n++) {
+                TS_ASSERT_EQUALS(direct.uniform_01(), seeded.uniform_01());
+            }
+        }
+        TS_ASSERT_EQUALS(master1.gen_seed(), master2.gen_seed());
+    }
 };
 
 #endif
@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+# This file is part of OpenMalaria.
+#
+# Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+# Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+#
+# OpenMalaria is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2 of the License, or (at
+# your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+
+# Compare the time taken to run a scenario repeatedly with the openMalaria
+# executable and with libopenmalaria (configure with -DOM_BUILD_LIBRARY=ON).
+# Both are run in a temporary directory holding a copy of the schema file.
+# Results of the two methods are checked to be identical.
+#
+# Example (from the build dir):
+#   ../util/benchmarkLibrary.py -n 20 ../test/scenario5.xml
+
+import sys
+import os
+import re
+import time
+import ctypes
+import shutil
+import tempfile
+import subprocess
+from optparse import OptionParser
+
+def findSchema(scenario, schemaDirs):
+    with open(scenario, 'r') as f:
+        m = re.search(r'(scenario_\d+\.xsd)', f.read())
+    if m is None:
+        raise RuntimeError("no schema location found in " + scenario)
+    for d in schemaDirs:
+        path = os.path.join(d, m.group(1))
+        if os.path.isfile(path):
+            return path
+    raise RuntimeError("can't find " + m.group(1))
+
+def readOutput(path):
+    results = []
+    with open(path, 'r') as f:
+        for line in f:
+            items = line.split()
+            if items:
+                results.append((int(items[0]), int(items[1]), int(items[2]), float(items[3])))
+    return results
+
+def runCli(openMalaria, scenario, n):
+    results = None
+    start = time.time()
+    for i in range(n):
+        ret = subprocess.call([openMalaria, "--scenario", scenario, "--output", "output.txt"],
+                stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+        if ret != 0:
+            raise RuntimeError("openMalaria exited with status " + str(ret))
+        results = readOutput("output.txt")
+    return time.time() - start, results
+
+def runLibrary(library, scenario, n):
+    lib = ctypes.CDLL(library)
+    lib.om_scenario_load.restype = ctypes.c_void_p
+    lib.om_scenario_load.argtypes = [ctypes.c_char_p, ctypes.c_size_t]
+    lib.om_scenario_free.argtypes = [ctypes.c_void_p]
+    lib.om_scenario_run.argtypes = [ctypes.c_void_p]
+    lib.om_results_size.restype = ctypes.c_size_t
+    lib.om_results_size.argtypes = [ctypes.c_void_p]
+    for name in ["om_results_survey", "om_results_group", "om_results_measure"]:
+        getattr(lib, name).restype = ctypes.POINTER(ctypes.c_int)
+        getattr(lib, name).argtypes = [ctypes.c_void_p]
+    lib.om_results_value.restype = ctypes.POINTER(ctypes.c_double)
+    lib.om_results_value.argtypes = [ctypes.c_void_p]
+    lib.om_last_error.restype = ctypes.c_char_p
+
+    start = time.time()
+    with open(scenario, 'rb') as f:
+        xml = f.read()
+    scn = lib.om_scenario_load(xml, len(xml))
+    if not scn:
+        raise RuntimeError(lib.om_last_error().decode())
+    try:
+        for i in range(n):
+            if lib.om_scenario_run(scn) != 0:
+                raise RuntimeError(lib.om_last_error().decode())
+        elapsed = time.time() - start
+        size = lib.om_results_size(scn)
+        survey = lib.om_results_survey(scn)
+        group = lib.om_results_group(scn)
+        measure = lib.om_results_measure(scn)
+        value = lib.om_results_value(scn)
+        results = [(survey[i], group[i], measure[i], value[i]) for i in range(size)]
+    finally:
+        lib.om_scenario_free(scn)
+    return elapsed, results
+
+def main(args):
+    parser = OptionParser(usage="Usage: %prog [options] SCENARIO.xml")
+    parser.add_option("-n", "--runs", type="int", default=10,
+            help="Number of runs with each method (default: %default)")
+    parser.add_option("-e", "--executable", default="./openMalaria",
+            help="Path to the openMalaria executable (default: %default)")
+    parser.add_option("-l", "--library", default="./libopenmalaria.so",
+            help="Path to the shared library (default: %default)")
+    parser.add_option("-s", "--schema-dir", action="append", default=[],
+            help="Directory containing scenario_NN.xsd (may be repeated; default: schema dirs relative to the script and working directory)")
+    (options, others) = parser.parse_args(args=args)
+    if len(others) != 1:
+        parser.print_usage()
+        return 1
+
+    scenario = os.path.abspath(others[0])
+    openMalaria = os.path.abspath(options.executable)
+    library = os.path.abspath(options.library)
+    schemaDirs = options.schema_dir + [
+        os.path.join(os.path.dirname(os.path.abspath(__file__)), "../schema"), "schema"]
+    schema = findSchema(scenario, schemaDirs)
+
+    simDir = tempfile.mkdtemp(prefix="benchmarkLibrary-")
+    cwd = os.getcwd()
+    try:
+        shutil.copy2(schema, simDir)
+        os.chdir(simDir)
+        cliTime, cliResults = runCli(openMalaria, scenario, options.runs)
+        libTime, libResults = runLibrary(library, scenario, options.runs)
+    finally:
+        os.chdir(cwd)
+        shutil.rmtree(simDir)
+
+    print("runs: %d" % options.runs)
+    print("executable: %.3fs total, %.3fs per run" % (cliTime, cliTime / options.runs))
+    print("library:    %.3fs total, %.3fs per run" % (libTime, libTime / options.runs))
+    if libTime > 0:
+        print("speed-up:   %.2f" % (cliTime / libTime))
+    # output.txt uses default stream precision; compare at that precision
+    same = len(cliResults) == len(libResults) and all(
+            a[:3] == b[:3] and float("%g" % a[3]) == float("%g" % b[3])
+            for a, b in zip(cliResults, libResults))
+    print("results identical: " + ("yes" if same else "NO"))
+    return 0 if same else 1
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+# This file is part of OpenMalaria.
+#
+# Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+# Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+#
+# OpenMalaria is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2 of the License, or (at
+# your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+
+# Compare two result files of test/bench/bench.py (e.g. from builds of two
+# commits) and report changes in throughput, peak memory and time per part of
+# the time step. Exits with status 1 if any benchmark is slower, or uses more
+# memory, than allowed by the threshold.
+#
+# Example:
+#   util/compareBench.py old/bench.json new/bench.json
+
+import sys
+import json
+from optparse import OptionParser
+
+def load(path):
+    with open(path, 'r') as f:
+        report = json.load(f)
+    return report, dict((r["name"], r) for r in report["results"])
+
+def change(old, new):
+    if old is None or new is None or old == 0:
+        return None
+    return (new - old) / old
+
+def fmtChange(c):
+    return "     n/a" if c is None else "%+7.1f%%" % (100.0 * c)
+
+def main(args):
+    parser = OptionParser(usage="Usage: %prog [options] OLD.json NEW.json")
+    parser.add_option("-t", "--threshold", type="float", default=5.0,
+            help="Relative change (percent) of throughput or peak memory reported as a regression (default: %default)")
+    parser.add_option("-c", "--components", action="store_true", default=False,
+            help="Also show changes in time spent per part of the time step")
+    (options, others) = parser.parse_args(args=args)
+    if len(others) != 2:
+        parser.print_usage()
+        return 2
+
+    oldReport, old = load(others[0])
+    newReport, new = load(others[1])
+    print("old: %s (%s)" % (oldReport.get("commit"), oldReport.get("date")))
+    print("new: %s (%s)" % (newReport.get("commit"), newReport.get("date")))
+    if oldReport.get("host") != newReport.get("host"):
+        print("warning: results are from different hosts (%s, %s)" %
+                (oldReport.get("host"), newReport.get("host")))
+    for field in ["years", "threads"]:
+        if oldReport.get(field) != newReport.get(field):
+            print("warning: %s differs (%s, %s)" % (field, oldReport.get(field), newReport.get(field)))
+
+    threshold = options.threshold / 100.0
+    regressions = []
+    print("\n%-24s %14s %14s %8s %8s" % ("benchmark", "old h-steps/s", "new h-steps/s", "speed", "RSS"))
+    for name in [r["name"] for r in newReport["results"]]:
+        if name not in old:
+            print("%-24s (new benchmark)" % name)
+            continue
+        o, n = old[name], new[name]
+        speed = change(o["humanStepsPerSecond"], n["humanStepsPerSecond"])
+        rss = change(o["peakRSSMiB"], n["peakRSSMiB"])
+        flag = ""
+        if (speed is not None and speed < -threshold) or (rss is not None and rss > threshold):
+            regressions.append(name)
+            flag = "  <-- regression"
+        print("%-24s %14.0f %14.0f %s %s%s" % (name, o["humanStepsPerSecond"] or 0,
+                n["humanStepsPerSecond"] or 0, fmtChange(speed), fmtChange(rss), flag))
+        if options.components:
+            for c in sorted(set(o["components"]) | set(n["components"])):
+                print("    %-20s %13.3fs %13.3fs %s" % (c, o["components"].get(c, 0),
+                        n["components"].get(c, 0),
+                        fmtChange(change(o["components"].get(c), n["components"].get(c)))))
+    for name in old:
+        if name not in new:
+            print("%-24s (missing in new results)" % name)
+
+    if regressions:
+        print("\n%d regression(s) beyond %g%%: %s" % (len(regressions), options.threshold, ", ".join(regressions)))
+        return 1
+    print("\nno regressions beyond %g%%" % options.threshold)
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))